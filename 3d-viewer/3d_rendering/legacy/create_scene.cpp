@@ -26,6 +26,7 @@
 #include "ogl_legacy_utils.h"
 #include <board.h>
 #include <footprint.h>
+#include <geometry/poly_boolean_pipeline.h>
 #include "../../3d_math.h"
 #include <trigo.h>
 #include <project.h>
@@ -465,11 +466,12 @@ void RENDER_3D_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarningRepo
         m_antiBoard = createBoard( m_antiBoardPolys );
     }
 
-    SHAPE_POLY_SET board_poly_with_holes = m_boardAdapter.GetBoardPoly();
-    board_poly_with_holes.BooleanSubtract( m_boardAdapter.GetThroughHoleOdPolys(),
-                                           SHAPE_POLY_SET::PM_FAST );
-    board_poly_with_holes.BooleanSubtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly(),
-                                           SHAPE_POLY_SET::PM_FAST );
+    SHAPE_POLY_SET        board_poly_with_holes;
+    POLY_BOOLEAN_PIPELINE holes( m_boardAdapter.GetBoardPoly() );
+
+    holes.Subtract( m_boardAdapter.GetThroughHoleOdPolys() );
+    holes.Subtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly() );
+    holes.Commit( board_poly_with_holes );
 
     m_boardWithHoles = createBoard( board_poly_with_holes );
 
@@ -564,36 +566,32 @@ void RENDER_3D_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarningRepo
 
         if( map_poly.find( layer_id ) != map_poly.end() )
         {
-            polyListSubtracted = *map_poly.at( layer_id );;
-
             if( ( layer_id != B_Paste ) && ( layer_id != F_Paste ) &&
                 m_boardAdapter.GetFlag( FL_USE_REALISTIC_MODE ) )
             {
-                polyListSubtracted.BooleanIntersection( m_boardAdapter.GetBoardPoly(),
-                                                        SHAPE_POLY_SET::PM_FAST );
+                POLY_BOOLEAN_PIPELINE pipeline( *map_poly.at( layer_id ) );
+
+                pipeline.Intersect( m_boardAdapter.GetBoardPoly() );
 
                 if( ( layer_id != B_Mask ) && ( layer_id != F_Mask ) )
                 {
-                    polyListSubtracted.BooleanSubtract( m_boardAdapter.GetThroughHoleOdPolys(),
-                                                        SHAPE_POLY_SET::PM_FAST );
-                    polyListSubtracted.BooleanSubtract(
-                            m_boardAdapter.GetOuterNonPlatedThroughHolePoly(),
-                            SHAPE_POLY_SET::PM_FAST );
+                    pipeline.Subtract( m_boardAdapter.GetThroughHoleOdPolys() );
+                    pipeline.Subtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly() );
                 }
 
                 if( m_boardAdapter.GetFlag( FL_SUBTRACT_MASK_FROM_SILK ) )
                 {
                     if( layer_id == B_SilkS && map_poly.find( B_Mask ) != map_poly.end() )
-                    {
-                        polyListSubtracted.BooleanSubtract( *map_poly.at( B_Mask ),
-                                                            SHAPE_POLY_SET::PM_FAST );
-                    }
+                        pipeline.Subtract( *map_poly.at( B_Mask ) );
                     else if( layer_id == F_SilkS && map_poly.find( F_Mask ) != map_poly.end() )
-                    {
-                        polyListSubtracted.BooleanSubtract( *map_poly.at( F_Mask ),
-                                                            SHAPE_POLY_SET::PM_FAST );
-                    }
+                        pipeline.Subtract( *map_poly.at( F_Mask ) );
                 }
+
+                pipeline.Commit( polyListSubtracted );
+            }
+            else
+            {
+                polyListSubtracted = *map_poly.at( layer_id );
             }
 
             aPolyList = &polyListSubtracted;
@@ -612,13 +610,13 @@ void RENDER_3D_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarningRepo
     {
         if( m_boardAdapter.GetFrontPlatedPadPolys() )
         {
-            SHAPE_POLY_SET polySubtracted = *m_boardAdapter.GetFrontPlatedPadPolys();
-            polySubtracted.BooleanIntersection( m_boardAdapter.GetBoardPoly(),
-                                                SHAPE_POLY_SET::PM_FAST );
-            polySubtracted.BooleanSubtract( m_boardAdapter.GetThroughHoleOdPolys(),
-                                            SHAPE_POLY_SET::PM_FAST );
-            polySubtracted.BooleanSubtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly(),
-                                            SHAPE_POLY_SET::PM_FAST );
+            SHAPE_POLY_SET        polySubtracted;
+            POLY_BOOLEAN_PIPELINE pipeline( *m_boardAdapter.GetFrontPlatedPadPolys() );
+
+            pipeline.Intersect( m_boardAdapter.GetBoardPoly() );
+            pipeline.Subtract( m_boardAdapter.GetThroughHoleOdPolys() );
+            pipeline.Subtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly() );
+            pipeline.Commit( polySubtracted );
 
             m_platedPadsFront = generateLayerList( m_boardAdapter.GetPlatedPadsFront(),
                                                    &polySubtracted, F_Cu );
@@ -626,13 +624,13 @@ void RENDER_3D_LEGACY::reload( REPORTER* aStatusReporter, REPORTER* aWarningRepo
 
         if( m_boardAdapter.GetBackPlatedPadPolys() )
         {
-            SHAPE_POLY_SET polySubtracted = *m_boardAdapter.GetBackPlatedPadPolys();
-            polySubtracted.BooleanIntersection( m_boardAdapter.GetBoardPoly(),
-                                                SHAPE_POLY_SET::PM_FAST );
-            polySubtracted.BooleanSubtract( m_boardAdapter.GetThroughHoleOdPolys(),
-                                            SHAPE_POLY_SET::PM_FAST );
-            polySubtracted.BooleanSubtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly(),
-                                            SHAPE_POLY_SET::PM_FAST );
+            SHAPE_POLY_SET        polySubtracted;
+            POLY_BOOLEAN_PIPELINE pipeline( *m_boardAdapter.GetBackPlatedPadPolys() );
+
+            pipeline.Intersect( m_boardAdapter.GetBoardPoly() );
+            pipeline.Subtract( m_boardAdapter.GetThroughHoleOdPolys() );
+            pipeline.Subtract( m_boardAdapter.GetOuterNonPlatedThroughHolePoly() );
+            pipeline.Commit( polySubtracted );
 
             m_platedPadsBack = generateLayerList( m_boardAdapter.GetPlatedPadsBack(),
                                                   &polySubtracted, B_Cu );
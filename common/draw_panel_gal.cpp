@@ -263,6 +263,10 @@ void EDA_DRAW_PANEL_GAL::DoRePaint()
 
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
+
+    // Coarse geometry missing from this frame is cached by the next one
+    if( m_view->IsCoarseGeometryPending() )
+        Refresh();
 }
 
 
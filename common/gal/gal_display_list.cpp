@@ -0,0 +1,455 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/gal_display_list.h>
+
+using namespace KIGFX;
+
+
+bool GAL_DISPLAY_LIST::STATE::operator==( const STATE& aOther ) const
+{
+    return m_isFill == aOther.m_isFill && m_isStroke == aOther.m_isStroke
+           && m_fillColor == aOther.m_fillColor && m_strokeColor == aOther.m_strokeColor
+           && m_lineWidth == aOther.m_lineWidth && m_layerDepth == aOther.m_layerDepth;
+}
+
+
+GAL_DISPLAY_LIST::GAL_DISPLAY_LIST( GAL_DISPLAY_OPTIONS& aOptions, GAL* aTarget ) :
+        GAL( aOptions ),
+        m_isCairoEngine( aTarget->IsCairoEngine() ),
+        m_isOpenGlEngine( aTarget->IsOpenGlEngine() ),
+        m_stateValid( false )
+{
+    SetLookAtPoint( aTarget->GetLookAtPoint() );
+    SetZoomFactor( aTarget->GetZoomFactor() );
+    SetRotation( aTarget->GetRotation() );
+    SetDepthRange( VECTOR2D( aTarget->GetMinDepth(), aTarget->GetMaxDepth() ) );
+    SetFlip( aTarget->IsFlippedX(), aTarget->IsFlippedY() );
+
+    m_worldScreenMatrix = aTarget->GetWorldScreenMatrix();
+    m_screenWorldMatrix = aTarget->GetScreenWorldMatrix();
+    m_worldScale = aTarget->GetWorldScale();
+}
+
+
+GAL_DISPLAY_LIST::~GAL_DISPLAY_LIST()
+{
+}
+
+
+int GAL_DISPLAY_LIST::BeginRecording()
+{
+    m_drawings.push_back( { (int) m_commands.size(), (int) m_commands.size(), true } );
+    m_stateValid = false;
+
+    return m_drawings.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::EndRecording()
+{
+    m_drawings.back().m_last = m_commands.size();
+}
+
+
+void GAL_DISPLAY_LIST::Replay( int aDrawing, GAL* aTarget ) const
+{
+    const DRAWING& drawing = m_drawings[aDrawing];
+
+    wxCHECK( drawing.m_complete, /* void */ );
+
+    for( int i = drawing.m_first; i < drawing.m_last; ++i )
+        replayCommand( m_commands[i], aTarget );
+}
+
+
+void GAL_DISPLAY_LIST::Clear()
+{
+    m_commands.clear();
+    m_drawings.clear();
+    m_points.clear();
+    m_states.clear();
+    m_texts.clear();
+    m_matrices.clear();
+    m_lineChains.clear();
+    m_polySets.clear();
+    m_stateValid = false;
+}
+
+
+GAL_DISPLAY_LIST::COMMAND& GAL_DISPLAY_LIST::addCommand( COMMAND_TYPE aType, int aCount )
+{
+    COMMAND cmd;
+
+    cmd.m_type = aType;
+    cmd.m_index = m_points.size() - aCount;
+    cmd.m_count = aCount;
+
+    m_commands.push_back( cmd );
+
+    return m_commands.back();
+}
+
+
+void GAL_DISPLAY_LIST::syncState()
+{
+    STATE state = { m_isFillEnabled, m_isStrokeEnabled, m_fillColor, m_strokeColor,
+                    m_lineWidth, m_layerDepth };
+
+    if( m_stateValid && state == m_lastState )
+        return;
+
+    m_states.push_back( state );
+    addCommand( COMMAND_TYPE::STATE ).m_index = m_states.size() - 1;
+
+    m_lastState = state;
+    m_stateValid = true;
+}
+
+
+void GAL_DISPLAY_LIST::addPoints( const VECTOR2D aPointList[], int aListSize )
+{
+    m_points.insert( m_points.end(), aPointList, aPointList + aListSize );
+}
+
+
+void GAL_DISPLAY_LIST::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    syncState();
+    m_points.push_back( aStartPoint );
+    m_points.push_back( aEndPoint );
+    addCommand( COMMAND_TYPE::LINE, 2 );
+}
+
+
+void GAL_DISPLAY_LIST::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                                    double aWidth )
+{
+    syncState();
+    m_points.push_back( aStartPoint );
+    m_points.push_back( aEndPoint );
+    addCommand( COMMAND_TYPE::SEGMENT, 2 ).m_args[0] = aWidth;
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
+{
+    syncState();
+    m_points.insert( m_points.end(), aPointList.begin(), aPointList.end() );
+    addCommand( COMMAND_TYPE::POLYLINE_DEQUE, aPointList.size() );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
+{
+    syncState();
+    addPoints( aPointList, aListSize );
+    addCommand( COMMAND_TYPE::POLYLINE_ARRAY, aListSize );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    syncState();
+    m_lineChains.push_back( aLineChain );
+    addCommand( COMMAND_TYPE::POLYLINE_CHAIN ).m_index = m_lineChains.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    syncState();
+    m_points.push_back( aCenterPoint );
+    addCommand( COMMAND_TYPE::CIRCLE, 1 ).m_args[0] = aRadius;
+}
+
+
+void GAL_DISPLAY_LIST::DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                                double aStartAngle, double aEndAngle )
+{
+    syncState();
+    m_points.push_back( aCenterPoint );
+
+    COMMAND& cmd = addCommand( COMMAND_TYPE::ARC, 1 );
+    cmd.m_args[0] = aRadius;
+    cmd.m_args[1] = aStartAngle;
+    cmd.m_args[2] = aEndAngle;
+}
+
+
+void GAL_DISPLAY_LIST::DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                       double aStartAngle, double aEndAngle, double aWidth )
+{
+    syncState();
+    m_points.push_back( aCenterPoint );
+
+    COMMAND& cmd = addCommand( COMMAND_TYPE::ARC_SEGMENT, 1 );
+    cmd.m_args[0] = aRadius;
+    cmd.m_args[1] = aStartAngle;
+    cmd.m_args[2] = aEndAngle;
+    cmd.m_args[3] = aWidth;
+}
+
+
+void GAL_DISPLAY_LIST::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    syncState();
+    m_points.push_back( aStartPoint );
+    m_points.push_back( aEndPoint );
+    addCommand( COMMAND_TYPE::RECTANGLE, 2 );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+{
+    syncState();
+    m_points.insert( m_points.end(), aPointList.begin(), aPointList.end() );
+    addCommand( COMMAND_TYPE::POLYGON_DEQUE, aPointList.size() );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
+{
+    syncState();
+    addPoints( aPointList, aListSize );
+    addCommand( COMMAND_TYPE::POLYGON_ARRAY, aListSize );
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    syncState();
+
+    // The copy keeps the triangulation, so it isn't computed again when replaying
+    m_polySets.push_back( aPolySet );
+    addCommand( COMMAND_TYPE::POLYGON_SET ).m_index = m_polySets.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet )
+{
+    syncState();
+    m_lineChains.push_back( aPolySet );
+    addCommand( COMMAND_TYPE::POLYGON_CHAIN ).m_index = m_lineChains.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                                  const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                                  double aFilterValue )
+{
+    syncState();
+    m_points.push_back( aStartPoint );
+    m_points.push_back( aControlPointA );
+    m_points.push_back( aControlPointB );
+    m_points.push_back( aEndPoint );
+    addCommand( COMMAND_TYPE::CURVE, 4 ).m_args[0] = aFilterValue;
+}
+
+
+void GAL_DISPLAY_LIST::DrawBitmap( const BITMAP_BASE& aBitmap )
+{
+    // Bitmaps are cached by the target GAL, they can't be copied around
+    if( !m_drawings.empty() )
+        m_drawings.back().m_complete = false;
+}
+
+
+void GAL_DISPLAY_LIST::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                                   double aRotationAngle )
+{
+    syncState();
+
+    TEXT text;
+
+    text.m_text = aText;
+    text.m_position = aPosition;
+    text.m_rotationAngle = aRotationAngle;
+    text.m_glyphSize = GetGlyphSize();
+    text.m_horizontalJustify = GetHorizontalJustify();
+    text.m_verticalJustify = GetVerticalJustify();
+    text.m_bold = IsFontBold();
+    text.m_italic = IsFontItalic();
+    text.m_underlined = IsFontUnderlined();
+    text.m_mirrored = IsTextMirrored();
+
+    m_texts.push_back( text );
+    addCommand( COMMAND_TYPE::BITMAP_TEXT ).m_index = m_texts.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::Transform( const MATRIX3x3D& aTransformation )
+{
+    m_matrices.push_back( aTransformation );
+    addCommand( COMMAND_TYPE::TRANSFORM ).m_index = m_matrices.size() - 1;
+}
+
+
+void GAL_DISPLAY_LIST::Rotate( double aAngle )
+{
+    addCommand( COMMAND_TYPE::ROTATE ).m_args[0] = aAngle;
+}
+
+
+void GAL_DISPLAY_LIST::Translate( const VECTOR2D& aTranslation )
+{
+    m_points.push_back( aTranslation );
+    addCommand( COMMAND_TYPE::TRANSLATE, 1 );
+}
+
+
+void GAL_DISPLAY_LIST::Scale( const VECTOR2D& aScale )
+{
+    m_points.push_back( aScale );
+    addCommand( COMMAND_TYPE::SCALE, 1 );
+}
+
+
+void GAL_DISPLAY_LIST::Save()
+{
+    addCommand( COMMAND_TYPE::SAVE );
+}
+
+
+void GAL_DISPLAY_LIST::Restore()
+{
+    addCommand( COMMAND_TYPE::RESTORE );
+}
+
+
+void GAL_DISPLAY_LIST::replayCommand( const COMMAND& aCommand, GAL* aTarget ) const
+{
+    const VECTOR2D* points = aCommand.m_count ? &m_points[aCommand.m_index] : nullptr;
+    const double*   args = aCommand.m_args;
+
+    switch( aCommand.m_type )
+    {
+    case COMMAND_TYPE::STATE:
+    {
+        const STATE& state = m_states[aCommand.m_index];
+
+        aTarget->SetIsFill( state.m_isFill );
+        aTarget->SetIsStroke( state.m_isStroke );
+        aTarget->SetFillColor( state.m_fillColor );
+        aTarget->SetStrokeColor( state.m_strokeColor );
+        aTarget->SetLineWidth( state.m_lineWidth );
+        aTarget->SetLayerDepth( state.m_layerDepth );
+        break;
+    }
+
+    case COMMAND_TYPE::LINE:
+        aTarget->DrawLine( points[0], points[1] );
+        break;
+
+    case COMMAND_TYPE::SEGMENT:
+        aTarget->DrawSegment( points[0], points[1], args[0] );
+        break;
+
+    case COMMAND_TYPE::POLYLINE_DEQUE:
+        aTarget->DrawPolyline( std::deque<VECTOR2D>( points, points + aCommand.m_count ) );
+        break;
+
+    case COMMAND_TYPE::POLYLINE_ARRAY:
+        aTarget->DrawPolyline( points, aCommand.m_count );
+        break;
+
+    case COMMAND_TYPE::POLYLINE_CHAIN:
+        aTarget->DrawPolyline( m_lineChains[aCommand.m_index] );
+        break;
+
+    case COMMAND_TYPE::CIRCLE:
+        aTarget->DrawCircle( points[0], args[0] );
+        break;
+
+    case COMMAND_TYPE::ARC:
+        aTarget->DrawArc( points[0], args[0], args[1], args[2] );
+        break;
+
+    case COMMAND_TYPE::ARC_SEGMENT:
+        aTarget->DrawArcSegment( points[0], args[0], args[1], args[2], args[3] );
+        break;
+
+    case COMMAND_TYPE::RECTANGLE:
+        aTarget->DrawRectangle( points[0], points[1] );
+        break;
+
+    case COMMAND_TYPE::POLYGON_DEQUE:
+        aTarget->DrawPolygon( std::deque<VECTOR2D>( points, points + aCommand.m_count ) );
+        break;
+
+    case COMMAND_TYPE::POLYGON_ARRAY:
+        aTarget->DrawPolygon( points, aCommand.m_count );
+        break;
+
+    case COMMAND_TYPE::POLYGON_SET:
+        aTarget->DrawPolygon( m_polySets[aCommand.m_index] );
+        break;
+
+    case COMMAND_TYPE::POLYGON_CHAIN:
+        aTarget->DrawPolygon( m_lineChains[aCommand.m_index] );
+        break;
+
+    case COMMAND_TYPE::CURVE:
+        aTarget->DrawCurve( points[0], points[1], points[2], points[3], args[0] );
+        break;
+
+    case COMMAND_TYPE::BITMAP_TEXT:
+    {
+        const TEXT& text = m_texts[aCommand.m_index];
+
+        aTarget->SetGlyphSize( text.m_glyphSize );
+        aTarget->SetHorizontalJustify( text.m_horizontalJustify );
+        aTarget->SetVerticalJustify( text.m_verticalJustify );
+        aTarget->SetFontBold( text.m_bold );
+        aTarget->SetFontItalic( text.m_italic );
+        aTarget->SetFontUnderlined( text.m_underlined );
+        aTarget->SetTextMirrored( text.m_mirrored );
+        aTarget->BitmapText( text.m_text, text.m_position, text.m_rotationAngle );
+        break;
+    }
+
+    case COMMAND_TYPE::TRANSFORM:
+        aTarget->Transform( m_matrices[aCommand.m_index] );
+        break;
+
+    case COMMAND_TYPE::ROTATE:
+        aTarget->Rotate( args[0] );
+        break;
+
+    case COMMAND_TYPE::TRANSLATE:
+        aTarget->Translate( points[0] );
+        break;
+
+    case COMMAND_TYPE::SCALE:
+        aTarget->Scale( points[0] );
+        break;
+
+    case COMMAND_TYPE::SAVE:
+        aTarget->Save();
+        break;
+
+    case COMMAND_TYPE::RESTORE:
+        aTarget->Restore();
+        break;
+    }
+}
@@ -36,9 +36,12 @@
 #include <gal/opengl/vertex_item.h>
 #include <gal/opengl/utils.h>
 
-#include <list>
+#include <perf_counters.h>
+
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <iterator>
 
 #ifdef __WXDEBUG__
 #include <wx/log.h>
@@ -47,15 +50,19 @@
 
 using namespace KIGFX;
 
+///< Number of vertices which may be moved to compact the container each time an item is finished
+static const unsigned int COMPACTION_BUDGET = 4096;
+
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
         VERTEX_CONTAINER( aSize ),
+        m_freeChunks( aSize ),
         m_item( nullptr ),
         m_chunkSize( 0 ),
         m_chunkOffset( 0 ),
-        m_maxIndex( 0 )
+        m_maxIndex( 0 ),
+        m_defragmentations( 0 ),
+        m_relocatedVertices( 0 )
 {
-    // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
 }
 
 
@@ -65,10 +72,14 @@ void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 
     unsigned int itemSize = aItem->GetSize();
     m_item = aItem;
-    m_chunkSize = itemSize;
+    m_chunkSize = getChunkSize( aItem );
 
     // Get the previously set offset if the item was stored previously
     m_chunkOffset = itemSize > 0 ? aItem->GetOffset() : -1;
+
+    // The current item is kept apart until it is finished, as it may move
+    if( itemSize > 0 )
+        m_items.erase( m_chunkOffset );
 }
 
 
@@ -77,27 +88,30 @@ void CACHED_CONTAINER::FinishItem()
     assert( m_item != nullptr );
 
     unsigned int itemSize = m_item->GetSize();
+    unsigned int chunkSize = getChunkSize( m_item );
 
     // Finishing the previously edited item
-    if( itemSize < m_chunkSize )
+    if( chunkSize < m_chunkSize )
     {
         // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
-
-        // Add the not used memory back to the pool
-        addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
-
-        m_maxIndex = std::max( itemOffset + itemSize, m_maxIndex );
+        m_freeChunks.Free( m_chunkOffset + chunkSize, m_chunkSize - chunkSize );
+        m_freeSpace = m_freeChunks.GetFreeSpace();
     }
 
     if( itemSize > 0 )
-        m_items.insert( m_item );
+    {
+        m_items.emplace( m_item->GetOffset(), m_item );
+        m_maxIndex = std::max( m_item->GetOffset() + itemSize, m_maxIndex );
+    }
 
     m_item = nullptr;
     m_chunkSize = 0;
     m_chunkOffset = 0;
 
+    // Moving vertices around requires access to the buffer
+    if( IsMapped() )
+        compact( COMPACTION_BUDGET );
+
 #if CACHED_CONTAINER_TEST > 1
     test();
 #endif
@@ -148,7 +162,7 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 {
     assert( aItem != nullptr );
-    assert( m_items.find( aItem ) != m_items.end() || aItem->GetSize() == 0 );
+    assert( m_items.count( aItem->GetOffset() ) || aItem->GetSize() == 0 );
 
     int size = aItem->GetSize();
 
@@ -158,12 +172,13 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
     int offset = aItem->GetOffset();
 
     // Insert a free memory chunk entry in the place where item was stored
-    addFreeChunk( offset, size );
+    m_freeChunks.Free( offset, getChunkSize( aItem ) );
+    m_freeSpace = m_freeChunks.GetFreeSpace();
 
     // Indicate that the item is not stored in the container anymore
     aItem->setSize( 0 );
 
-    m_items.erase( aItem );
+    m_items.erase( offset );
 
 #if CACHED_CONTAINER_TEST > 0
     test();
@@ -194,14 +209,13 @@ void CACHED_CONTAINER::Clear()
 
     // Set the size of all the stored VERTEX_ITEMs to 0, so it is clear that they are not held
     // in the container anymore
-    for( ITEMS::iterator it = m_items.begin(); it != m_items.end(); ++it )
-        ( *it )->setSize( 0 );
+    for( const std::pair<const unsigned int, VERTEX_ITEM*>& entry : m_items )
+        entry.second->setSize( 0 );
 
     m_items.clear();
 
     // Now there is only free space left
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+    m_freeChunks.Reset( m_currentSize );
 }
 
 
@@ -213,38 +227,46 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     unsigned int itemSize = m_item->GetSize();
 
     // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    unsigned int newChunkOffset = m_freeChunks.Allocate( aSize );
 
     // Is there enough space to store vertices?
-    if( newChunk == m_freeChunks.end() )
+    if( newChunkOffset == CHUNK_ALLOCATOR::NO_SPACE )
     {
-        bool result;
+        static PERF_COUNTER& defragCounter =
+                PERF_COUNTERS::Get( "gal.cached_container.defragment" );
+
+        SCOPED_PERF_TIMER timer( defragCounter );
+        unsigned int      chunkSize = CHUNK_ALLOCATOR::SizeClass( aSize );
+        bool              result;
 
-        // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
+        if( usedSpace() + chunkSize <= m_currentSize / 4 * 3 )
         {
+            // The free space is only scattered: packing the items is enough
+            result = defragmentResize( m_currentSize );
+        }
+        else if( chunkSize < m_freeSpace + m_currentSize )
+        {
+            // Would it be enough to double the current space?
             // Yes: exponential growing
             result = defragmentResize( m_currentSize * 2 );
         }
         else
         {
             // No: grow to the nearest greater power of 2
-            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
+            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + chunkSize ) ) ) );
         }
 
         if( !result )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
-        assert( newChunk != m_freeChunks.end() );
+        newChunkOffset = m_freeChunks.Allocate( aSize );
+        assert( newChunkOffset != CHUNK_ALLOCATOR::NO_SPACE );
     }
 
     // Parameters of the allocated chunk
-    unsigned int newChunkSize = getChunkSize( *newChunk );
-    unsigned int newChunkOffset = getChunkOffset( *newChunk );
+    unsigned int newChunkSize = CHUNK_ALLOCATOR::SizeClass( aSize );
 
-    assert( newChunkSize >= aSize );
-    assert( newChunkOffset < m_currentSize );
+    assert( newChunkOffset + newChunkSize <= m_currentSize );
 
     // Check if the item was previously stored in the container
     if( itemSize > 0 )
@@ -253,12 +275,10 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
 
         // Free the space used by the previous chunk
-        addFreeChunk( m_chunkOffset, m_chunkSize );
+        m_freeChunks.Free( m_chunkOffset, m_chunkSize );
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
+    m_freeSpace = m_freeChunks.GetFreeSpace();
 
     m_chunkSize = newChunkSize;
     m_chunkOffset = newChunkOffset;
@@ -272,22 +292,21 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
 void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
     // Defragmentation
-    ITEMS::iterator it, it_end;
-    int             newOffset = 0;
+    unsigned int newOffset = 0;
 
-    for( VERTEX_ITEM* item : m_items )
+    for( const std::pair<const unsigned int, VERTEX_ITEM*>& entry : m_items )
     {
-        int itemOffset = item->GetOffset();
-        int itemSize = item->GetSize();
+        VERTEX_ITEM* item = entry.second;
 
         // Move an item to the new container
-        memcpy( &aTarget[newOffset], &m_vertices[itemOffset], itemSize * VERTEX_SIZE );
+        memcpy( &aTarget[newOffset], &m_vertices[item->GetOffset()],
+                item->GetSize() * VERTEX_SIZE );
 
         // Update new offset
         item->setOffset( newOffset );
 
         // Move to the next free space
-        newOffset += itemSize;
+        newOffset += getChunkSize( item );
     }
 
     // Move the current item and place it at the end
@@ -298,72 +317,76 @@ void CACHED_CONTAINER::defragment( VERTEX* aTarget )
         m_item->setOffset( newOffset );
         m_chunkOffset = newOffset;
     }
-
-    m_maxIndex = usedSpace();
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+void CACHED_CONTAINER::finishDefragmentation( unsigned int aNewSize )
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
-
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
+    unsigned int used = usedSpace();
 
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
+    // The offsets of the items changed, but not their order
+    ITEMS items;
 
-    FREE_CHUNK_MAP::const_iterator it, it_end;
+    for( const std::pair<const unsigned int, VERTEX_ITEM*>& entry : m_items )
+        items.emplace_hint( items.end(), entry.second->GetOffset(), entry.second );
 
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
-    {
-        freeChunks.emplace_back( it->second, it->first );
-    }
+    m_items.swap( items );
 
-    m_freeChunks.clear();
-    freeChunks.sort();
+    m_currentSize = aNewSize;
+    m_freeSpace = aNewSize - used;
+    m_maxIndex = used;
+    m_defragmentations++;
 
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int                     offset = freeChunks.front().first;
-    unsigned int                     size = freeChunks.front().second;
-    freeChunks.pop_front();
+    // Now there is only one big chunk of free memory
+    m_freeChunks.Reset( aNewSize, used );
+}
 
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
-    {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
-        {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size = itf->second;
-        }
-    }
 
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
+void CACHED_CONTAINER::compact( unsigned int aBudget )
+{
+    static PERF_COUNTER& relocatedCounter =
+            PERF_COUNTERS::Get( "gal.cached_container.relocated_vertices" );
+
+    auto highest =
+            [&]( unsigned int& aOffset, unsigned int& aSize )
+            {
+                if( m_items.empty() )
+                    return false;
+
+                aOffset = m_items.rbegin()->first;
+                aSize = getChunkSize( m_items.rbegin()->second );
+                return true;
+            };
+
+    auto move =
+            [&]( unsigned int aOffset, unsigned int aNewOffset )
+            {
+                ITEMS::iterator last = std::prev( m_items.end() );
+                VERTEX_ITEM*    item = last->second;
+                unsigned int    size = item->GetSize();
+
+                memcpy( &m_vertices[aNewOffset], &m_vertices[aOffset], size * VERTEX_SIZE );
+                item->setOffset( aNewOffset );
+
+                m_items.erase( last );
+                m_items.emplace( aNewOffset, item );
+
+                m_relocatedVertices += size;
+                relocatedCounter.Increment( size );
+                m_dirty = true;
+            };
+
+    if( m_freeChunks.Compact( aBudget, highest, move ) == 0 )
+        return;
 
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
+    // Nothing is stored after the last item anymore
+    m_maxIndex = m_items.rbegin()->first + m_items.rbegin()->second->GetSize();
 }
 
 
-void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+unsigned int CACHED_CONTAINER::getChunkSize( const VERTEX_ITEM* aItem )
 {
-    assert( aOffset + aSize <= m_currentSize );
-    assert( aSize > 0 );
-
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
-    m_freeSpace += aSize;
+    return CHUNK_ALLOCATOR::SizeClass( aItem->GetSize() );
 }
 
 
@@ -381,20 +404,21 @@ void CACHED_CONTAINER::test()
 {
 #ifdef __WXDEBUG__
     // Free space check
-    unsigned int             freeSpace = 0;
-    FREE_CHUNK_MAP::iterator itf;
-
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
-
-    assert( freeSpace == m_freeSpace );
+    assert( m_freeChunks.GetFreeSpace() == m_freeSpace );
 
     // Used space check
-    unsigned int    used_space = 0;
-    ITEMS::iterator itr;
+    unsigned int used_space = 0;
+    unsigned int end = 0;
 
-    for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        used_space += ( *itr )->GetSize();
+    for( const std::pair<const unsigned int, VERTEX_ITEM*>& entry : m_items )
+    {
+        // Items are indexed by their offset, and don't overlap
+        assert( entry.first == entry.second->GetOffset() );
+        assert( entry.first >= end );
+
+        used_space += getChunkSize( entry.second );
+        end = entry.first + getChunkSize( entry.second );
+    }
 
     // If we have a chunk assigned, then there must be an item edited
     assert( m_chunkSize == 0 || m_item );
@@ -403,7 +427,5 @@ void CACHED_CONTAINER::test()
     used_space += m_chunkSize;
 
     assert( ( m_freeSpace + used_space ) == m_currentSize );
-
-    // Overlapping check TODO
 #endif /* __WXDEBUG__ */
 }
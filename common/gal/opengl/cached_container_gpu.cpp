@@ -152,13 +152,12 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, nullptr, GL_DYNAMIC_DRAW );
     checkGlError( "creating buffer during defragmentation" );
 
-    ITEMS::iterator it, it_end;
-    int             newOffset = 0;
+    int newOffset = 0;
 
     // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+    for( const std::pair<const unsigned int, VERTEX_ITEM*>& entry : m_items )
     {
-        VERTEX_ITEM* item = *it;
+        VERTEX_ITEM* item = entry.second;
         int          itemOffset = item->GetOffset();
         int          itemSize = item->GetSize();
 
@@ -170,7 +169,7 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
         item->setOffset( newOffset );
 
         // Move to the next free space
-        newOffset += itemSize;
+        newOffset += getChunkSize( item );
     }
 
     // Move the current item and place it at the end
@@ -205,12 +204,7 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
                 m_currentSize - m_freeSpace, totalTime.msecs() );
 #endif /* __WXDEBUG__ */
 
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    finishDefragmentation( aNewSize );
 
     return true;
 }
@@ -270,12 +264,7 @@ bool CACHED_CONTAINER_GPU::defragmentResizeMemcpy( unsigned int aNewSize )
                 m_currentSize - m_freeSpace, totalTime.msecs() );
 #endif /* __WXDEBUG__ */
 
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    finishDefragmentation( aNewSize );
 
     return true;
 }
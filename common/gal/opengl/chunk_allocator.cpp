@@ -0,0 +1,202 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/chunk_allocator.h>
+
+#include <cassert>
+#include <iterator>
+
+using namespace KIGFX;
+
+constexpr unsigned int CHUNK_ALLOCATOR::NO_SPACE;
+
+
+CHUNK_ALLOCATOR::CHUNK_ALLOCATOR( unsigned int aSize )
+{
+    Reset( aSize );
+}
+
+
+unsigned int CHUNK_ALLOCATOR::SizeClass( unsigned int aSize )
+{
+    // Small items (most of the segments, circles and vias) come in multiples of 8 vertices
+    if( aSize <= 64 )
+        return ( aSize + 7 ) & ~7u;
+
+    // Above, there are four classes for each power of two, so at most 25% is wasted
+    unsigned int step = 16;
+
+    while( ( step << 3 ) < aSize )
+        step <<= 1;
+
+    return ( aSize + step - 1 ) & ~( step - 1 );
+}
+
+
+void CHUNK_ALLOCATOR::Reset( unsigned int aSize, unsigned int aUsed )
+{
+    assert( aUsed <= aSize );
+
+    m_bySize.clear();
+    m_byOffset.clear();
+    m_size = aSize;
+    m_freeSpace = 0;
+
+    if( aUsed < aSize )
+        addFreeChunk( aUsed, aSize - aUsed );
+}
+
+
+unsigned int CHUNK_ALLOCATOR::Allocate( unsigned int aSize, unsigned int aBelow )
+{
+    unsigned int size = SizeClass( aSize );
+
+    assert( size > 0 );
+
+    // Chunks of the same size are sorted by offset, so the lowest one is used first
+    std::set<CHUNK>::iterator it = m_bySize.lower_bound( CHUNK( size, 0 ) );
+
+    while( it != m_bySize.end() && it->second >= aBelow )
+        ++it;
+
+    if( it == m_bySize.end() )
+        return NO_SPACE;
+
+    unsigned int chunkSize = it->first;
+    unsigned int offset = it->second;
+
+    removeFreeChunk( offset, chunkSize );
+
+    // The remaining part stays free, its neighbours are used so there is nothing to merge
+    if( chunkSize > size )
+        addFreeChunk( offset + size, chunkSize - size );
+
+    return offset;
+}
+
+
+void CHUNK_ALLOCATOR::Free( unsigned int aOffset, unsigned int aSize )
+{
+    assert( aSize > 0 );
+    assert( aOffset + aSize <= m_size );
+
+    std::map<unsigned int, unsigned int>::iterator next = m_byOffset.upper_bound( aOffset );
+
+    // Merge with the free chunk before, if it ends where this one starts
+    if( next != m_byOffset.begin() )
+    {
+        std::map<unsigned int, unsigned int>::iterator prev = std::prev( next );
+
+        assert( prev->first + prev->second <= aOffset );
+
+        if( prev->first + prev->second == aOffset )
+        {
+            unsigned int prevOffset = prev->first;
+            unsigned int prevSize = prev->second;
+
+            removeFreeChunk( prevOffset, prevSize );
+            aOffset = prevOffset;
+            aSize += prevSize;
+        }
+    }
+
+    // Merge with the free chunk after, if it starts where this one ends
+    if( next != m_byOffset.end() )
+    {
+        assert( aOffset + aSize <= next->first );
+
+        if( aOffset + aSize == next->first )
+        {
+            unsigned int nextSize = next->second;
+
+            removeFreeChunk( next->first, nextSize );
+            aSize += nextSize;
+        }
+    }
+
+    addFreeChunk( aOffset, aSize );
+}
+
+
+unsigned int CHUNK_ALLOCATOR::Relocate( unsigned int aOffset, unsigned int aSize )
+{
+    unsigned int newOffset = Allocate( aSize, aOffset );
+
+    if( newOffset != NO_SPACE )
+        Free( aOffset, aSize );
+
+    return newOffset;
+}
+
+
+unsigned int CHUNK_ALLOCATOR::Compact( unsigned int aBudget,
+                                       const std::function<bool( unsigned int&,
+                                                                 unsigned int& )>& aHighest,
+                                       const std::function<void( unsigned int,
+                                                                 unsigned int )>& aMove )
+{
+    // Only worth it once a significant part of the container is lost between the chunks
+    if( m_freeSpace - GetLargestFreeChunk() < m_size / 8 )
+        return 0;
+
+    unsigned int moved = 0;
+    unsigned int offset, size;
+
+    while( aHighest( offset, size ) && moved + size <= aBudget )
+    {
+        unsigned int newOffset = Relocate( offset, size );
+
+        if( newOffset == NO_SPACE )
+            break;
+
+        aMove( offset, newOffset );
+        moved += size;
+    }
+
+    return moved;
+}
+
+
+double CHUNK_ALLOCATOR::GetFragmentation() const
+{
+    if( m_freeSpace == 0 )
+        return 0.0;
+
+    return 1.0 - (double) GetLargestFreeChunk() / m_freeSpace;
+}
+
+
+void CHUNK_ALLOCATOR::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    m_bySize.emplace( aSize, aOffset );
+    m_byOffset.emplace( aOffset, aSize );
+    m_freeSpace += aSize;
+}
+
+
+void CHUNK_ALLOCATOR::removeFreeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    m_bySize.erase( CHUNK( aSize, aOffset ) );
+    m_byOffset.erase( aOffset );
+    m_freeSpace -= aSize;
+}
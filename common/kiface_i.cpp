@@ -27,6 +27,7 @@
 #include <kiway.h>
 #include <search_stack.h>
 #include <systemdirsappend.h>
+#include <thread_pool.h>
 
 /// Initialize aDst SEARCH_STACK with KIFACE (DSO) specific settings.
 /// A non-member function so it an be moved easily, plus it's nobody's business.
@@ -94,5 +95,8 @@ bool KIFACE_I::start_common( int aCtlBits )
 void KIFACE_I::end_common()
 {
     m_bm.End();
+
+    // Each KIFACE links its own copy of the shared pool
+    THREAD_POOL::Shutdown();
 }
 
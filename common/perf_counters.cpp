@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <perf_counters.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <nlohmann/json.hpp>
+
+
+void PERF_COUNTER::AddSample( std::chrono::nanoseconds aDuration )
+{
+    uint64_t ns = aDuration.count() > 0 ? aDuration.count() : 0;
+    uint64_t prevMax = m_maxNs;
+
+    m_count++;
+    m_totalNs += ns;
+
+    while( ns > prevMax && !m_maxNs.compare_exchange_weak( prevMax, ns ) )
+        ;
+}
+
+
+void PERF_COUNTER::Reset()
+{
+    m_count = 0;
+    m_totalNs = 0;
+    m_maxNs = 0;
+}
+
+
+void PERF_COUNTER::Show( std::ostream& aStream ) const
+{
+    aStream << m_name << " ran " << m_count << " times, took " << GetTotalMs() << "ms (max "
+            << GetMaxMs() << "ms)" << std::endl;
+}
+
+
+namespace
+{
+
+struct REGISTRY
+{
+    std::mutex                                           m_lock;
+    std::map<std::string, std::unique_ptr<PERF_COUNTER>> m_counters;
+};
+
+
+REGISTRY& registry()
+{
+    static REGISTRY s_registry;
+    return s_registry;
+}
+
+} // namespace
+
+
+PERF_COUNTER& PERF_COUNTERS::Get( const std::string& aName )
+{
+    REGISTRY&                   reg = registry();
+    std::lock_guard<std::mutex> lock( reg.m_lock );
+
+    std::unique_ptr<PERF_COUNTER>& counter = reg.m_counters[aName];
+
+    if( !counter )
+        counter = std::make_unique<PERF_COUNTER>( aName );
+
+    return *counter;
+}
+
+
+std::vector<const PERF_COUNTER*> PERF_COUNTERS::GetAll()
+{
+    REGISTRY&                   reg = registry();
+    std::lock_guard<std::mutex> lock( reg.m_lock );
+
+    std::vector<const PERF_COUNTER*> counters;
+
+    for( const auto& entry : reg.m_counters )
+        counters.push_back( entry.second.get() );
+
+    return counters;
+}
+
+
+void PERF_COUNTERS::ResetAll()
+{
+    REGISTRY&                   reg = registry();
+    std::lock_guard<std::mutex> lock( reg.m_lock );
+
+    for( auto& entry : reg.m_counters )
+        entry.second->Reset();
+}
+
+
+std::string PERF_COUNTERS::ToJson()
+{
+    nlohmann::json counters = nlohmann::json::array();
+
+    for( const PERF_COUNTER* counter : GetAll() )
+    {
+        counters.push_back( { { "name", counter->GetName() },
+                              { "count", counter->GetCount() },
+                              { "total_ms", counter->GetTotalMs() },
+                              { "max_ms", counter->GetMaxMs() } } );
+    }
+
+    nlohmann::json js;
+    js["counters"] = counters;
+
+    return js.dump( 2 );
+}
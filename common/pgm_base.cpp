@@ -61,6 +61,7 @@
 #include <settings/common_settings.h>
 #include <settings/settings_manager.h>
 #include <systemdirsappend.h>
+#include <thread_pool.h>
 #include <trace_helpers.h>
 
 
@@ -135,6 +136,8 @@ void PGM_BASE::Destroy()
 
     delete m_locale;
     m_locale = 0;
+
+    THREAD_POOL::Shutdown();
 }
 
 
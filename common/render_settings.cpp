@@ -43,6 +43,7 @@ RENDER_SETTINGS::RENDER_SETTINGS() :
     m_minPenWidth           = 0;
     m_showPageLimits        = false;
     m_isPrinting            = false;
+    m_detailLevel           = 0;
 }
 
 
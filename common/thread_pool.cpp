@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <algorithm>
+
+
+// The pool the current thread is a worker of, if any
+static thread_local const THREAD_POOL* s_workerPool = nullptr;
+
+// The shared pool, created on first use and deleted by Shutdown()
+static std::mutex   s_instanceLock;
+static THREAD_POOL* s_instance = nullptr;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_stopping( false )
+{
+    // hardware_concurrency() may return 0 when it can't tell
+    aThreadCount = std::max<size_t>( aThreadCount, 1 );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( &THREAD_POOL::workerLoop, this );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_stopping = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& worker : m_workers )
+        worker.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::Instance()
+{
+    std::lock_guard<std::mutex> lock( s_instanceLock );
+
+    if( !s_instance )
+        s_instance = new THREAD_POOL;
+
+    return *s_instance;
+}
+
+
+void THREAD_POOL::Shutdown()
+{
+    std::lock_guard<std::mutex> lock( s_instanceLock );
+
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+
+bool THREAD_POOL::IsWorkerThread() const
+{
+    return s_workerPool == this;
+}
+
+
+void THREAD_POOL::workerLoop()
+{
+    s_workerPool = this;
+
+    while( true )
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+
+            m_wakeUp.wait( lock, [this]() { return m_stopping || !m_queue.empty(); } );
+
+            // Finish the queued tasks before stopping, their futures are waited on
+            if( m_queue.empty() )
+                return;
+
+            task = std::move( m_queue.front() );
+            m_queue.pop_front();
+        }
+
+        task();
+    }
+}
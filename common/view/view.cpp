@@ -36,8 +36,14 @@
 #include <view/view_overlay.h>
 
 #include <gal/definitions.h>
+#include <gal/gal_display_list.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -104,10 +110,14 @@ private:
      * Return number of the group id for the given layer, or -1 in case it was not cached before.
      *
      * @param aLayer is the layer number for which group id is queried.
+     * @param aLevel is the level of detail of the geometry stored in the group.
      * @return group id or -1 in case there is no group id (ie. item is not cached).
      */
-    int getGroup( int aLayer ) const
+    int getGroup( int aLayer, int aLevel = 0 ) const
     {
+        // Groups of coarser levels are stored with the layer number offset by the level
+        aLayer += aLevel * VIEW::VIEW_MAX_LAYERS;
+
         for( int i = 0; i < m_groupsSize; ++i )
         {
             if( m_groups[i].first == aLayer )
@@ -122,9 +132,12 @@ private:
      *
      * @param aLayer is the layer numbe.
      * @param aGroup is the group id.
+     * @param aLevel is the level of detail of the geometry stored in the group.
      */
-    void setGroup( int aLayer, int aGroup )
+    void setGroup( int aLayer, int aGroup, int aLevel = 0 )
     {
+        aLayer += aLevel * VIEW::VIEW_MAX_LAYERS;
+
         // Look if there is already an entry for the layer
         for( int i = 0; i < m_groupsSize; ++i )
         {
@@ -182,7 +195,8 @@ private:
     {
         for( int i = 0; i < m_groupsSize; ++i )
         {
-            int orig_layer = m_groups[i].first;
+            int offset = m_groups[i].first - m_groups[i].first % VIEW::VIEW_MAX_LAYERS;
+            int orig_layer = m_groups[i].first - offset;
             int new_layer = orig_layer;
 
             try
@@ -191,7 +205,7 @@ private:
             }
             catch( const std::out_of_range& ) {}
 
-            m_groups[i].first = new_layer;
+            m_groups[i].first = new_layer + offset;
         }
     }
 
@@ -269,7 +283,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_coarseGeometryPending( false )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -377,10 +392,13 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         MarkTargetDirty( l.target );
 
         // Clear the GAL cache
-        int prevGroup = viewData->getGroup( layers[i] );
+        for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+        {
+            int prevGroup = viewData->getGroup( layers[i], level );
 
-        if( prevGroup >= 0 )
-            m_gal->DeleteGroup( prevGroup );
+            if( prevGroup >= 0 )
+                m_gal->DeleteGroup( prevGroup );
+        }
     }
 
     viewData->deleteGroups();
@@ -734,10 +752,14 @@ struct VIEW::UPDATE_COLOR_VISITOR
     {
         // Obtain the color that should be used for coloring the item
         const COLOR4D color = painter->GetSettings()->GetColor( aItem, layer );
-        int group = aItem->viewPrivData()->getGroup( layer );
 
-        if( group >= 0 )
-            gal->ChangeGroupColor( group, color );
+        for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+        {
+            int group = aItem->viewPrivData()->getGroup( layer, level );
+
+            if( group >= 0 )
+                gal->ChangeGroupColor( group, color );
+        }
 
         return true;
     }
@@ -788,10 +810,14 @@ void VIEW::UpdateAllLayersColor()
             for( int i = 0; i < layers_count; ++i )
             {
                 const COLOR4D color = m_painter->GetSettings()->GetColor( item, layers[i] );
-                int group = viewData->getGroup( layers[i] );
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupColor( group, color );
+                for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+                {
+                    int group = viewData->getGroup( layers[i], level );
+
+                    if( group >= 0 )
+                        m_gal->ChangeGroupColor( group, color );
+                }
             }
         }
     }
@@ -811,10 +837,13 @@ struct VIEW::UPDATE_DEPTH_VISITOR
 
     bool operator()( VIEW_ITEM* aItem )
     {
-        int group = aItem->viewPrivData()->getGroup( layer );
+        for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+        {
+            int group = aItem->viewPrivData()->getGroup( layer, level );
 
-        if( group >= 0 )
-            gal->ChangeGroupDepth( group, depth );
+            if( group >= 0 )
+                gal->ChangeGroupDepth( group, depth );
+        }
 
         return true;
     }
@@ -920,10 +949,13 @@ void VIEW::UpdateAllLayersOrder()
 
             for( int i = 0; i < layers_count; ++i )
             {
-                int group = viewData->getGroup( layers[i] );
+                for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+                {
+                    int group = viewData->getGroup( layers[i], level );
 
-                if( group >= 0 )
-                    m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+                    if( group >= 0 )
+                        m_gal->ChangeGroupDepth( group, m_layers[layers[i]].renderingOrder );
+                }
             }
         }
     }
@@ -1010,11 +1042,31 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     if( !viewData )
         return;
 
+    // Items too small on screen to show their details are drawn with simplified geometry
+    int level = getDetailLevel( aItem, aLayer );
+
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
         int group = viewData->getGroup( aLayer );
 
+        if( level > 0 )
+        {
+            int coarseGroup = viewData->getGroup( aLayer, level );
+
+            // Groups can't be created while drawing, so the full geometry is used until the
+            // coarse one is cached by the next update
+            if( coarseGroup >= 0 )
+            {
+                group = coarseGroup;
+            }
+            else
+            {
+                Update( aItem, COARSE );
+                m_coarseGeometryPending = true;
+            }
+        }
+
         if( group >= 0 )
             m_gal->DrawGroup( group );
         else
@@ -1023,8 +1075,12 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     else
     {
         // Immediate mode
+        m_painter->GetSettings()->SetDetailLevel( level );
+
         if( !m_painter->Draw( aItem, aLayer ) )
             aItem->ViewDraw( aLayer, this );  // Alternative drawing method
+
+        m_painter->GetSettings()->SetDetailLevel( 0 );
     }
 }
 
@@ -1069,13 +1125,18 @@ struct VIEW::RECACHE_ITEM_VISITOR
         if( !viewData )
             return false;
 
-        // Remove previously cached group
-        int group = viewData->getGroup( layer );
+        // Remove previously cached groups
+        for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+        {
+            int group = viewData->getGroup( layer, level );
 
-        if( group >= 0 )
-            gal->DeleteGroup( group );
+            if( group >= 0 )
+            {
+                gal->DeleteGroup( group );
+                viewData->setGroup( layer, -1, level );
+            }
+        }
 
-        viewData->setGroup( layer, -1 );
         view->Update( aItem );
 
         return true;
@@ -1189,7 +1250,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<GEOMETRY_UPDATE>* aGeometryUpdates )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1211,9 +1273,19 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         }
     }
 
-    int layers[VIEW_MAX_LAYERS], layers_count;
+    VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
+    int             layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
+    auto updateGeometry =
+            [&]( int aLayer, int aLevel )
+            {
+                if( aGeometryUpdates )
+                    aGeometryUpdates->push_back( { aItem, aLayer, aLevel } );
+                else
+                    updateItemGeometry( aItem, aLayer, aLevel );
+            };
+
     // Iterate through layers used by the item and recache it immediately
     for( int i = 0; i < layers_count; ++i )
     {
@@ -1222,16 +1294,39 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
         if( IsCached( layerId ) )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
-                updateItemGeometry( aItem, layerId );
+            {
+                // The coarse geometry is recached when it is needed again
+                for( int level = 1; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+                {
+                    int coarseGroup = viewData->getGroup( layerId, level );
+
+                    if( coarseGroup >= 0 )
+                    {
+                        m_gal->DeleteGroup( coarseGroup );
+                        viewData->setGroup( layerId, -1, level );
+                    }
+                }
+
+                updateGeometry( layerId, 0 );
+            }
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
+
+            // Only the coarse geometry needed at the current scale is cached
+            if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT | COARSE ) )
+            {
+                int level = getDetailLevel( aItem, layerId );
+
+                if( level > 0 && viewData->getGroup( layerId, level ) < 0 )
+                    updateGeometry( layerId, level );
+            }
         }
 
         // Mark those layers as dirty, so the VIEW will be refreshed
         MarkTargetDirty( m_layers[layerId].target );
     }
 
-    aItem->viewPrivData()->clearUpdateFlags();
+    viewData->clearUpdateFlags();
 }
 
 
@@ -1261,15 +1356,20 @@ void VIEW::updateItemColor( VIEW_ITEM* aItem, int aLayer )
 
     // Obtain the color that should be used for coloring the item on the specific layerId
     const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
-    int group = viewData->getGroup( aLayer );
 
     // Change the color, only if it has group assigned
-    if( group >= 0 )
-        m_gal->ChangeGroupColor( group, color );
+    for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
+    {
+        int group = viewData->getGroup( aLayer, level );
+
+        if( group >= 0 )
+            m_gal->ChangeGroupColor( group, color );
+    }
 }
 
 
-void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
+void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer, int aLevel,
+                               const GAL_DISPLAY_LIST* aRecording, int aDrawing )
 {
     VIEW_ITEM_DATA* viewData = aItem->viewPrivData();
     wxCHECK( (unsigned) aLayer < m_layers.size(), /*void*/ );
@@ -1284,21 +1384,192 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     m_gal->SetLayerDepth( l.renderingOrder );
 
     // Redraw the item from scratch
-    int group = viewData->getGroup( aLayer );
+    int group = viewData->getGroup( aLayer, aLevel );
 
     if( group >= 0 )
         m_gal->DeleteGroup( group );
 
     group = m_gal->BeginGroup();
-    viewData->setGroup( aLayer, group );
+    viewData->setGroup( aLayer, group, aLevel );
+
+    if( aRecording && aRecording->IsComplete( aDrawing ) )
+    {
+        aRecording->Replay( aDrawing, m_gal );
+    }
+    else
+    {
+        m_painter->GetSettings()->SetDetailLevel( aLevel );
 
-    if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
-        aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+        if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
+            aItem->ViewDraw( aLayer, this ); // Alternative drawing method
+
+        m_painter->GetSettings()->SetDetailLevel( 0 );
+    }
 
     m_gal->EndGroup();
 }
 
 
+int VIEW::getDetailLevel( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    // Each level is used for scales 4 times smaller than the previous one
+    constexpr double levelRatio = 4.0;
+
+    // Printouts are drawn at scale 1 and show all the details, whatever the size of the items
+    if( m_printMode > 0 )
+        return 0;
+
+    double lod = aItem->ViewGetCoarseLOD( aLayer, const_cast<VIEW*>( this ) );
+
+    if( lod <= m_scale )
+        return 0;
+
+    int maxLevel = std::min( aItem->ViewGetCoarseLevels( aLayer ), VIEW_MAX_DETAIL_LEVELS - 1 );
+    int level = 1;
+
+    for( lod /= levelRatio; level < maxLevel && lod > m_scale; lod /= levelRatio )
+        level++;
+
+    return level;
+}
+
+
+void VIEW::updateItemsGeometry( const std::vector<GEOMETRY_UPDATE>& aUpdates )
+{
+    // Below this, painting the items directly is faster than setting up the threads
+    const size_t minParallelUpdates = 256;
+
+    THREAD_POOL& pool = THREAD_POOL::Instance();
+
+    if( aUpdates.size() < minParallelUpdates || pool.GetThreadCount() < 2
+            || pool.IsWorkerThread() )
+    {
+        for( const GEOMETRY_UPDATE& update : aUpdates )
+            updateItemGeometry( update.m_item, update.m_layer, update.m_level );
+
+        return;
+    }
+
+    // Items are painted on display lists by copies of the painter, one for each chunk of the
+    // updates.  Only the GL thread may touch the GAL, so the display lists are then replayed
+    // there, in the original order.  All the layers of an item are painted in the same chunk,
+    // as painters may update caches of the item they draw.
+    struct CHUNK
+    {
+        size_t                            m_first;
+        size_t                            m_last;
+        std::unique_ptr<GAL_DISPLAY_LIST> m_recording;
+        std::unique_ptr<PAINTER>          m_painter;
+        std::vector<char>                 m_painted;
+        std::future<void>                 m_task;
+    };
+
+    // Display lists subscribe to their options, so these have to outlive them
+    GAL_DISPLAY_OPTIONS options;
+    std::vector<CHUNK>  chunks;
+
+    // A few chunks per thread, so that the threads finishing first don't stay idle
+    size_t chunkSize = std::max<size_t>( aUpdates.size() / ( pool.GetThreadCount() * 4 ),
+                                         minParallelUpdates / 4 );
+
+    for( size_t first = 0; first < aUpdates.size(); )
+    {
+        size_t last = std::min( first + chunkSize, aUpdates.size() );
+
+        while( last < aUpdates.size() && aUpdates[last].m_item == aUpdates[last - 1].m_item )
+            last++;
+
+        CHUNK chunk;
+
+        chunk.m_first = first;
+        chunk.m_last = last;
+        chunk.m_recording = std::make_unique<GAL_DISPLAY_LIST>( options, m_gal );
+        chunk.m_painter.reset( m_painter->Clone( chunk.m_recording.get() ) );
+
+        // The painter can't draw items concurrently
+        if( !chunk.m_painter )
+        {
+            for( const GEOMETRY_UPDATE& update : aUpdates )
+                updateItemGeometry( update.m_item, update.m_layer, update.m_level );
+
+            return;
+        }
+
+        chunks.push_back( std::move( chunk ) );
+        first = last;
+    }
+
+    for( CHUNK& chunk : chunks )
+    {
+        chunk.m_task = pool.Submit(
+                [this, &aUpdates, &chunk]()
+                {
+                    for( size_t i = chunk.m_first; i < chunk.m_last; ++i )
+                    {
+                        VIEW_ITEM* item = aUpdates[i].m_item;
+                        int        layer = aUpdates[i].m_layer;
+
+                        chunk.m_recording->SetLayerDepth( m_layers[layer].renderingOrder );
+                        chunk.m_recording->BeginRecording();
+                        chunk.m_painter->GetSettings()->SetDetailLevel( aUpdates[i].m_level );
+
+                        if( chunk.m_painter->CanDrawConcurrently( item ) )
+                            chunk.m_painted.push_back( chunk.m_painter->Draw( item, layer ) );
+                        else
+                            chunk.m_painted.push_back( false );
+
+                        chunk.m_recording->EndRecording();
+                    }
+                } );
+    }
+
+    std::exception_ptr error;
+
+    // Replay the chunks as soon as they are painted, while the next ones are being painted.
+    // Every task refers to this stack, so all of them have to finish before throwing.
+    for( CHUNK& chunk : chunks )
+    {
+        try
+        {
+            chunk.m_task.get();
+        }
+        catch( ... )
+        {
+            if( !error )
+                error = std::current_exception();
+        }
+
+        if( !error )
+        {
+            for( size_t i = chunk.m_first; i < chunk.m_last; ++i )
+            {
+                int drawing = i - chunk.m_first;
+
+                // Items drawn by themselves, or not drawn concurrently, are drawn again here,
+                // on the GL thread
+                const GEOMETRY_UPDATE& update = aUpdates[i];
+
+                if( chunk.m_painted[drawing] )
+                {
+                    updateItemGeometry( update.m_item, update.m_layer, update.m_level,
+                                        chunk.m_recording.get(), drawing );
+                }
+                else
+                {
+                    updateItemGeometry( update.m_item, update.m_layer, update.m_level );
+                }
+            }
+        }
+
+        chunk.m_painter.reset();
+        chunk.m_recording.reset();
+    }
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -1335,12 +1606,15 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
         if( IsCached( l.id ) )
         {
             // Redraw the item from scratch
-            int prevGroup = viewData->getGroup( layers[i] );
-
-            if( prevGroup >= 0 )
+            for( int level = 0; level < VIEW_MAX_DETAIL_LEVELS; ++level )
             {
-                m_gal->DeleteGroup( prevGroup );
-                viewData->setGroup( l.id, -1 );
+                int prevGroup = viewData->getGroup( layers[i], level );
+
+                if( prevGroup >= 0 )
+                {
+                    m_gal->DeleteGroup( prevGroup );
+                    viewData->setGroup( l.id, -1, level );
+                }
             }
         }
     }
@@ -1399,14 +1673,22 @@ void VIEW::UpdateItems()
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
+        std::vector<GEOMETRY_UPDATE> geometryUpdates;
+
+        // The coarse geometry requested by the last redraw is cached below
+        m_coarseGeometryPending = false;
+
         for( VIEW_ITEM* item : *m_allItems )
         {
             if( item->viewPrivData() && item->viewPrivData()->m_requiredUpdate != NONE )
             {
-                invalidateItem( item, item->viewPrivData()->m_requiredUpdate );
+                invalidateItem( item, item->viewPrivData()->m_requiredUpdate, &geometryUpdates );
                 item->viewPrivData()->m_requiredUpdate = NONE;
             }
         }
+
+        // Painting the items is the expensive part, done for all of them at once
+        updateItemsGeometry( geometryUpdates );
     }
 }
 
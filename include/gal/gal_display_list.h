@@ -0,0 +1,220 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GAL_DISPLAY_LIST_H_
+#define GAL_DISPLAY_LIST_H_
+
+#include <deque>
+#include <vector>
+
+#include <gal/graphics_abstraction_layer.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+namespace KIGFX
+{
+
+/**
+ * A GAL recording the drawing calls made on it, to replay them later on another GAL.
+ *
+ * Painters only talk to a GAL, so a painter drawing on a display list can run on any thread:
+ * nothing is shared with the GAL the view draws on, which can only be used by the thread
+ * owning its context.  The view state (scale, flipping, depth range, engine type) is copied
+ * from the GAL the drawings are meant for when the list is created, so painters make the same
+ * decisions as they would when drawing on it directly.
+ *
+ * The drawing calls are grouped in drawings, each one replayed as a whole.  A drawing using
+ * something which can't be recorded (bitmaps) is marked incomplete and has to be drawn again
+ * directly on the target GAL.
+ *
+ * Display lists have to be created and destroyed on the main thread, as they subscribe to the
+ * display options they are given.
+ */
+class GAL_DISPLAY_LIST : public GAL
+{
+public:
+    GAL_DISPLAY_LIST( GAL_DISPLAY_OPTIONS& aOptions, GAL* aTarget );
+    ~GAL_DISPLAY_LIST();
+
+    bool IsCairoEngine() override { return m_isCairoEngine; }
+    bool IsOpenGlEngine() override { return m_isOpenGlEngine; }
+
+    /**
+     * Start recording a new drawing.
+     *
+     * The state of the target GAL is unknown at this point, so the first primitive of the
+     * drawing sets all of it again on replay.
+     *
+     * @return the index of the drawing.
+     */
+    int BeginRecording();
+
+    ///< Finish recording the drawing started by the last call to BeginRecording().
+    void EndRecording();
+
+    int GetDrawingCount() const { return m_drawings.size(); }
+
+    ///< Return false if the drawing \a aDrawing can't be replayed.
+    bool IsComplete( int aDrawing ) const { return m_drawings[aDrawing].m_complete; }
+
+    ///< Draw the drawing \a aDrawing on \a aTarget.
+    void Replay( int aDrawing, GAL* aTarget ) const;
+
+    ///< Forget all the recorded drawings.
+    void Clear();
+
+    // Drawing methods
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override;
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+    void DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                  double aEndAngle ) override;
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override;
+    void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+    void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+    void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+    void DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                    const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint,
+                    double aFilterValue = 0.0 ) override;
+    void DrawBitmap( const BITMAP_BASE& aBitmap ) override;
+
+    // Text, stroke texts are recorded as the polylines of their glyphs
+    void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                     double aRotationAngle ) override;
+
+    // Transformation
+    void Transform( const MATRIX3x3D& aTransformation ) override;
+    void Rotate( double aAngle ) override;
+    void Translate( const VECTOR2D& aTranslation ) override;
+    void Scale( const VECTOR2D& aScale ) override;
+    void Save() override;
+    void Restore() override;
+
+private:
+    enum class COMMAND_TYPE
+    {
+        STATE,
+        LINE,
+        SEGMENT,
+        POLYLINE_DEQUE,
+        POLYLINE_ARRAY,
+        POLYLINE_CHAIN,
+        CIRCLE,
+        ARC,
+        ARC_SEGMENT,
+        RECTANGLE,
+        POLYGON_DEQUE,
+        POLYGON_ARRAY,
+        POLYGON_SET,
+        POLYGON_CHAIN,
+        CURVE,
+        BITMAP_TEXT,
+        TRANSFORM,
+        ROTATE,
+        TRANSLATE,
+        SCALE,
+        SAVE,
+        RESTORE
+    };
+
+    struct COMMAND
+    {
+        COMMAND_TYPE m_type;
+        int          m_index;       ///< first point, or entry of the storage of the type
+        int          m_count;       ///< number of points
+        double       m_args[4];
+    };
+
+    ///< Attributes set on the target GAL before drawing a primitive
+    struct STATE
+    {
+        bool    m_isFill;
+        bool    m_isStroke;
+        COLOR4D m_fillColor;
+        COLOR4D m_strokeColor;
+        float   m_lineWidth;
+        double  m_layerDepth;
+
+        bool operator==( const STATE& aOther ) const;
+    };
+
+    struct TEXT
+    {
+        wxString            m_text;
+        VECTOR2D            m_position;
+        double              m_rotationAngle;
+        VECTOR2D            m_glyphSize;
+        EDA_TEXT_HJUSTIFY_T m_horizontalJustify;
+        EDA_TEXT_VJUSTIFY_T m_verticalJustify;
+        bool                m_bold;
+        bool                m_italic;
+        bool                m_underlined;
+        bool                m_mirrored;
+    };
+
+    struct DRAWING
+    {
+        int  m_first;       ///< first command of the drawing
+        int  m_last;        ///< one past the last command of the drawing
+        bool m_complete;
+    };
+
+    ///< Record a command using the last \a aCount points of m_points.
+    COMMAND& addCommand( COMMAND_TYPE aType, int aCount = 0 );
+
+    ///< Record the attributes a primitive is drawn with, if they changed since the last one.
+    void syncState();
+
+    void addPoints( const VECTOR2D aPointList[], int aListSize );
+
+    void replayCommand( const COMMAND& aCommand, GAL* aTarget ) const;
+
+    bool                         m_isCairoEngine;
+    bool                         m_isOpenGlEngine;
+
+    std::vector<COMMAND>         m_commands;
+    std::vector<DRAWING>         m_drawings;
+
+    std::vector<VECTOR2D>        m_points;
+    std::vector<STATE>           m_states;
+    std::vector<TEXT>            m_texts;
+    std::vector<MATRIX3x3D>      m_matrices;
+
+    // Deques, as growing them doesn't copy the shapes already stored
+    std::deque<SHAPE_LINE_CHAIN> m_lineChains;
+    std::deque<SHAPE_POLY_SET>   m_polySets;
+
+    bool                         m_stateValid;      ///< m_lastState holds the target's state
+    STATE                        m_lastState;
+};
+
+} // namespace KIGFX
+
+#endif // GAL_DISPLAY_LIST_H_
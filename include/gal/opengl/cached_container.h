@@ -27,9 +27,9 @@
 #ifndef CACHED_CONTAINER_H_
 #define CACHED_CONTAINER_H_
 
+#include <gal/opengl/chunk_allocator.h>
 #include <gal/opengl/vertex_container.h>
 #include <map>
-#include <set>
 
 namespace KIGFX
 {
@@ -41,6 +41,11 @@ class SHADER;
  *
  * It associates VERTEX objects and with VERTEX_ITEMs. Caching vertices data in the memory and a
  * enables fast reuse of that data.
+ *
+ * Items are stored in chunks handed out by a CHUNK_ALLOCATOR.  When the free space gets
+ * scattered between the items, a few items at the end of the container are moved to the
+ * free chunks below them each time an item is finished, so the container is compacted
+ * a bit at a time instead of being defragmented all at once.
  */
 
 class CACHED_CONTAINER : public VERTEX_CONTAINER
@@ -78,6 +83,27 @@ public:
     ///< @copydoc VERTEX_CONTAINER::Clear()
     virtual void Clear() override;
 
+    /**
+     * Return the share of the free space scattered between the stored items, between 0 (all
+     * the free space is contiguous) and 1.
+     */
+    double GetFragmentation() const
+    {
+        return m_freeChunks.GetFragmentation();
+    }
+
+    ///< Return the number of times the whole container was defragmented.
+    unsigned int GetDefragmentationCount() const
+    {
+        return m_defragmentations;
+    }
+
+    ///< Return the number of vertices moved so far to compact the container.
+    unsigned int GetRelocatedVertices() const
+    {
+        return m_relocatedVertices;
+    }
+
     /**
      * Return handle to the vertex buffer. It might be negative if the buffer is not initialized.
      */
@@ -95,12 +121,8 @@ public:
     virtual void Unmap() override = 0;
 
 protected:
-    ///< Maps size of free memory chunks to their offsets
-    typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
-
-    /// List of all the stored items
-    typedef std::set<VERTEX_ITEM*> ITEMS;
+    /// All the stored items, by offset
+    typedef std::map<unsigned int, VERTEX_ITEM*> ITEMS;
 
     /**
      * Resize the chunk that stores the current item to the given size. The current item has
@@ -132,38 +154,24 @@ protected:
     void defragment( VERTEX* aTarget );
 
     /**
-     * Look for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
+     * Update the item index and the free space after all the items were packed at the
+     * beginning of a container of \a aNewSize vertices, in the order of m_items and followed
+     * by the current item (see defragment()).
      */
-    void mergeFreeChunks();
+    void finishDefragmentation( unsigned int aNewSize );
 
     /**
-     * Return the size of a chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline int getChunkSize( const CHUNK& aChunk ) const
-    {
-        return aChunk.first;
-    }
-
-    /**
-     * Return the offset of a chunk.
-     *
-     * @param aChunk is the chunk.
+     * Move the items at the end of the container to free chunks below them, until at most
+     * \a aBudget vertices have been moved or there is no room left for them below (see
+     * CHUNK_ALLOCATOR::Compact()).
      */
-    inline unsigned int getChunkOffset( const CHUNK& aChunk ) const
-    {
-        return aChunk.second;
-    }
+    void compact( unsigned int aBudget );
 
-    /**
-     * Add a chunk marked as a free space.
-     */
-    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+    ///< Return the size of the chunk reserved for \a aItem.
+    static unsigned int getChunkSize( const VERTEX_ITEM* aItem );
 
-    ///< Store size & offset of free chunks.
-    FREE_CHUNK_MAP  m_freeChunks;
+    ///< Free space of the container
+    CHUNK_ALLOCATOR m_freeChunks;
 
     ///< Stored VERTEX_ITEMs
     ITEMS m_items;
@@ -178,6 +186,10 @@ protected:
     ///< Maximal vertex index number stored in the container
     unsigned int m_maxIndex;
 
+    ///< Statistics
+    unsigned int m_defragmentations;
+    unsigned int m_relocatedVertices;
+
 private:
     /// Debug & test functions
     void showFreeChunks();
@@ -0,0 +1,142 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CHUNK_ALLOCATOR_H_
+#define CHUNK_ALLOCATOR_H_
+
+#include <functional>
+#include <map>
+#include <set>
+
+namespace KIGFX
+{
+
+/**
+ * Keep track of the free space of a vertex container, to hand out chunks of it.
+ *
+ * Chunk sizes are rounded up to size classes, four for each power of two, so a chunk freed by
+ * an item fits the next item of a similar size and items can grow a bit without being moved.
+ * The smallest chunk large enough is used (best fit), and freed chunks are merged with the
+ * free chunks next to them, so the free space doesn't crumble over time.
+ *
+ * Sizes and offsets are expressed in vertices, but the allocator doesn't store any vertex.
+ */
+class CHUNK_ALLOCATOR
+{
+public:
+    ///< Offset returned when there is no free chunk large enough
+    static constexpr unsigned int NO_SPACE = ~0u;
+
+    CHUNK_ALLOCATOR( unsigned int aSize = 0 );
+
+    /**
+     * Return the size of the chunk used to store \a aSize vertices.
+     */
+    static unsigned int SizeClass( unsigned int aSize );
+
+    /**
+     * Forget all the chunks, leaving \a aUsed vertices used at the beginning of a container of
+     * \a aSize vertices and the rest free.
+     */
+    void Reset( unsigned int aSize, unsigned int aUsed = 0 );
+
+    /**
+     * Take a chunk of SizeClass( \a aSize ) vertices from the free space.
+     *
+     * @param aSize is the number of vertices to store.
+     * @param aBelow if given, only chunks starting below this offset are used.
+     * @return the offset of the chunk, or NO_SPACE if there is no free chunk large enough.
+     */
+    unsigned int Allocate( unsigned int aSize, unsigned int aBelow = NO_SPACE );
+
+    /**
+     * Give a chunk back to the free space.
+     *
+     * @param aOffset is the offset of the chunk.
+     * @param aSize is the size of the chunk, as reserved (not the number of vertices stored).
+     */
+    void Free( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Move a chunk to a free chunk closer to the beginning of the container.
+     *
+     * @param aOffset is the offset of the chunk.
+     * @param aSize is the size of the chunk, as reserved.
+     * @return the new offset of the chunk, or NO_SPACE if there is no room for it below.
+     */
+    unsigned int Relocate( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Move the highest used chunks to free chunks closer to the beginning of the container, one
+     * at a time, until one doesn't fit below or would exceed \a aBudget.  Nothing is moved as
+     * long as less than an eighth of the container is scattered between used chunks.
+     *
+     * The allocator doesn't know the used chunks, so they are given by the callers:
+     *
+     * @param aBudget is the number of vertices which may be moved, counted in chunk sizes.
+     * @param aHighest gives the offset & size of the highest used chunk, or returns false if
+     *                 there is none.
+     * @param aMove moves the highest used chunk from its offset to a new offset.
+     * @return the number of vertices moved.
+     */
+    unsigned int Compact( unsigned int aBudget,
+                          const std::function<bool( unsigned int&, unsigned int& )>& aHighest,
+                          const std::function<void( unsigned int, unsigned int )>& aMove );
+
+    unsigned int GetSize() const { return m_size; }
+
+    unsigned int GetFreeSpace() const { return m_freeSpace; }
+
+    unsigned int GetFreeChunkCount() const { return m_byOffset.size(); }
+
+    unsigned int GetLargestFreeChunk() const
+    {
+        return m_bySize.empty() ? 0 : m_bySize.rbegin()->first;
+    }
+
+    /**
+     * Return the share of the free space which can't be used for the largest chunks, as it is
+     * scattered between used chunks: 0 when all the free space is contiguous.
+     */
+    double GetFragmentation() const;
+
+private:
+    ///< Size & offset of a free chunk
+    typedef std::pair<unsigned int, unsigned int> CHUNK;
+
+    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+    void removeFreeChunk( unsigned int aOffset, unsigned int aSize );
+
+    ///< Free chunks, by size and then offset, to find the best fit
+    std::set<CHUNK> m_bySize;
+
+    ///< Size of the free chunks, by offset, to find the neighbours of a chunk
+    std::map<unsigned int, unsigned int> m_byOffset;
+
+    unsigned int m_size;
+    unsigned int m_freeSpace;
+};
+
+} // namespace KIGFX
+
+#endif /* CHUNK_ALLOCATOR_H_ */
@@ -95,6 +95,30 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Create a painter drawing on another GAL with the same settings.
+     *
+     * Painters returning a copy can draw different items concurrently, each copy being used
+     * by a single thread.  Drawing an item must then only read the items, apart from caches
+     * belonging to the item being drawn.
+     *
+     * @param aGal is the GAL the copy draws on.
+     * @return a new painter owned by the caller, or nullptr if items can't be drawn concurrently.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Return false if drawing \a aItem reads caches of other items, which could be updated by
+     * another copy of the painter at the same time.  Such items are drawn on the GAL thread.
+     */
+    virtual bool CanDrawConcurrently( const VIEW_ITEM* aItem ) const
+    {
+        return true;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -0,0 +1,144 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file perf_counters.h
+ * @brief Named timers and counters which are always compiled in, unlike the PROF_COUNTERs
+ *        guarded by PROFILE, so that release builds can report where their time goes.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+
+/**
+ * Totals of an instrumented operation: how many times it ran, and how long it took in total
+ * and at worst.
+ *
+ * Counters are owned by PERF_COUNTERS and never destroyed, so references to them can be kept
+ * in static variables.  Recording a sample is thread safe and only costs a few atomic
+ * operations.
+ */
+class PERF_COUNTER
+{
+public:
+    PERF_COUNTER( const std::string& aName ) :
+            m_name( aName ),
+            m_count( 0 ),
+            m_totalNs( 0 ),
+            m_maxNs( 0 )
+    {}
+
+    const std::string& GetName() const { return m_name; }
+
+    /**
+     * Record one run of the operation.
+     */
+    void AddSample( std::chrono::nanoseconds aDuration );
+
+    /**
+     * Count events without timing them (e.g. the number of items processed).
+     */
+    void Increment( uint64_t aCount = 1 ) { m_count += aCount; }
+
+    uint64_t GetCount() const { return m_count; }
+
+    double GetTotalMs() const { return m_totalNs / 1e6; }
+
+    double GetMaxMs() const { return m_maxNs / 1e6; }
+
+    void Reset();
+
+    /**
+     * Print the totals to a stream, in the format of PROF_COUNTER::Show().
+     */
+    void Show( std::ostream& aStream = std::cerr ) const;
+
+private:
+    std::string           m_name;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_totalNs;
+    std::atomic<uint64_t> m_maxNs;
+};
+
+
+/**
+ * The registry of all the PERF_COUNTERs of the application.
+ *
+ * Names are dotted paths, starting with the subsystem (e.g. "connectivity.build").
+ */
+class PERF_COUNTERS
+{
+public:
+    /**
+     * Return the counter named \a aName, creating it on first use.
+     */
+    static PERF_COUNTER& Get( const std::string& aName );
+
+    /**
+     * Return all the counters, sorted by name.
+     */
+    static std::vector<const PERF_COUNTER*> GetAll();
+
+    static void ResetAll();
+
+    /**
+     * Return the counters as a JSON object, suitable to attach to a bug report:
+     * { "counters": [ { "name": ..., "count": ..., "total_ms": ..., "max_ms": ... }, ... ] }
+     */
+    static std::string ToJson();
+};
+
+
+/**
+ * Time the enclosing scope with a PROF_COUNTER and add the result to a PERF_COUNTER.
+ *
+ *     static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.build" );
+ *     SCOPED_PERF_TIMER timer( counter );
+ */
+class SCOPED_PERF_TIMER
+{
+public:
+    SCOPED_PERF_TIMER( PERF_COUNTER& aCounter ) :
+            m_counter( aCounter )
+    {}
+
+    ~SCOPED_PERF_TIMER()
+    {
+        m_counter.AddSample( m_timer.SinceStart<std::chrono::nanoseconds>() );
+    }
+
+private:
+    PERF_COUNTER& m_counter;
+    PROF_COUNTER  m_timer;
+};
+
+#endif // PERF_COUNTERS_H
@@ -194,6 +194,15 @@ public:
     bool IsPrinting() const { return m_isPrinting; }
     void SetIsPrinting( bool isPrinting ) { m_isPrinting = isPrinting; }
 
+    /**
+     * Set the level of detail items are drawn with: 0 for the full geometry, and simplified
+     * shapes for items too small on screen to show their details, coarser as the level increases.
+     *
+     * @see VIEW_ITEM::ViewGetCoarseLOD()
+     */
+    void SetDetailLevel( int aLevel ) { m_detailLevel = aLevel; }
+    int GetDetailLevel() const { return m_detailLevel; }
+
     /**
      * Return current background color settings.
      */
@@ -296,6 +305,7 @@ protected:
                                           // lines.  This sets an absolute minimum.
     bool          m_showPageLimits;
     bool          m_isPrinting;
+    int           m_detailLevel;          // 0 for full geometry, coarser shapes above
 
     wxDC*         m_printDC;              // This can go away once the worksheet is moved to
                                           // Cairo-based printing.
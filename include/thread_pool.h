@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A fixed set of worker threads running tasks from a shared queue.
+ *
+ * Unlike std::async( std::launch::async, ... ), submitting a task doesn't start a new
+ * thread, which matters for the small and frequent batches of work done while editing.
+ *
+ * Tasks must not wait for other tasks of the same pool, as all the workers could end up
+ * waiting for tasks which no worker is left to run.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @param aThreadCount is the number of worker threads, at least one.
+     */
+    THREAD_POOL( size_t aThreadCount = std::thread::hardware_concurrency() );
+
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * Return the pool shared by the whole application, with one worker per hardware thread.
+     */
+    static THREAD_POOL& Instance();
+
+    /**
+     * Stop the workers of the shared pool, once they have run the queued tasks.
+     *
+     * The shared pool is not destroyed with the static objects: joining threads then can
+     * deadlock, for instance under the Windows loader lock while DLLs are unloaded.  This is
+     * called by PGM_BASE::Destroy() instead, and is safe to call more than once.
+     */
+    static void Shutdown();
+
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+    /**
+     * Return true when called from one of the workers of this pool, which then must not
+     * wait for other tasks of the pool.
+     */
+    bool IsWorkerThread() const;
+
+    /**
+     * Queue \a aTask to be run by one of the workers.
+     *
+     * @return a future holding the result of the task (or the exception it threw).
+     */
+    template <typename Func>
+    std::future<typename std::result_of<Func()>::type> Submit( Func&& aTask )
+    {
+        using RESULT = typename std::result_of<Func()>::type;
+
+        auto task = std::make_shared<std::packaged_task<RESULT()>>( std::forward<Func>( aTask ) );
+        std::future<RESULT> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            m_queue.emplace_back( [task]() { ( *task )(); } );
+        }
+
+        m_wakeUp.notify_one();
+
+        return result;
+    }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread>           m_workers;
+    std::deque<std::function<void()>>  m_queue;
+    std::mutex                         m_lock;
+    std::condition_variable            m_wakeUp;
+    bool                               m_stopping;
+};
+
+#endif // THREAD_POOL_H
@@ -43,6 +43,7 @@ namespace KIGFX
 {
 class PAINTER;
 class GAL;
+class GAL_DISPLAY_LIST;
 class VIEW_ITEM;
 class VIEW_GROUP;
 class VIEW_RTREE;
@@ -554,6 +555,15 @@ public:
         return false;
     }
 
+    /**
+     * Return true if the last Redraw() drew items whose coarse geometry wasn't cached yet.
+     * It is cached by the next UpdateItems(), so another frame is needed to show it.
+     */
+    bool IsCoarseGeometryPending() const
+    {
+        return m_coarseGeometryPending;
+    }
+
     /**
      * Return true if any of layers belonging to the target or the target itself should be
      * redrawn.
@@ -699,6 +709,9 @@ public:
 
     static constexpr int VIEW_MAX_LAYERS = 512;  ///< maximum number of layers that may be shown
 
+    ///< Maximum number of levels of detail items are cached with, including the full geometry
+    static constexpr int VIEW_MAX_DETAIL_LEVELS = 4;
+
 protected:
     struct VIEW_LAYER
     {
@@ -712,6 +725,14 @@ protected:
                                                  ///< the layer.
     };
 
+    ///< A layer of an item whose geometry has to be cached at a level of detail
+    struct GEOMETRY_UPDATE
+    {
+        VIEW_ITEM* m_item;
+        int        m_layer;
+        int        m_level;
+    };
+
 
 
     VIEW( const VIEW& ) = delete;
@@ -768,14 +789,28 @@ protected:
      *
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aGeometryUpdates if not null, receives the layers of the item whose geometry has
+     *                         to be updated, instead of updating them immediately.
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<GEOMETRY_UPDATE>* aGeometryUpdates = nullptr );
 
     ///< Update colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
 
-    ///< Update all information needed to draw an item
-    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
+    ///< Update all information needed to draw an item at the level of detail \a aLevel.  The
+    ///< drawing \a aDrawing of \a aRecording is replayed if given, instead of drawing the item
+    ///< with the painter.
+    void updateItemGeometry( VIEW_ITEM* aItem, int aLayer, int aLevel = 0,
+                             const GAL_DISPLAY_LIST* aRecording = nullptr, int aDrawing = -1 );
+
+    ///< Return the level of detail an item is drawn with on a layer at the current scale, 0 for
+    ///< the full geometry.  @see VIEW_ITEM::ViewGetCoarseLOD
+    int getDetailLevel( const VIEW_ITEM* aItem, int aLayer ) const;
+
+    ///< Update the geometry of a list of item layers, with all the layers of an item next to
+    ///< each other.  Items are painted on the thread pool if there are enough of them.
+    void updateItemsGeometry( const std::vector<GEOMETRY_UPDATE>& aUpdates );
 
     ///< Update bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
@@ -863,6 +898,9 @@ protected:
     ///< Flag to reverse the draw order when using draw priority.
     bool m_reverseDrawOrder;
 
+    ///< Coarse geometry was missing when drawing, it is cached by the next update.
+    bool m_coarseGeometryPending;
+
     ///< A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     ///< m_printMode > 0 is a printing mode (currently means "we are in printing mode").
     int m_printMode;
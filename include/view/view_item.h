@@ -55,6 +55,7 @@ enum VIEW_UPDATE_FLAGS {
     LAYERS      = 0x08,     ///< Layers have changed.
     INITIAL_ADD = 0x10,     ///< Item is being added to the view.
     REPAINT     = 0x20,     ///< Item needs to be redrawn.
+    COARSE      = 0x40,     ///< Coarse geometry of the item needs to be cached.
     ALL         = 0xef      ///< All except INITIAL_ADD.
 };
 
@@ -140,6 +141,36 @@ public:
         return 0.0;
     }
 
+    /**
+     * Return the level of detail below which the item is drawn with coarse geometry.
+     *
+     * Items too small on screen for their details to be seen can be drawn with simplified
+     * shapes (see RENDER_SETTINGS::GetDetailLevel()), which are cached separately from the
+     * full geometry, so zooming in and out doesn't require repainting the item.  Below the
+     * returned scale the item is drawn with detail level 1, and each time the scale is divided
+     * by 4 the level increases, up to ViewGetCoarseLevels().  Items are always printed with
+     * the full geometry.
+     *
+     * @param aLayer is the current drawing layer.
+     * @param aView is a pointer to the #VIEW device we are drawing on.
+     * @return the #VIEW scale below which the coarse geometry is drawn.  0 always draws the full
+     *         geometry.
+     */
+    virtual double ViewGetCoarseLOD( int aLayer, VIEW* aView ) const
+    {
+        // By default items have no coarse geometry
+        return 0.0;
+    }
+
+    /**
+     * Return the number of coarse geometry levels of the item, for items whose shapes can be
+     * simplified further as they get smaller on screen.
+     */
+    virtual int ViewGetCoarseLevels( int aLayer ) const
+    {
+        return 1;
+    }
+
     VIEW_ITEM_DATA* viewPrivData() const
     {
         return m_viewPrivData;
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_BOOLEAN_PIPELINE_H
+#define __POLY_BOOLEAN_PIPELINE_H
+
+#include <clipper.hpp>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Run a sequence of boolean and offset operations on a polygon set while keeping the
+ * intermediate results in Clipper's representation.
+ *
+ * Each SHAPE_POLY_SET boolean converts both operands to Clipper paths, runs Clipper and
+ * converts the result back.  When a caller chains many such operations (zone fills, 3D layer
+ * construction) most of that work is wasted.  The pipeline converts its operands once, and
+ * queues consecutive unions (or consecutive subtractions) so that they are resolved by a
+ * single Clipper run: A - B - C - D is evaluated as A - ( B | C | D ).
+ *
+ * Intersections and offsets cannot be batched and flush the queue.  The result is converted
+ * back to a SHAPE_POLY_SET only by Commit().
+ */
+class POLY_BOOLEAN_PIPELINE
+{
+public:
+    POLY_BOOLEAN_PIPELINE( SHAPE_POLY_SET::POLYGON_MODE aFastMode = SHAPE_POLY_SET::PM_FAST );
+
+    POLY_BOOLEAN_PIPELINE( const SHAPE_POLY_SET& aSubject,
+                           SHAPE_POLY_SET::POLYGON_MODE aFastMode = SHAPE_POLY_SET::PM_FAST );
+
+    ///< Queue a union with \a aOther.
+    void Add( const SHAPE_POLY_SET& aOther );
+
+    ///< Queue a union with a single closed outline.
+    void Add( const SHAPE_LINE_CHAIN& aOutline );
+
+    ///< Queue a subtraction of \a aOther.
+    void Subtract( const SHAPE_POLY_SET& aOther );
+
+    ///< Queue a subtraction of a single closed outline.
+    void Subtract( const SHAPE_LINE_CHAIN& aOutline );
+
+    ///< Intersect the current result with \a aOther.
+    void Intersect( const SHAPE_POLY_SET& aOther );
+
+    /**
+     * Inflate (or deflate, for a negative \a aAmount) the current result.
+     *
+     * @see SHAPE_POLY_SET::Inflate() for the meaning of the parameters.
+     */
+    void Inflate( int aAmount, int aCircleSegmentsCount,
+                  SHAPE_POLY_SET::CORNER_STRATEGY aCornerStrategy =
+                          SHAPE_POLY_SET::ROUND_ALL_CORNERS );
+
+    void Deflate( int aAmount, int aCircleSegmentsCount,
+                  SHAPE_POLY_SET::CORNER_STRATEGY aCornerStrategy =
+                          SHAPE_POLY_SET::ROUND_ALL_CORNERS )
+    {
+        Inflate( -aAmount, aCircleSegmentsCount, aCornerStrategy );
+    }
+
+    /**
+     * Resolve all queued operations and store the result (outlines with holes) in \a aResult.
+     *
+     * The pipeline is left empty; construct a new one from \a aResult to continue.
+     */
+    void Commit( SHAPE_POLY_SET& aResult );
+
+    ///< @return the number of Clipper executions run so far (for tests and profiling).
+    int ExecutionCount() const { return m_executionCount; }
+
+private:
+    void queue( ClipperLib::ClipType aType, const SHAPE_POLY_SET& aOther );
+
+    void queue( ClipperLib::ClipType aType, const SHAPE_LINE_CHAIN& aOutline );
+
+    ///< Run the queued operation (if any), leaving its result in m_subject.
+    void flush();
+
+    ///< Set up a Clipper instance to run the queued operation against m_subject.
+    void prepare( ClipperLib::Clipper& aClipper ) const;
+
+    SHAPE_POLY_SET::POLYGON_MODE m_fastMode;
+
+    ClipperLib::Paths            m_subject;     ///< current result, oriented outlines and holes
+    ClipperLib::Paths            m_pending;     ///< clip paths of the queued operation
+    ClipperLib::ClipType         m_pendingOp;
+    bool                         m_hasPending;
+
+    int                          m_executionCount;
+};
+
+#endif // __POLY_BOOLEAN_PIPELINE_H
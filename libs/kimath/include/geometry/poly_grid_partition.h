@@ -27,6 +27,7 @@
 
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <set>
 #include <unordered_map>
@@ -67,7 +68,37 @@ public:
         build( aPolyOutline, gridSize );
     }
 
-    int ContainsPoint( const VECTOR2I& aP, int aClearance = 0 )    // const
+    /**
+     * Partition \a aPolyOutline with a grid sized after its vertex count.
+     */
+    POLY_GRID_PARTITION( const SHAPE_LINE_CHAIN& aPolyOutline )
+    {
+        build( aPolyOutline, GridSizeForVertexCount( aPolyOutline.PointCount() ) );
+    }
+
+    /**
+     * Return a grid size keeping the number of edges per cell low for an outline of
+     * \a aVertexCount vertices.
+     *
+     * The edges of an outline only cross a band of cells along its perimeter, so the grid
+     * grows with the square root of the vertex count rather than the vertex count itself.
+     */
+    static int GridSizeForVertexCount( int aVertexCount )
+    {
+        const int minGridSize = 16;
+        const int maxGridSize = 256;
+
+        int gridSize = 2 * (int) std::sqrt( (double) std::max( aVertexCount, 0 ) );
+
+        return std::min( std::max( gridSize, minGridSize ), maxGridSize );
+    }
+
+    int GetGridSize() const
+    {
+        return m_gridSize;
+    }
+
+    int ContainsPoint( const VECTOR2I& aP, int aClearance = 0 ) const
     {
         if( containsPoint(aP) )
             return 1;
@@ -78,6 +109,45 @@ public:
         return 0;
     }
 
+    /**
+     * Test a set of points at once.
+     *
+     * Points outside of the bounding box (grown by \a aClearance) are discarded up front, and
+     * the more expensive clearance test is only run once no point was found inside the outline.
+     *
+     * @return true if any point of \a aPoints is inside the outline or within \a aClearance
+     *         of it.
+     */
+    bool ContainsAnyPoint( const std::vector<VECTOR2I>& aPoints, int aClearance = 0 ) const
+    {
+        BOX2I bbox = m_bbox;
+        bbox.Inflate( std::max( aClearance, 0 ) );
+
+        bool candidates = false;
+
+        for( const VECTOR2I& p : aPoints )
+        {
+            if( !bbox.Contains( p ) )
+                continue;
+
+            if( containsPoint( p ) )
+                return true;
+
+            candidates = true;
+        }
+
+        if( !candidates || aClearance <= 0 )
+            return false;
+
+        for( const VECTOR2I& p : aPoints )
+        {
+            if( bbox.Contains( p ) && checkClearance( p, aClearance ) )
+                return true;
+        }
+
+        return false;
+    }
+
     const BOX2I& BBox() const
     {
         return m_bbox;
@@ -90,8 +160,6 @@ private:
         TRAIL_EDGE = 2,
     };
 
-    using EDGE_LIST = std::vector<int>;
-
     template <class T>
     inline void hash_combine( std::size_t& seed, const T& v )
     {
@@ -123,9 +191,8 @@ private:
             return 0;
 
         SCAN_STATE state;
-        const EDGE_LIST& cell = m_grid[ m_gridSize * gridPoint.y + gridPoint.x ];
 
-        scanCell( state, cell, aP, gridPoint.x, gridPoint.y );
+        scanCell( state, m_gridSize * gridPoint.y + gridPoint.x, aP, gridPoint.x, gridPoint.y );
 
         if( state.nearest < 0 )
         {
@@ -138,8 +205,7 @@ private:
 
                 if( xl >= 0 )
                 {
-                    const EDGE_LIST& cell2 = m_grid[ m_gridSize * gridPoint.y + xl ];
-                    scanCell( state, cell2, aP, xl, gridPoint.y );
+                    scanCell( state, m_gridSize * gridPoint.y + xl, aP, xl, gridPoint.y );
 
                     if( state.nearest >= 0 )
                         break;
@@ -147,8 +213,7 @@ private:
 
                 if( xh < m_gridSize )
                 {
-                    const EDGE_LIST& cell2 = m_grid[ m_gridSize * gridPoint.y + xh ];
-                    scanCell( state, cell2, aP, xh, gridPoint.y );
+                    scanCell( state, m_gridSize * gridPoint.y + xh, aP, xh, gridPoint.y );
 
                     if( state.nearest >= 0 )
                         break;
@@ -190,7 +255,7 @@ private:
         }
     }
 
-    bool checkClearance( const VECTOR2I& aP, int aClearance )
+    bool checkClearance( const VECTOR2I& aP, int aClearance ) const
     {
         int gx0 = poly2gridX( aP.x - aClearance - 1);
         int gx1 = poly2gridX( aP.x + aClearance + 1);
@@ -205,10 +270,11 @@ private:
         {
             for ( int gy = gy0; gy <= gy1; gy++ )
             {
-                const auto& cell = m_grid [ m_gridSize * gy + gx];
-                for ( auto index : cell )
+                int cell = m_gridSize * gy + gx;
+
+                for( int ii = m_cellStart[cell]; ii < m_cellStart[cell + 1]; ii++ )
                 {
-                    const auto& seg = m_outline.Segment( index );
+                    const SEG& seg = m_outline.CSegment( m_cellEdges[ii] );
 
                     if ( seg.SquaredDistance(aP) <= dist )
                         return true;
@@ -309,16 +375,6 @@ private:
 
         m_outline.SetClosed( true );
 
-        m_grid.reserve( gridSize * gridSize );
-
-        for( int y = 0; y < gridSize; y++ )
-        {
-            for( int x = 0; x < gridSize; x++ )
-            {
-                m_grid.emplace_back( );
-            }
-        }
-
         VECTOR2I    ref_v( 0, 1 );
         VECTOR2I    ref_h( 0, 1 );
 
@@ -326,6 +382,13 @@ private:
 
         std::unordered_map<SEG, int, segHash, segsEqual> edgeSet;
 
+        // (cell, edge) pairs, bucketed into m_cellStart/m_cellEdges once all edges are known
+        std::vector<std::pair<int, int>> cellEdges;
+        std::vector<int>                 indices;
+
+        edgeSet.reserve( m_outline.SegmentCount() );
+        cellEdges.reserve( 4 * m_outline.SegmentCount() );
+
         for( int i = 0; i<m_outline.SegmentCount(); i++ )
         {
             SEG edge = m_outline.Segment( i );
@@ -369,10 +432,10 @@ private:
             if( edge.A.y == edge.B.y )
                 continue;
 
-            std::set<int> indices;
+            indices.clear();
 
-            indices.insert( m_gridSize * poly2gridY( edge.A.y ) + poly2gridX( edge.A.x ) );
-            indices.insert( m_gridSize * poly2gridY( edge.B.y ) + poly2gridX( edge.B.x ) );
+            indices.push_back( m_gridSize * poly2gridY( edge.A.y ) + poly2gridX( edge.A.x ) );
+            indices.push_back( m_gridSize * poly2gridY( edge.B.y ) + poly2gridX( edge.B.x ) );
 
             if( edge.A.x > edge.B.x )
                 std::swap( edge.A, edge.B );
@@ -390,9 +453,9 @@ private:
                     int py  = ( edge.A.y + rescale_trunc( dir.y, px - edge.A.x, dir.x ) );
                     int yy  = poly2gridY( py );
 
-                    indices.insert( m_gridSize * yy + x );
+                    indices.push_back( m_gridSize * yy + x );
  					if( x > 0 )
-                        indices.insert( m_gridSize * yy + x - 1 );
+                        indices.push_back( m_gridSize * yy + x - 1 );
 
                 }
             }
@@ -413,16 +476,34 @@ private:
                     int px  = ( edge.A.x + rescale_trunc( dir.x, py - edge.A.y, dir.y ) );
                     int xx  = poly2gridX( px );
 
-                    indices.insert( m_gridSize * y + xx );
+                    indices.push_back( m_gridSize * y + xx );
        				if( y > 0 )
-                        indices.insert( m_gridSize * (y - 1) + xx );
+                        indices.push_back( m_gridSize * (y - 1) + xx );
                 }
             }
 
-            for( auto idx : indices )
-                m_grid[idx].push_back( i );
+            std::sort( indices.begin(), indices.end() );
+            indices.erase( std::unique( indices.begin(), indices.end() ), indices.end() );
+
+            for( int idx : indices )
+                cellEdges.emplace_back( idx, i );
         }
 
+        // Counting sort of the edges by cell, keeping the edge order within each cell
+        m_cellStart.assign( m_gridSize * m_gridSize + 1, 0 );
+
+        for( const std::pair<int, int>& cellEdge : cellEdges )
+            m_cellStart[cellEdge.first + 1]++;
+
+        for( size_t ii = 1; ii < m_cellStart.size(); ii++ )
+            m_cellStart[ii] += m_cellStart[ii - 1];
+
+        std::vector<int> fill( m_cellStart.begin(), m_cellStart.end() - 1 );
+
+        m_cellEdges.resize( cellEdges.size() );
+
+        for( const std::pair<int, int>& cellEdge : cellEdges )
+            m_cellEdges[ fill[cellEdge.first]++ ] = cellEdge.second;
     }
 
 
@@ -452,7 +533,7 @@ private:
         int nearest;
     };
 
-    void scanCell( SCAN_STATE& state, const EDGE_LIST& cell, const VECTOR2I& aP, int cx, int cy  ) const
+    void scanCell( SCAN_STATE& state, int cell, const VECTOR2I& aP, int cx, int cy  ) const
     {
         int cx0 = grid2polyX(cx);
         int cx1 = grid2polyX(cx + 1);
@@ -461,8 +542,9 @@ private:
         printf("Scan %d %d\n", cx, cy );
         #endif
 
-        for( auto index : cell )
+        for( int ii = m_cellStart[cell]; ii < m_cellStart[cell + 1]; ii++ )
         {
+            int        index = m_cellEdges[ii];
             const SEG& edge = m_outline.CSegment( index );
 
 
@@ -544,7 +626,10 @@ private:
     SHAPE_LINE_CHAIN       m_outline;
     BOX2I                  m_bbox;
     std::vector<int>       m_flags;
-    std::vector<EDGE_LIST> m_grid;
+
+    ///< Edges touching each cell: m_cellEdges[m_cellStart[cell]] to m_cellEdges[m_cellStart[cell + 1] - 1]
+    std::vector<int>       m_cellStart;
+    std::vector<int>       m_cellEdges;
 };
 
 #endif
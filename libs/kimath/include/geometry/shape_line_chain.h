@@ -116,6 +116,8 @@ public:
               m_bbox( aShape.m_bbox )
     {}
 
+    SHAPE_LINE_CHAIN( SHAPE_LINE_CHAIN&& aShape ) = default;
+
     SHAPE_LINE_CHAIN( const std::vector<int>& aV);
 
     SHAPE_LINE_CHAIN( const std::vector<wxPoint>& aV, bool aClosed = false )
@@ -125,15 +127,12 @@ public:
 
         for( auto pt : aV )
             m_points.emplace_back( pt.x, pt.y );
-
-        m_shapes = std::vector<ssize_t>( aV.size(), ssize_t( SHAPE_IS_PT ) );
     }
 
     SHAPE_LINE_CHAIN( const std::vector<VECTOR2I>& aV, bool aClosed = false )
             : SHAPE_LINE_CHAIN_BASE( SH_LINE_CHAIN ), m_closed( aClosed ), m_width( 0 )
     {
         m_points = aV;
-        m_shapes = std::vector<ssize_t>( aV.size(), ssize_t( SHAPE_IS_PT ) );
     }
 
     SHAPE_LINE_CHAIN( const SHAPE_ARC& aArc, bool aClosed = false )
@@ -152,7 +151,6 @@ public:
         m_width( 0 )
     {
         m_points.reserve( aPath.size() );
-        m_shapes = std::vector<ssize_t>( aPath.size(), ssize_t( SHAPE_IS_PT ) );
 
         for( const auto& point : aPath )
             m_points.emplace_back( point.X, point.Y );
@@ -162,6 +160,7 @@ public:
     {}
 
     SHAPE_LINE_CHAIN& operator=(const SHAPE_LINE_CHAIN&) = default;
+    SHAPE_LINE_CHAIN& operator=( SHAPE_LINE_CHAIN&& ) = default;
 
     SHAPE* Clone() const override;
 
@@ -318,7 +317,7 @@ public:
 
         m_points[aIndex] = aPos;
 
-        if( m_shapes[aIndex] != SHAPE_IS_PT )
+        if( ArcIndex( aIndex ) != SHAPE_IS_PT )
             convertArc( m_shapes[aIndex] );
     }
 
@@ -361,10 +360,17 @@ public:
     }
 
     /**
-     * @return the vector of values indicating shape type and location
+     * @return the vector of values indicating shape type and location, one per point.
+     *
+     * Chains without arcs don't store this vector, so it is returned by value: a const chain
+     * may be read from several threads.  Prefer ArcIndex() for random access, which never
+     * allocates.
      */
-    const std::vector<ssize_t>& CShapes() const
+    std::vector<ssize_t> CShapes() const
     {
+        if( m_shapes.size() != m_points.size() )
+            return std::vector<ssize_t>( m_points.size(), ssize_t( SHAPE_IS_PT ) );
+
         return m_shapes;
     }
 
@@ -451,7 +457,10 @@ public:
         if( m_points.size() == 0 || aAllowDuplication || CPoint( -1 ) != aP )
         {
             m_points.push_back( aP );
-            m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
+
+            if( !m_shapes.empty() )
+                m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
+
             m_bbox.Merge( aP );
         }
     }
@@ -656,9 +665,11 @@ public:
      * @param aP is the point to find
      * @param aAllowInternalShapePoints if false will not return points internal to an arc (i.e.
      *                                  only the arc endpoints are possible candidates)
+     * @param aSegment if not null, receives the index of the segment the nearest point is on.
      * @return the nearest point.
      */
-    const VECTOR2I NearestPoint( const VECTOR2I& aP, bool aAllowInternalShapePoints = true ) const;
+    const VECTOR2I NearestPoint( const VECTOR2I& aP, bool aAllowInternalShapePoints = true,
+                                 int* aSegment = nullptr ) const;
 
     /**
      * Finds a point on the line chain that is closest to the line defined by the points of
@@ -750,7 +761,7 @@ public:
          * but without a shared vertex.  Here there is a segment between the end of the first arc
          * and the start of the second arc.
          */
-        return ( aSegment < m_shapes.size() - 1
+        return ( aSegment + 1 < m_shapes.size()
                  && m_shapes[aSegment] != SHAPE_IS_PT
                  && m_shapes[aSegment] == m_shapes[aSegment + 1] );
     }
@@ -764,6 +775,15 @@ private:
 
     constexpr static ssize_t SHAPE_IS_PT = -1;
 
+    /**
+     * Make sure m_shapes has an entry for every point, before storing arc references in it.
+     */
+    void requireShapes()
+    {
+        if( m_shapes.size() != m_points.size() )
+            m_shapes.assign( m_points.size(), ssize_t( SHAPE_IS_PT ) );
+    }
+
     /// array of vertices
     std::vector<VECTOR2I> m_points;
 
@@ -771,6 +791,9 @@ private:
      * Array of indices that refer to the index of the shape if the point is part of a larger
      * shape, e.g. arc or spline.
      * If the value is -1, the point is just a point.
+     *
+     * Most chains have no arcs, so the array is left empty until an arc is added (see
+     * requireShapes()); an empty array means every point is just a point.
      */
     std::vector<ssize_t> m_shapes;
 
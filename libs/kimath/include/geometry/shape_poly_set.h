@@ -1264,6 +1264,18 @@ public:
      */
     SHAPE_POLY_SET Fillet( int aRadius, int aErrorMax );
 
+    /**
+     * Return a copy of the set keeping only the points of its contours at least \a aTolerance
+     * away from the previous point kept.
+     *
+     * Contours left with less than 3 points are dropped, along with the holes of a dropped
+     * outline.
+     *
+     * @param aTolerance is the minimum distance between two consecutive points.
+     * @return A set containing the decimated version of this set.
+     */
+    SHAPE_POLY_SET Decimated( int aTolerance ) const;
+
     /**
      * Compute the minimum distance between the \a aIndex-th polygon and \a aPoint.
      *
@@ -1326,10 +1338,20 @@ public:
     bool IsVertexInHole( int aGlobalIdx );
 
 private:
+    friend class POLY_BOOLEAN_PIPELINE;
+
     void fractureSingle( POLYGON& paths );
     void unfractureSingle ( POLYGON& path );
     void importTree( ClipperLib::PolyTree* tree );
 
+    /**
+     * Add \a aPaths to \a aOffset and set up its join type, miter limit and arc tolerance
+     * for an inflation by \a aAmount.  See Inflate() for the meaning of the parameters.
+     */
+    static void prepareOffset( ClipperLib::ClipperOffset& aOffset, const ClipperLib::Paths& aPaths,
+                               int aAmount, int aCircleSegmentsCount,
+                               CORNER_STRATEGY aCornerStrategy );
+
     /**
      * This is the engine to execute all polygon boolean transforms (AND, OR, ... and polygon
      * simplification (merging overlapping  polygons).
@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/poly_boolean_pipeline.h>
+
+using namespace ClipperLib;
+
+
+static void appendPaths( Paths& aPaths, const SHAPE_POLY_SET& aSet )
+{
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSet.CPolygon( ii );
+
+        for( size_t jj = 0; jj < poly.size(); jj++ )
+            aPaths.push_back( poly[jj].convertToClipper( jj == 0 ) );
+    }
+}
+
+
+POLY_BOOLEAN_PIPELINE::POLY_BOOLEAN_PIPELINE( SHAPE_POLY_SET::POLYGON_MODE aFastMode ) :
+        m_fastMode( aFastMode ),
+        m_pendingOp( ctUnion ),
+        m_hasPending( false ),
+        m_executionCount( 0 )
+{
+}
+
+
+POLY_BOOLEAN_PIPELINE::POLY_BOOLEAN_PIPELINE( const SHAPE_POLY_SET& aSubject,
+                                              SHAPE_POLY_SET::POLYGON_MODE aFastMode ) :
+        POLY_BOOLEAN_PIPELINE( aFastMode )
+{
+    appendPaths( m_subject, aSubject );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Add( const SHAPE_POLY_SET& aOther )
+{
+    queue( ctUnion, aOther );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Add( const SHAPE_LINE_CHAIN& aOutline )
+{
+    queue( ctUnion, aOutline );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Subtract( const SHAPE_POLY_SET& aOther )
+{
+    queue( ctDifference, aOther );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Subtract( const SHAPE_LINE_CHAIN& aOutline )
+{
+    queue( ctDifference, aOutline );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Intersect( const SHAPE_POLY_SET& aOther )
+{
+    queue( ctIntersection, aOther );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Inflate( int aAmount, int aCircleSegmentsCount,
+                                     SHAPE_POLY_SET::CORNER_STRATEGY aCornerStrategy )
+{
+    flush();
+
+    ClipperOffset c;
+    Paths         solution;
+
+    SHAPE_POLY_SET::prepareOffset( c, m_subject, aAmount, aCircleSegmentsCount,
+                                   aCornerStrategy );
+    c.Execute( solution, aAmount );
+    m_executionCount++;
+
+    m_subject.swap( solution );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::Commit( SHAPE_POLY_SET& aResult )
+{
+    // The last operation is executed straight into a PolyTree so that it doubles as the
+    // conversion back to outlines with holes.  With nothing queued a plain union does the job.
+    Clipper  c;
+    PolyTree solution;
+
+    if( m_hasPending )
+    {
+        prepare( c );
+        c.Execute( m_pendingOp, solution, pftNonZero, pftNonZero );
+        m_hasPending = false;
+        m_pending.clear();
+    }
+    else
+    {
+        c.StrictlySimple( m_fastMode == SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        c.AddPaths( m_subject, ptSubject, true );
+        c.Execute( ctUnion, solution, pftNonZero, pftNonZero );
+    }
+
+    m_executionCount++;
+
+    aResult.importTree( &solution );
+    m_subject.clear();
+}
+
+
+void POLY_BOOLEAN_PIPELINE::queue( ClipType aType, const SHAPE_POLY_SET& aOther )
+{
+    // Unions and differences batch with operations of the same type; intersections don't
+    // (A & B & C is not A & ( B | C )).
+    if( m_hasPending && ( m_pendingOp != aType || aType == ctIntersection ) )
+        flush();
+
+    m_pendingOp = aType;
+    m_hasPending = true;
+    appendPaths( m_pending, aOther );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::queue( ClipType aType, const SHAPE_LINE_CHAIN& aOutline )
+{
+    if( m_hasPending && ( m_pendingOp != aType || aType == ctIntersection ) )
+        flush();
+
+    m_pendingOp = aType;
+    m_hasPending = true;
+    m_pending.push_back( aOutline.convertToClipper( true ) );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::prepare( Clipper& aClipper ) const
+{
+    aClipper.StrictlySimple( m_fastMode == SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    aClipper.AddPaths( m_subject, ptSubject, true );
+    aClipper.AddPaths( m_pending, ptClip, true );
+}
+
+
+void POLY_BOOLEAN_PIPELINE::flush()
+{
+    if( !m_hasPending )
+        return;
+
+    Clipper c;
+    Paths   solution;
+
+    prepare( c );
+    c.Execute( m_pendingOp, solution, pftNonZero, pftNonZero );
+    m_executionCount++;
+
+    m_subject.swap( solution );
+    m_pending.clear();
+    m_hasPending = false;
+}
@@ -82,6 +82,9 @@ void SHAPE_LINE_CHAIN::convertArc( ssize_t aArcIndex )
     }
 
     m_arcs.erase( m_arcs.begin() + aArcIndex );
+
+    if( m_arcs.empty() )
+        m_shapes.clear();
 }
 
 
@@ -269,8 +272,8 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I&
     // N.B. This works because convertArc changes m_shapes on the first run
     for( int ind = aStartIndex; ind <= aEndIndex; ind++ )
     {
-        if( m_shapes[ind] != SHAPE_IS_PT )
-            convertArc( ind );
+        if( ArcIndex( ind ) != SHAPE_IS_PT )
+            convertArc( m_shapes[ind] );
     }
 
     if( aStartIndex == aEndIndex )
@@ -280,10 +283,14 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I&
         m_points.erase( m_points.begin() + aStartIndex + 1, m_points.begin() + aEndIndex + 1 );
         m_points[aStartIndex] = aP;
 
-        m_shapes.erase( m_shapes.begin() + aStartIndex + 1, m_shapes.begin() + aEndIndex + 1 );
+        if( !m_shapes.empty() )
+        {
+            m_shapes.erase( m_shapes.begin() + aStartIndex + 1,
+                            m_shapes.begin() + aEndIndex + 1 );
+        }
     }
 
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
@@ -297,24 +304,37 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE
 
     Remove( aStartIndex, aEndIndex );
 
-    // The total new arcs index is added to the new arc indices
-    size_t prev_arc_count = m_arcs.size();
-    auto   new_shapes = aLine.m_shapes;
+    if( !aLine.m_arcs.empty() )
+    {
+        // The total new arcs index is added to the new arc indices
+        size_t               prev_arc_count = m_arcs.size();
+        std::vector<ssize_t> new_shapes = aLine.CShapes();
+
+        for( auto& shape : new_shapes )
+        {
+            if( shape != SHAPE_IS_PT )
+                shape += prev_arc_count;
+        }
 
-    for( auto& shape : new_shapes )
-        shape += prev_arc_count;
+        requireShapes();
+        m_shapes.insert( m_shapes.begin() + aStartIndex, new_shapes.begin(), new_shapes.end() );
+    }
+    else if( !m_shapes.empty() )
+    {
+        m_shapes.insert( m_shapes.begin() + aStartIndex, aLine.PointCount(),
+                         ssize_t( SHAPE_IS_PT ) );
+    }
 
-    m_shapes.insert( m_shapes.begin() + aStartIndex, new_shapes.begin(), new_shapes.end() );
     m_points.insert( m_points.begin() + aStartIndex, aLine.m_points.begin(), aLine.m_points.end() );
     m_arcs.insert( m_arcs.end(), aLine.m_arcs.begin(), aLine.m_arcs.end() );
 
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
 void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
 {
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
     if( aEndIndex < 0 )
         aEndIndex += PointCount();
 
@@ -330,16 +350,18 @@ void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
     // Remove any overlapping arcs in the point range
     for( int i = aStartIndex; i < aEndIndex; i++ )
     {
-        if( m_shapes[i] != SHAPE_IS_PT )
+        if( ArcIndex( i ) != SHAPE_IS_PT )
             extra_arcs.insert( m_shapes[i] );
     }
 
     for( auto arc : extra_arcs )
         convertArc( arc );
 
-    m_shapes.erase( m_shapes.begin() + aStartIndex, m_shapes.begin() + aEndIndex + 1 );
+    if( !m_shapes.empty() )
+        m_shapes.erase( m_shapes.begin() + aStartIndex, m_shapes.begin() + aEndIndex + 1 );
+
     m_points.erase( m_points.begin() + aStartIndex, m_points.begin() + aEndIndex + 1 );
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
@@ -394,11 +416,13 @@ int SHAPE_LINE_CHAIN::Split( const VECTOR2I& aP )
     {
         // Are we splitting at the beginning of an arc?  If so, let's split right before so that
         // the shape is preserved
-        if( ii < PointCount() - 1 && m_shapes[ii] >= 0 && m_shapes[ii] == m_shapes[ii + 1] )
+        if( ii < PointCount() - 1 && ArcIndex( ii ) >= 0 && m_shapes[ii] == m_shapes[ii + 1] )
             ii--;
 
         m_points.insert( m_points.begin() + ii + 1, aP );
-        m_shapes.insert( m_shapes.begin() + ii + 1, ssize_t( SHAPE_IS_PT ) );
+
+        if( !m_shapes.empty() )
+            m_shapes.insert( m_shapes.begin() + ii + 1, ssize_t( SHAPE_IS_PT ) );
 
         return ii + 1;
     }
@@ -432,6 +456,10 @@ int SHAPE_LINE_CHAIN::ShapeCount() const
     if( m_points.empty() )
         return 0;
 
+    // Without arcs every shape is a segment
+    if( m_shapes.empty() )
+        return static_cast<int>( m_points.size() ) - 1;
+
     int numPoints = static_cast<int>( m_shapes.size() );
     int numShapes = 0;
     int arcIdx    = -1;
@@ -482,7 +510,7 @@ int SHAPE_LINE_CHAIN::NextShape( int aPointIndex, bool aForwards ) const
 
     int delta = aForwards ? 1 : -1;
 
-    if( m_shapes[aPointIndex] == SHAPE_IS_PT )
+    if( ArcIndex( aPointIndex ) == SHAPE_IS_PT )
         return aPointIndex + delta;
 
     int arcIndex = m_shapes[aPointIndex];
@@ -505,7 +533,7 @@ void SHAPE_LINE_CHAIN::RemoveShape( int aPointIndex )
     if( aPointIndex < 0 )
         aPointIndex += PointCount();
 
-    if( m_shapes[aPointIndex] == SHAPE_IS_PT )
+    if( ArcIndex( aPointIndex ) == SHAPE_IS_PT )
     {
         Remove( aPointIndex );
         return;
@@ -539,7 +567,7 @@ const SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Slice( int aStartIndex, int aEndIndex )
 
     for( int i = aStartIndex; i <= aEndIndex && i < numPoints; i++ )
     {
-        if( m_shapes[i] != SHAPE_IS_PT )
+        if( ArcIndex( i ) != SHAPE_IS_PT )
         {
             int  arcIdx   = m_shapes[i];
             bool wholeArc = true;
@@ -578,38 +606,44 @@ const SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Slice( int aStartIndex, int aEndIndex )
 
 void SHAPE_LINE_CHAIN::Append( const SHAPE_LINE_CHAIN& aOtherLine )
 {
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 
     if( aOtherLine.PointCount() == 0 )
         return;
 
-    else if( PointCount() == 0 || aOtherLine.CPoint( 0 ) != CPoint( -1 ) )
-    {
-        const VECTOR2I p = aOtherLine.CPoint( 0 );
-        m_points.push_back( p );
-        m_shapes.push_back( aOtherLine.CShapes()[0] );
-        m_bbox.Merge( p );
-    }
-
     size_t num_arcs = m_arcs.size();
-    m_arcs.insert( m_arcs.end(), aOtherLine.m_arcs.begin(), aOtherLine.m_arcs.end() );
 
-    for( int i = 1; i < aOtherLine.PointCount(); i++ )
-    {
-        const VECTOR2I p = aOtherLine.CPoint( i );
-        m_points.push_back( p );
+    if( !aOtherLine.m_arcs.empty() )
+        requireShapes();
 
-        ssize_t arcIndex = aOtherLine.ArcIndex( i );
+    auto appendPoint =
+            [&]( int aIndex )
+            {
+                const VECTOR2I p = aOtherLine.CPoint( aIndex );
+                m_points.push_back( p );
 
-        if( arcIndex != ssize_t( SHAPE_IS_PT ) )
-            m_shapes.push_back( num_arcs + arcIndex );
-        else
-            m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
+                if( !m_shapes.empty() )
+                {
+                    ssize_t arcIndex = aOtherLine.ArcIndex( aIndex );
 
-        m_bbox.Merge( p );
-    }
+                    if( arcIndex != ssize_t( SHAPE_IS_PT ) )
+                        m_shapes.push_back( num_arcs + arcIndex );
+                    else
+                        m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
+                }
 
-    assert( m_shapes.size() == m_points.size() );
+                m_bbox.Merge( p );
+            };
+
+    if( PointCount() == 0 || aOtherLine.CPoint( 0 ) != CPoint( -1 ) )
+        appendPoint( 0 );
+
+    m_arcs.insert( m_arcs.end(), aOtherLine.m_arcs.begin(), aOtherLine.m_arcs.end() );
+
+    for( int i = 1; i < aOtherLine.PointCount(); i++ )
+        appendPoint( i );
+
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
@@ -617,6 +651,8 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
 {
     auto& chain = aArc.ConvertToPolyline();
 
+    requireShapes();
+
     for( auto& pt : chain.CPoints() )
     {
         m_points.push_back( pt );
@@ -625,26 +661,30 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
 
     m_arcs.push_back( aArc );
 
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 {
-    if( m_shapes[aVertex] != SHAPE_IS_PT )
-        convertArc( aVertex );
+    if( ArcIndex( aVertex ) != SHAPE_IS_PT )
+        convertArc( m_shapes[aVertex] );
 
     m_points.insert( m_points.begin() + aVertex, aP );
-    m_shapes.insert( m_shapes.begin() + aVertex, ssize_t( SHAPE_IS_PT ) );
 
-    assert( m_shapes.size() == m_points.size() );
+    if( !m_shapes.empty() )
+        m_shapes.insert( m_shapes.begin() + aVertex, ssize_t( SHAPE_IS_PT ) );
+
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const SHAPE_ARC& aArc )
 {
-    if( m_shapes[aVertex] != SHAPE_IS_PT )
-        convertArc( aVertex );
+    if( ArcIndex( aVertex ) != SHAPE_IS_PT )
+        convertArc( m_shapes[aVertex] );
+
+    requireShapes();
 
     /// Step 1: Find the position for the new arc in the existing arc vector
     size_t arc_pos = m_arcs.size();
@@ -667,7 +707,7 @@ void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const SHAPE_ARC& aArc )
     /// Step 3: Add the vector of indices to the shape vector
     std::vector<size_t> new_points( chain.PointCount(), arc_pos );
     m_shapes.insert( m_shapes.begin() + aVertex, new_points.begin(), new_points.end() );
-    assert( m_shapes.size() == m_points.size() );
+    assert( m_shapes.empty() || m_shapes.size() == m_points.size() );
 }
 
 
@@ -963,13 +1003,19 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify( bool aRemoveColinear )
     else if( PointCount() == 2 )
     {
         if( m_points[0] == m_points[1] )
+        {
             m_points.pop_back();
 
+            if( !m_shapes.empty() )
+                m_shapes.pop_back();
+        }
+
         return *this;
     }
 
-    int i = 0;
-    int np = PointCount();
+    int  i = 0;
+    int  np = PointCount();
+    bool hasShapes = !m_shapes.empty();
 
     // stage 1: eliminate duplicate vertices
     while( i < np )
@@ -979,22 +1025,26 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify( bool aRemoveColinear )
         // We can eliminate duplicate vertices as long as they are part of the same shape, OR if
         // one of them is part of a shape and one is not.
         while( j < np && m_points[i] == m_points[j] &&
-               ( m_shapes[i] == m_shapes[j] ||
-                 m_shapes[i] == SHAPE_IS_PT ||
-                 m_shapes[j] == SHAPE_IS_PT ) )
+               ( ArcIndex( i ) == ArcIndex( j ) ||
+                 ArcIndex( i ) == SHAPE_IS_PT ||
+                 ArcIndex( j ) == SHAPE_IS_PT ) )
         {
             j++;
         }
 
-        int shapeToKeep = m_shapes[i];
+        pts_unique.push_back( CPoint( i ) );
 
-        if( shapeToKeep == SHAPE_IS_PT )
-            shapeToKeep = m_shapes[j - 1];
+        if( hasShapes )
+        {
+            int shapeToKeep = m_shapes[i];
 
-        wxASSERT( shapeToKeep < static_cast<int>( m_arcs.size() ) );
+            if( shapeToKeep == SHAPE_IS_PT )
+                shapeToKeep = m_shapes[j - 1];
 
-        pts_unique.push_back( CPoint( i ) );
-        shapes_unique.push_back( shapeToKeep );
+            wxASSERT( shapeToKeep < static_cast<int>( m_arcs.size() ) );
+
+            shapes_unique.push_back( shapeToKeep );
+        }
 
         i = j;
     }
@@ -1003,6 +1053,15 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify( bool aRemoveColinear )
     m_shapes.clear();
     np = pts_unique.size();
 
+    auto keepUnique =
+            [&]( int aIndex )
+            {
+                m_points.push_back( pts_unique[aIndex] );
+
+                if( hasShapes )
+                    m_shapes.push_back( shapes_unique[aIndex] );
+            };
+
     i = 0;
 
     // stage 2: eliminate colinear segments
@@ -1020,16 +1079,14 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify( bool aRemoveColinear )
                 n++;
         }
 
-        m_points.push_back( p0 );
-        m_shapes.push_back( shapes_unique[i] );
+        keepUnique( i );
 
         if( n > i )
             i = n;
 
         if( n == np - 2 )
         {
-            m_points.push_back( pts_unique[np - 1] );
-            m_shapes.push_back( shapes_unique[np - 1] );
+            keepUnique( np - 1 );
             return *this;
         }
 
@@ -1037,22 +1094,18 @@ SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify( bool aRemoveColinear )
     }
 
     if( np > 1 )
-    {
-        m_points.push_back( pts_unique[np - 2] );
-        m_shapes.push_back( shapes_unique[np - 2] );
-    }
+        keepUnique( np - 2 );
 
-    m_points.push_back( pts_unique[np - 1] );
-    m_shapes.push_back( shapes_unique[np - 1] );
+    keepUnique( np - 1 );
 
-    assert( m_points.size() == m_shapes.size() );
+    assert( m_shapes.empty() || m_points.size() == m_shapes.size() );
 
     return *this;
 }
 
 
-const VECTOR2I SHAPE_LINE_CHAIN::NearestPoint( const VECTOR2I& aP,
-                                               bool aAllowInternalShapePoints ) const
+const VECTOR2I SHAPE_LINE_CHAIN::NearestPoint( const VECTOR2I& aP, bool aAllowInternalShapePoints,
+                                               int* aSegment ) const
 {
     int min_d = INT_MAX;
     int nearest = 0;
@@ -1065,9 +1118,9 @@ const VECTOR2I SHAPE_LINE_CHAIN::NearestPoint( const VECTOR2I& aP,
 
         // An internal shape point here is everything after the start of an arc and before the
         // second-to-last vertex of the arc, because we are looking at segments here!
-        if( i > 0 && i < SegmentCount() - 1 && m_shapes[i] >= 0 &&
-                ( ( m_shapes[i - 1] >= 0 && m_shapes[i - 1] == m_shapes[i] ) &&
-                  ( m_shapes[i + 2] >= 0 && m_shapes[i + 2] == m_shapes[i] ) ) )
+        if( i > 0 && i < SegmentCount() - 1 && ArcIndex( i ) >= 0 &&
+                ( ( ArcIndex( i - 1 ) >= 0 && ArcIndex( i - 1 ) == ArcIndex( i ) ) &&
+                  ( ArcIndex( i + 2 ) >= 0 && ArcIndex( i + 2 ) == ArcIndex( i ) ) ) )
         {
             isInternalShapePoint = true;
         }
@@ -1079,15 +1132,18 @@ const VECTOR2I SHAPE_LINE_CHAIN::NearestPoint( const VECTOR2I& aP,
         }
     }
 
+    if( aSegment )
+        *aSegment = nearest;
+
     // Is this the start of an arc?  If so, return it directly
     if( !aAllowInternalShapePoints &&
-        ( ( nearest == 0 && m_shapes[nearest] >= 0 ) ||
-          ( m_shapes[nearest] >= 0 && m_shapes[nearest] != m_shapes[nearest - 1] ) ) )
+        ( ( nearest == 0 && ArcIndex( nearest ) >= 0 ) ||
+          ( ArcIndex( nearest ) >= 0 && ArcIndex( nearest ) != ArcIndex( nearest - 1 ) ) ) )
     {
         return m_points[nearest];
     }
     else if( !aAllowInternalShapePoints && nearest < SegmentCount() &&
-             m_shapes[nearest] >= 0 && m_shapes[nearest + 1] == m_shapes[nearest] )
+             ArcIndex( nearest ) >= 0 && ArcIndex( nearest + 1 ) == ArcIndex( nearest ) )
     {
         // If the nearest segment is the last of the arc, just return the arc endpoint
         return m_points[nearest + 1];
@@ -1223,7 +1279,9 @@ bool SHAPE_LINE_CHAIN::Parse( std::stringstream& aStream )
         m_points.emplace_back( x, y );
 
         aStream >> ind;
-        m_shapes.push_back( ind );
+
+        if( n_arcs > 0 )
+            m_shapes.push_back( ind );
     }
 
     for( size_t i = 0; i < n_arcs; i++ )
@@ -558,8 +558,8 @@ void SHAPE_POLY_SET::InflateWithLinkedHoles( int aFactor, int aCircleSegmentsCou
 }
 
 
-void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
-                              CORNER_STRATEGY aCornerStrategy )
+void SHAPE_POLY_SET::prepareOffset( ClipperOffset& aOffset, const Paths& aPaths, int aAmount,
+                                    int aCircleSegmentsCount, CORNER_STRATEGY aCornerStrategy )
 {
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI / aCircleSegmentsCount )
@@ -567,8 +567,6 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     #define SEG_CNT_MAX 64
     static double arc_tolerance_factor[SEG_CNT_MAX + 1];
 
-    ClipperOffset c;
-
     // N.B. see the Clipper documentation for jtSquare/jtMiter/jtRound.  They are poorly named
     // and are not what you'd think they are.
     // http://www.angusj.com/delphi/clipper/documentation/Docs/Units/ClipperLib/Types/JoinType.htm
@@ -605,13 +603,7 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
         break;
     }
 
-    for( const POLYGON& poly : m_polys )
-    {
-        for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), joinType, etClosedPolygon );
-    }
-
-    PolyTree solution;
+    aOffset.AddPaths( aPaths, joinType, etClosedPolygon );
 
     // Calculate the arc tolerance (arc error) from the seg count by circle. The seg count is
     // nn = M_PI / acos(1.0 - c.ArcTolerance / abs(aAmount))
@@ -632,9 +624,28 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
     else
         coeff = arc_tolerance_factor[aCircleSegmentsCount];
 
-    c.ArcTolerance = std::abs( aAmount ) * coeff;
-    c.MiterLimit = miterLimit;
-    c.MiterFallback = miterFallback;
+    aOffset.ArcTolerance = std::abs( aAmount ) * coeff;
+    aOffset.MiterLimit = miterLimit;
+    aOffset.MiterFallback = miterFallback;
+}
+
+
+void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
+                              CORNER_STRATEGY aCornerStrategy )
+{
+    ClipperOffset c;
+    Paths         paths;
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( size_t i = 0; i < poly.size(); i++ )
+            paths.push_back( poly[i].convertToClipper( i == 0 ) );
+    }
+
+    prepareOffset( c, paths, aAmount, aCircleSegmentsCount, aCornerStrategy );
+
+    PolyTree solution;
+
     c.Execute( solution, aAmount );
 
     importTree( &solution );
@@ -664,18 +675,12 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
 
 struct FractureEdge
 {
-    FractureEdge( int y = 0 ) :
-        m_connected( false ),
-        m_next( NULL )
-    {
-        m_p1.x = m_p2.y = y;
-    }
-
-    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2 ) :
+    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2, size_t aIndex ) :
         m_connected( connected ),
         m_p1( p1 ),
         m_p2( p2 ),
-        m_next( NULL )
+        m_next( NULL ),
+        m_index( aIndex )
     {
     }
 
@@ -687,13 +692,59 @@ struct FractureEdge
     bool m_connected;
     VECTOR2I m_p1, m_p2;
     FractureEdge* m_next;
+    size_t m_index;     ///< creation order, used to break ties deterministically
 };
 
 
-typedef std::vector<FractureEdge*> FractureEdgeSet;
+typedef std::vector<FractureEdge> FractureEdgeSet;
 
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+/**
+ * The connected fracture edges, bucketed in horizontal bands so that looking for the edges
+ * crossing a given y only visits the edges of one band rather than the whole polygon.
+ */
+class FRACTURE_EDGE_INDEX
+{
+public:
+    FRACTURE_EDGE_INDEX( int aMinY, int aMaxY, size_t aEdgeCount ) :
+        m_minY( aMinY )
+    {
+        size_t bandCount = std::min<size_t>( std::max<size_t>( aEdgeCount / 8, 1 ), 4096 );
+
+        m_bandHeight = ( (int64_t) aMaxY - aMinY ) / bandCount + 1;
+        m_bands.resize( bandCount );
+    }
+
+    void Add( FractureEdge* aEdge )
+    {
+        size_t first = band( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) );
+        size_t last = band( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( size_t ii = first; ii <= last; ii++ )
+            m_bands[ii].push_back( aEdge );
+    }
+
+    ///< @return the edges that may cross \a aY (a superset of them).
+    const std::vector<FractureEdge*>& Query( int aY ) const
+    {
+        return m_bands[band( aY )];
+    }
+
+private:
+    size_t band( int aY ) const
+    {
+        int64_t ii = ( (int64_t) aY - m_minY ) / m_bandHeight;
+
+        return std::min<int64_t>( std::max<int64_t>( ii, 0 ), m_bands.size() - 1 );
+    }
+
+    int                                      m_minY;
+    int64_t                                  m_bandHeight;
+    std::vector<std::vector<FractureEdge*>>  m_bands;
+};
+
+
+static int processEdge( FractureEdgeSet& edges, FRACTURE_EDGE_INDEX& aIndex, FractureEdge* edge )
 {
     int x   = edge->m_p1.x;
     int y   = edge->m_p1.y;
@@ -702,7 +753,7 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
     FractureEdge* e_nearest = NULL;
 
-    for( FractureEdge* e : edges )
+    for( FractureEdge* e : aIndex.Query( y ) )
     {
         if( !e->matches( y ) )
             continue;
@@ -721,7 +772,13 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
         int dist = ( x - x_intersect );
 
-        if( dist >= 0 && dist < min_dist && e->m_connected )
+        // Among equally near edges pick the oldest, so that the result doesn't depend on the
+        // order of the index
+        if( dist < 0 || !e->m_connected )
+            continue;
+
+        if( !e_nearest || dist < min_dist
+                || ( dist == min_dist && e->m_index < e_nearest->m_index ) )
         {
             min_dist    = dist;
             x_nearest   = x_intersect;
@@ -733,13 +790,17 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
     {
         int count = 0;
 
-        FractureEdge* lead1 = new FractureEdge( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
-        FractureEdge* lead2 = new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
-        FractureEdge* split_2 = new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
+        // edges has enough capacity reserved for these, so no pointer is invalidated
+        edges.emplace_back( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2, edges.size() );
+        FractureEdge* split_2 = &edges.back();
+        edges.emplace_back( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ), edges.size() );
+        FractureEdge* lead1 = &edges.back();
+        edges.emplace_back( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ), edges.size() );
+        FractureEdge* lead2 = &edges.back();
 
-        edges.push_back( split_2 );
-        edges.push_back( lead1 );
-        edges.push_back( lead2 );
+        aIndex.Add( split_2 );
+        aIndex.Add( lead1 );
+        aIndex.Add( lead2 );
 
         FractureEdge* link = e_nearest->m_next;
 
@@ -752,10 +813,12 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         for( last = edge; last->m_next != edge; last = last->m_next )
         {
             last->m_connected = true;
+            aIndex.Add( last );
             count++;
         }
 
         last->m_connected = true;
+        aIndex.Add( last );
         last->m_next    = lead2;
         lead2->m_next   = split_2;
         split_2->m_next = link;
@@ -770,7 +833,6 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
     FractureEdgeSet edges;
-    FractureEdgeSet border_edges;
     FractureEdge*   root = NULL;
 
     bool first = true;
@@ -778,7 +840,24 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
     if( paths.size() == 1 )
         return;
 
-    int num_unconnected = 0;
+    struct HOLE
+    {
+        int    m_xMin;
+        size_t m_borderEdge;    ///< first edge starting at m_xMin
+    };
+
+    std::vector<HOLE> holes;
+    size_t            edgeCount = 0;
+    BOX2I             bbox = paths[0].BBox();
+
+    for( const SHAPE_LINE_CHAIN& path : paths )
+        edgeCount += path.PointCount();
+
+    // Each hole adds three edges when it is connected.  Reserving them up front keeps the
+    // edges at fixed addresses.
+    edges.reserve( edgeCount + 3 * ( paths.size() - 1 ) );
+
+    FRACTURE_EDGE_INDEX index( bbox.GetY(), bbox.GetBottom(), edgeCount );
 
     for( const SHAPE_LINE_CHAIN& path : paths )
     {
@@ -787,20 +866,25 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
         FractureEdge* prev = NULL, * first_edge = NULL;
 
-        int x_min = std::numeric_limits<int>::max();
+        HOLE hole = { std::numeric_limits<int>::max(), 0 };
 
-        for( const VECTOR2I& p : points )
+        for( int i = 0; i < pointCount; i++ )
         {
-            if( p.x < x_min )
-                x_min = p.x;
+            if( points[i].x < hole.m_xMin )
+            {
+                hole.m_xMin = points[i].x;
+                hole.m_borderEdge = edges.size() + i;
+            }
         }
 
         for( int i = 0; i < pointCount; i++ )
         {
             // Do not use path.CPoint() here; open-coding it using the local variables "points"
             // and "pointCount" gives a non-trivial performance boost to zone fill times.
-            FractureEdge* fe = new FractureEdge( first, points[ i ],
-                                                        points[ i+1 == pointCount ? 0 : i+1 ] );
+            edges.emplace_back( first, points[ i ], points[ i+1 == pointCount ? 0 : i+1 ],
+                                edges.size() );
+
+            FractureEdge* fe = &edges.back();
 
             if( !root )
                 root = fe;
@@ -815,42 +899,27 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
                 fe->m_next = first_edge;
 
             prev = fe;
-            edges.push_back( fe );
 
-            if( !first )
-            {
-                if( fe->m_p1.x == x_min )
-                    border_edges.push_back( fe );
-            }
-
-            if( !fe->m_connected )
-                num_unconnected++;
+            if( first )
+                index.Add( fe );
         }
 
+        if( !first && pointCount )
+            holes.push_back( hole );
+
         first = false;    // first path is always the outline
     }
 
-    // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
-    {
-        int x_min = std::numeric_limits<int>::max();
-
-        FractureEdge* smallestX = NULL;
-
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdge* border_edge : border_edges )
-        {
-            int xt = border_edge->m_p1.x;
-
-            if( ( xt < x_min ) && !border_edge->m_connected )
-            {
-                x_min = xt;
-                smallestX = border_edge;
-            }
-        }
+    // Connect the holes to the main outline (or to holes connected before them) from left to
+    // right, each by a horizontal bridge from its left-most vertex
+    std::stable_sort( holes.begin(), holes.end(),
+                      []( const HOLE& aA, const HOLE& aB )
+                      {
+                          return aA.m_xMin < aB.m_xMin;
+                      } );
 
-        num_unconnected -= processEdge( edges, smallestX );
-    }
+    for( const HOLE& hole : holes )
+        processEdge( edges, index, &edges[hole.m_borderEdge] );
 
     paths.clear();
     SHAPE_LINE_CHAIN newPath;
@@ -864,9 +933,6 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.Append( e->m_p1 );
 
-    for( FractureEdge* edge : edges )
-        delete edge;
-
     paths.push_back( std::move( newPath ) );
 }
 
@@ -875,6 +941,8 @@ void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
+    // Callers (the zone filler) already fill zones on several threads, so polygons are
+    // fractured one after another here.
     for( POLYGON& paths : m_polys )
     {
         fractureSingle( paths );
@@ -1843,6 +1911,53 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Fillet( int aRadius, int aErrorMax )
 }
 
 
+SHAPE_POLY_SET SHAPE_POLY_SET::Decimated( int aTolerance ) const
+{
+    SEG::ecoord    minDistSq = SEG::Square( aTolerance );
+    SHAPE_POLY_SET decimated;
+
+    auto decimate =
+            [&]( const SHAPE_LINE_CHAIN& aContour ) -> SHAPE_LINE_CHAIN
+            {
+                SHAPE_LINE_CHAIN result;
+
+                for( int ii = 0; ii < aContour.PointCount(); ++ii )
+                {
+                    const VECTOR2I& pt = aContour.CPoint( ii );
+
+                    if( ii > 0 && ( pt - result.CLastPoint() ).SquaredEuclideanNorm() < minDistSq )
+                        continue;
+
+                    result.Append( pt );
+                }
+
+                result.SetClosed( true );
+                return result;
+            };
+
+    for( int ii = 0; ii < OutlineCount(); ++ii )
+    {
+        SHAPE_LINE_CHAIN outline = decimate( COutline( ii ) );
+
+        // Polygons smaller than the tolerance disappear
+        if( outline.PointCount() < 3 )
+            continue;
+
+        int outlineIdx = decimated.AddOutline( outline );
+
+        for( int jj = 0; jj < HoleCount( ii ); ++jj )
+        {
+            SHAPE_LINE_CHAIN hole = decimate( CHole( ii, jj ) );
+
+            if( hole.PointCount() >= 3 )
+                decimated.AddHole( hole, outlineIdx );
+        }
+    }
+
+    return decimated;
+}
+
+
 SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
                                         unsigned int aDistance, int aIndex, int aErrorMax )
 {
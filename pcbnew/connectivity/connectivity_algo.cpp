@@ -33,6 +33,10 @@
 #include <mutex>
 #include <algorithm>
 #include <future>
+#include <unordered_map>
+
+#include <perf_counters.h>
+#include <thread_pool.h>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -190,6 +194,9 @@ bool CN_CONNECTIVITY_ALGO::Add( BOARD_ITEM* aItem )
 
 void CN_CONNECTIVITY_ALGO::searchConnections()
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.search_connections" );
+    SCOPED_PERF_TIMER    timer( counter );
+
 #ifdef PROFILE
     PROF_COUNTER garbage_collection( "garbage-collection" );
 #endif
@@ -198,8 +205,26 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.RemoveInvalidItems( garbage );
 
-    for( auto item : garbage )
-        delete item;
+    if( !garbage.empty() )
+    {
+        m_propagationSeeds.erase( std::remove_if( m_propagationSeeds.begin(),
+                                                  m_propagationSeeds.end(),
+                                                  []( CN_ITEM* aItem )
+                                                  {
+                                                      return !aItem->Valid();
+                                                  } ),
+                                  m_propagationSeeds.end() );
+    }
+
+    for( CN_ITEM* item : garbage )
+    {
+        // The ratsnest clusters of the net the item was last placed in (and the ratsnest built
+        // from them) still point to it, so make sure that net gets rebuilt.  Its net code may
+        // have changed since.  The item is kept alive until then.
+        MarkNetAsDirty( item->ClusterNet() );
+
+        m_garbage.push_back( item );
+    }
 
 #ifdef PROFILE
     garbage_collection.Show();
@@ -213,6 +238,12 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
                       return aItem->Dirty();
                   } );
 
+    if( !m_fullPropagation )
+    {
+        m_propagationSeeds.insert( m_propagationSeeds.end(), dirtyItems.begin(),
+                                   dirtyItems.end() );
+    }
+
     if( m_progressReporter )
     {
         m_progressReporter->SetMaxProgress( dirtyItems.size() );
@@ -300,69 +331,49 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 }
 
 
-const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
-                                                                           const KICAD_T aTypes[],
-                                                                           int aSingleNet )
+/**
+ * Return true if \a aItem can be part of a cluster of the given search.
+ */
+static bool clusterAccepts( const CN_ITEM* aItem, bool aWithinAnyNet, const KICAD_T aTypes[],
+                            int aSingleNet )
 {
-    bool withinAnyNet = ( aMode != CSM_PROPAGATE );
-
-    std::deque<CN_ITEM*> Q;
-    std::set<CN_ITEM*> item_set;
-
-    CLUSTERS clusters;
-
-    if( m_itemList.IsDirty() )
-        searchConnections();
-
-    auto addToSearchList =
-            [&item_set, withinAnyNet, aSingleNet, aTypes]( CN_ITEM *aItem )
-            {
-                if( withinAnyNet && aItem->Net() <= 0 )
-                    return;
-
-                if( !aItem->Valid() )
-                    return;
-
-                if( aSingleNet >=0 && aItem->Net() != aSingleNet )
-                    return;
+    if( !aItem->Valid() )
+        return false;
 
-                bool found = false;
+    if( aWithinAnyNet && aItem->Net() <= 0 )
+        return false;
 
-                for( int i = 0; aTypes[i] != EOT; i++ )
-                {
-                    if( aItem->Parent()->Type() == aTypes[i] )
-                    {
-                        found = true;
-                        break;
-                    }
-                }
+    if( aSingleNet >= 0 && aItem->Net() != aSingleNet )
+        return false;
 
-                if( !found )
-                    return;
+    for( int i = 0; aTypes[i] != EOT; i++ )
+    {
+        if( aItem->Parent()->Type() == aTypes[i] )
+            return true;
+    }
 
-                aItem->SetVisited( false );
+    return false;
+}
 
-                item_set.insert( aItem );
-            };
 
-    std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
+CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::growClusters(
+        const std::vector<CN_ITEM*>& aRoots, CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+        int aSingleNet )
+{
+    bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
-        return CLUSTERS();
+    std::deque<CN_ITEM*> Q;
+    CLUSTERS             clusters;
 
-    while( !item_set.empty() )
+    // Items are only marked as visited for the duration of a search, so that searches don't
+    // have to clear the flags of the whole board first
+    for( CN_ITEM* root : aRoots )
     {
-        CN_CLUSTER_PTR cluster = std::make_shared<CN_CLUSTER>();
-        CN_ITEM*       root;
-        auto           it = item_set.begin();
-
-        while( it != item_set.end() && (*it)->Visited() )
-            it = item_set.erase( item_set.begin() );
+        if( root->Visited() || !clusterAccepts( root, withinAnyNet, aTypes, aSingleNet ) )
+            continue;
 
-        if( it == item_set.end() )
-            break;
+        CN_CLUSTER_PTR cluster = std::make_shared<CN_CLUSTER>();
 
-        root = *it;
         root->SetVisited( true );
 
         Q.clear();
@@ -380,7 +391,7 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
                 if( withinAnyNet && n->Net() != root->Net() )
                     continue;
 
-                if( !n->Visited() && n->Valid() )
+                if( !n->Visited() && clusterAccepts( n, withinAnyNet, aTypes, aSingleNet ) )
                 {
                     n->SetVisited( true );
                     Q.push_back( n );
@@ -391,6 +402,32 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
         clusters.push_back( cluster );
     }
 
+    for( const CN_CLUSTER_PTR& cluster : clusters )
+    {
+        for( CN_ITEM* item : *cluster )
+            item->SetVisited( false );
+    }
+
+    return clusters;
+}
+
+
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
+                                                                           const KICAD_T aTypes[],
+                                                                           int aSingleNet )
+{
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.search_clusters" );
+    SCOPED_PERF_TIMER    timer( counter );
+
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return CLUSTERS();
+
+    std::vector<CN_ITEM*> roots( m_itemList.begin(), m_itemList.end() );
+    CLUSTERS              clusters = growClusters( roots, aMode, aTypes, aSingleNet );
+
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return CLUSTERS();
 
@@ -416,6 +453,9 @@ void reportProgress( PROGRESS_REPORTER* aReporter, int aCount, int aSize, int aD
 
 void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.build" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     const int delta = 100;  // Number of additions between 2 calls to the progress bar
     int ii = 0;
     int size = 0;
@@ -434,6 +474,9 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
         reportProgress( aReporter, ii++, size, delta );
     }
 
+    if( m_itemList.GetZonePartitionCache() )
+        m_itemList.GetZonePartitionCache()->Prune( aBoard->Zones() );
+
     for( TRACK* tv : aBoard->Tracks() )
     {
         Add( tv );
@@ -531,7 +574,26 @@ void CN_CONNECTIVITY_ALGO::propagateConnections( BOARD_COMMIT* aCommit )
 
 void CN_CONNECTIVITY_ALGO::PropagateNets( BOARD_COMMIT* aCommit )
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    if( m_fullPropagation )
+    {
+        m_connClusters = SearchClusters( CSM_PROPAGATE );
+    }
+    else
+    {
+        // The clusters without any new item have been propagated already, and removing items
+        // can only split clusters, which never needs propagating
+        constexpr KICAD_T no_zones[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T,
+                                         PCB_FOOTPRINT_T, EOT };
+
+        m_connClusters = growClusters( m_propagationSeeds, CSM_PROPAGATE, no_zones, -1 );
+    }
+
+    m_propagationSeeds.clear();
+    m_fullPropagation = false;
+
     propagateConnections( aCommit );
 }
 
@@ -566,45 +628,212 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( ZONE* aZone, PCB_LAYER_ID
     wxLogTrace( "CN", "Found %u isolated islands\n", (unsigned)aIslands.size() );
 }
 
+/**
+ * Return the subpolygon indices of the \a aZoneItems which are not connected to any pad.
+ *
+ * This is the same test as CN_CLUSTER::IsOrphaned() on the CSM_CONNECTIVITY_CHECK clusters,
+ * but it only walks the clusters of the given items, and keeps its own visited set rather than
+ * the items' flags, so that it can run on several zone layers at once.  The connections must
+ * not change while it runs.
+ */
+static std::vector<int> findOrphanedSubpolys( const std::vector<CN_ITEM*>& aZoneItems )
+{
+    constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_T,
+                                  PCB_FOOTPRINT_T, EOT };
+
+    // Whether the cluster of each item seen so far reaches a pad.  The search stops at the
+    // first pad, so a connected cluster may only be partially listed; an orphaned one is
+    // always listed entirely.
+    std::unordered_map<const CN_ITEM*, bool> reachesPad;
+    std::vector<CN_ITEM*>                    visited;
+    std::deque<CN_ITEM*>                     Q;
+    std::vector<int>                         islands;
+
+    for( CN_ITEM* root : aZoneItems )
+    {
+        if( !clusterAccepts( root, true, types, -1 ) )
+            continue;
+
+        auto known = reachesPad.find( root );
+
+        if( known == reachesPad.end() )
+        {
+            bool foundPad = false;
+
+            visited.clear();
+            Q.clear();
+
+            reachesPad[root] = false;
+            visited.push_back( root );
+            Q.push_back( root );
+
+            while( !Q.empty() )
+            {
+                CN_ITEM* current = Q.front();
+
+                Q.pop_front();
+
+                if( current->Parent()->Type() == PCB_PAD_T )
+                {
+                    foundPad = true;
+                    break;
+                }
+
+                for( CN_ITEM* n : current->ConnectedItems() )
+                {
+                    if( n->Net() != root->Net() || reachesPad.count( n ) )
+                        continue;
+
+                    if( clusterAccepts( n, true, types, -1 ) )
+                    {
+                        reachesPad[n] = false;
+                        visited.push_back( n );
+                        Q.push_back( n );
+                    }
+                }
+            }
+
+            for( CN_ITEM* item : visited )
+                reachesPad[item] = foundPad;
+
+            known = reachesPad.find( root );
+        }
+
+        if( !known->second )
+            islands.push_back( static_cast<CN_ZONE_LAYER*>( root )->SubpolyIndex() );
+    }
+
+    std::sort( islands.begin(), islands.end() );
+
+    return islands;
+}
+
+
 void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.find_islands" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     for( auto& z : aZones )
     {
         Remove( z.m_zone );
         Add( z.m_zone );
     }
 
-    m_connClusters = SearchClusters( CSM_CONNECTIVITY_CHECK );
+    // The connections are the read-only snapshot all the zone layers are searched against
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    struct ZONE_LAYER_TASK
+    {
+        CN_ZONE_ISOLATED_ISLAND_LIST* m_zone;
+        PCB_LAYER_ID                  m_layer;
+        std::vector<CN_ITEM*>         m_items;
+        std::future<std::vector<int>> m_islands;
+    };
+
+    std::vector<ZONE_LAYER_TASK> tasks;
 
     for( CN_ZONE_ISOLATED_ISLAND_LIST& zone : aZones )
     {
+        if( !ItemExists( zone.m_zone ) )
+            continue;
+
+        const std::list<CN_ITEM*> items = ItemEntry( zone.m_zone ).GetItems();
+
         for( PCB_LAYER_ID layer : zone.m_zone->GetLayerSet().Seq() )
         {
             if( zone.m_zone->GetFilledPolysList( layer ).IsEmpty() )
                 continue;
 
-            for( const CN_CLUSTER_PTR& cluster : m_connClusters )
+            ZONE_LAYER_TASK task;
+            task.m_zone = &zone;
+            task.m_layer = layer;
+
+            for( CN_ITEM* item : items )
             {
-                if( cluster->Contains( zone.m_zone ) && cluster->IsOrphaned() )
-                {
-                    for( CN_ITEM* z : *cluster )
-                    {
-                        if( z->Parent() == zone.m_zone && z->Layer() == layer )
-                        {
-                            zone.m_islands[layer].push_back(
-                                    static_cast<CN_ZONE_LAYER*>( z )->SubpolyIndex() );
-                        }
-                    }
-                }
+                if( item->Layer() == layer )
+                    task.m_items.push_back( item );
             }
+
+            tasks.push_back( std::move( task ) );
         }
     }
+
+    THREAD_POOL& pool = THREAD_POOL::Instance();
+
+    for( ZONE_LAYER_TASK& task : tasks )
+    {
+        const std::vector<CN_ITEM*>* items = &task.m_items;
+        task.m_islands = pool.Submit( [items]()
+                                      {
+                                          return findOrphanedSubpolys( *items );
+                                      } );
+    }
+
+    // Merged in the order of aZones and of the layers, whatever order the tasks finish in
+    for( ZONE_LAYER_TASK& task : tasks )
+        task.m_zone->m_islands[task.m_layer] = task.m_islands.get();
 }
 
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_ARC_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_T,
+                                  PCB_FOOTPRINT_T, EOT };
+
+    if( m_itemList.IsDirty() )
+        searchConnections();
+
+    CLUSTERS newClusters;
+
+    if( !m_ratsnestClustersValid )
+    {
+        m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+        newClusters = m_ratsnestClusters;
+    }
+    else
+    {
+        // Ratsnest clusters never span several nets, so the clusters of the clean nets are
+        // still valid.  Any change to an item marks the nets it was (and is) on as dirty.
+        std::vector<CN_ITEM*> roots;
+
+        for( CN_ITEM* item : m_itemList )
+        {
+            if( IsNetDirty( item->Net() ) )
+                roots.push_back( item );
+        }
+
+        newClusters = growClusters( roots, CSM_RATSNEST, types, -1 );
+
+        CLUSTERS clusters;
+
+        for( const CN_CLUSTER_PTR& cluster : m_ratsnestClusters )
+        {
+            if( !IsNetDirty( cluster->OriginNet() ) )
+                clusters.push_back( cluster );
+        }
+
+        clusters.insert( clusters.end(), newClusters.begin(), newClusters.end() );
+
+        std::stable_sort( clusters.begin(), clusters.end(),
+                          []( const CN_CLUSTER_PTR& a, const CN_CLUSTER_PTR& b )
+                          {
+                              return a->OriginNet() < b->OriginNet();
+                          } );
+
+        m_ratsnestClusters = std::move( clusters );
+    }
+
+    for( const CN_CLUSTER_PTR& cluster : newClusters )
+    {
+        for( CN_ITEM* item : *cluster )
+            item->SetClusterNet( cluster->OriginNet() );
+    }
+
+    // A cancelled search doesn't return all the clusters
+    m_ratsnestClustersValid = !( m_progressReporter && m_progressReporter->IsCancelled() );
+
     return m_ratsnestClusters;
 }
 
@@ -648,14 +877,16 @@ void CN_VISITOR::checkZoneItemConnection( CN_ZONE_LAYER* aZoneLayer, CN_ITEM* aI
         accuracy = ( static_cast<TRACK*>( aItem->Parent() )->GetWidth() + 1 ) / 2;
     }
 
+    std::vector<VECTOR2I> anchors;
+    anchors.reserve( aItem->AnchorCount() );
+
     for( int i = 0; i < aItem->AnchorCount(); ++i )
+        anchors.push_back( aItem->GetAnchor( i ) );
+
+    if( aZoneLayer->ContainsAnyPoint( anchors, accuracy ) )
     {
-        if( aZoneLayer->ContainsPoint( aItem->GetAnchor( i ), accuracy ) )
-        {
-            aZoneLayer->Connect( aItem );
-            aItem->Connect( aZoneLayer );
-            return;
-        }
+        aZoneLayer->Connect( aItem );
+        aItem->Connect( aZoneLayer );
     }
 }
 
@@ -800,12 +1031,25 @@ bool CN_VISITOR::operator()( CN_ITEM* aCandidate )
 void CN_CONNECTIVITY_ALGO::Clear()
 {
     m_ratsnestClusters.clear();
+    m_ratsnestClustersValid = false;
     m_connClusters.clear();
+    m_propagationSeeds.clear();
+    m_fullPropagation = true;
     m_itemMap.clear();
     m_itemList.Clear();
+    ReleaseGarbage();
+}
+
 
+void CN_CONNECTIVITY_ALGO::ReleaseGarbage()
+{
+    for( CN_ITEM* item : m_garbage )
+        m_itemList.Free( item );
+
+    m_garbage.clear();
 }
 
+
 void CN_CONNECTIVITY_ALGO::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 {
     m_progressReporter = aReporter;
@@ -61,7 +61,7 @@ class CN_EDGE
 {
 public:
     CN_EDGE()
-            : m_weight( 0 ), m_visible( true )
+            : m_source( nullptr ), m_target( nullptr ), m_weight( 0 ), m_visible( true )
     {}
 
     CN_EDGE( CN_ANCHOR_PTR aSource, CN_ANCHOR_PTR aTarget, unsigned aWeight = 0 )
@@ -166,8 +166,31 @@ private:
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
+    ///< Whether m_ratsnestClusters holds the clusters of every net, so that only those of the
+    ///< dirty nets need to be searched again.
+    bool m_ratsnestClustersValid = false;
+
+    ///< Items added since nets were last propagated.  Only the clusters containing them can
+    ///< need propagating again.
+    std::vector<CN_ITEM*> m_propagationSeeds;
+
+    ///< Set when the seeds above don't cover all changes, and nets must be propagated over the
+    ///< whole board.
+    bool m_fullPropagation = true;
+
+    ///< Items garbage collected from m_itemList.  The ratsnest may still refer to their anchors,
+    ///< so they are only freed by ReleaseGarbage(), once the nets they were in are rebuilt.
+    std::vector<CN_ITEM*> m_garbage;
+
     void    searchConnections();
 
+    /**
+     * Build the clusters of \a aMode grown from each of \a aRoots not already part of a cluster.
+     * Clusters only hold items of \a aTypes, and of net \a aSingleNet when it is not -1.
+     */
+    CLUSTERS growClusters( const std::vector<CN_ITEM*>& aRoots, CLUSTER_SEARCH_MODE aMode,
+                           const KICAD_T aTypes[], int aSingleNet );
+
     void    propagateConnections( BOARD_COMMIT* aCommit = nullptr );
 
     template <class Container, class BItem>
@@ -184,6 +207,14 @@ public:
     CN_CONNECTIVITY_ALGO() {}
     ~CN_CONNECTIVITY_ALGO() { Clear(); }
 
+    /**
+     * Reuse the zone partitions of \a aCache, which outlives this object.
+     */
+    void SetZonePartitionCache( std::shared_ptr<CN_ZONE_PARTITION_CACHE> aCache )
+    {
+        m_itemList.SetZonePartitionCache( std::move( aCache ) );
+    }
+
     bool ItemExists( const BOARD_CONNECTED_ITEM* aItem ) const
     {
         return m_itemMap.find( aItem ) != m_itemMap.end();
@@ -196,7 +227,7 @@ public:
 
     bool IsNetDirty( int aNet ) const
     {
-        if( aNet < 0 )
+        if( aNet < 0 || aNet >= (int) m_dirtyNets.size() )
             return false;
 
         return m_dirtyNets[ aNet ];
@@ -212,9 +243,7 @@ public:
     {
         for( const auto& cl : m_ratsnestClusters )
         {
-            int net = cl->OriginNet();
-
-            if( net >= 0 && m_dirtyNets[net] )
+            if( IsNetDirty( cl->OriginNet() ) )
                 aClusters.push_back( cl );
         }
     }
@@ -229,6 +258,15 @@ public:
 
     void Clear();
 
+    /**
+     * Free the items garbage collected since the last call.
+     *
+     * The ratsnest refers to anchors by address, and the slots of freed items are reused, so
+     * this must only be called once the nets marked as dirty by the garbage collection have
+     * been cleared.
+     */
+    void ReleaseGarbage();
+
     bool Remove( BOARD_ITEM* aItem );
     bool Add( BOARD_ITEM* aItem );
 
@@ -237,7 +275,11 @@ public:
     const CLUSTERS SearchClusters( CLUSTER_SEARCH_MODE aMode );
 
     /**
-     * Propagates nets from pads to other items in clusters
+     * Propagates nets from pads to other items in clusters.
+     *
+     * Only the clusters holding items added since the last call are searched, as the others
+     * have been propagated already.
+     *
      * @param aCommit is used to store undo information for items modified by the call
      */
     void PropagateNets( BOARD_COMMIT* aCommit = nullptr );
@@ -252,6 +294,10 @@ public:
      */
     void FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones );
 
+    /**
+     * Return the ratsnest clusters of all nets.  Only the clusters of the dirty nets are
+     * searched again, the others are kept from the previous call.
+     */
     const CLUSTERS& GetClusters();
 
     const CN_LIST& ItemList() const
@@ -264,8 +310,8 @@ public:
     {
         for( auto&& item : m_itemList )
         {
-            for( auto&& anchor : item->Anchors() )
-                aFunc( *anchor );
+            for( CN_ANCHOR& anchor : item->Anchors() )
+                aFunc( anchor );
         }
     }
 
@@ -31,15 +31,37 @@
 #include <algorithm>
 #include <future>
 
+#include <perf_counters.h>
+
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <connectivity/from_to_cache.h>
 
 #include <ratsnest/ratsnest_data.h>
+#include <thread_pool.h>
+
+
+/**
+ * The part of the dynamic ratsnest which doesn't change while the selection is dragged.
+ */
+struct CONNECTIVITY_DATA::DYNAMIC_RATSNEST_CACHE
+{
+    ///< The moving items the cache was built for
+    const CONNECTIVITY_DATA* m_dynamicData;
+
+    ///< Static anchors of each net touched by the moving items
+    std::vector<std::pair<int, RN_STATIC_ANCHORS>> m_nets;
+
+    ///< Ratsnest lines between two moving items
+    std::vector<std::pair<BOARD_CONNECTED_ITEM*, BOARD_CONNECTED_ITEM*>> m_internalEdges;
+};
+
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
+    m_zonePartitionCache = std::make_shared<CN_ZONE_PARTITION_CACHE>();
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
+    m_connAlgo->SetZonePartitionCache( m_zonePartitionCache );
     m_progressReporter = nullptr;
     m_fromToCache.reset( new FROM_TO_CACHE );
 }
@@ -84,9 +106,15 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 
 void CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 {
+    // The ratsnest refers to the anchors owned by the old connectivity items
+    Clear();
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
+    m_connAlgo->SetZonePartitionCache( m_zonePartitionCache );
     m_connAlgo->Build( aBoard, aReporter );
 
+    m_fromToCache->MarkAllDirty();
+
     m_netclassMap.clear();
 
     for( NETINFO_ITEM* net : aBoard->GetNetInfo() )
@@ -99,6 +127,8 @@ void CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    Clear();
+
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aItems );
 
@@ -117,6 +147,9 @@ void CONNECTIVITY_DATA::Move( const VECTOR2I& aDelta )
 
 void CONNECTIVITY_DATA::updateRatsnest()
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "ratsnest.update" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     #ifdef PROFILE
     PROF_COUNTER rnUpdate( "update-ratsnest" );
     #endif
@@ -127,8 +160,9 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    // Hand out nets in batches of 8 or more: fewer don't pay for the scheduling overhead
+    THREAD_POOL& pool = THREAD_POOL::Instance();
+    size_t parallelThreadCount = std::min<size_t>( pool.GetThreadCount(),
             ( dirty_nets.size() + 7 ) / 8 );
 
     std::atomic<size_t> nextNet( 0 );
@@ -142,12 +176,12 @@ void CONNECTIVITY_DATA::updateRatsnest()
         return 1;
     };
 
-    if( parallelThreadCount == 1 )
+    if( parallelThreadCount <= 1 )
         update_lambda();
     else
     {
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+            returns[ii] = pool.Submit( update_lambda );
 
         // Finalize the ratsnest threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
@@ -170,6 +204,9 @@ void CONNECTIVITY_DATA::addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& a
 
 void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.recalculate_ratsnest" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     m_connAlgo->PropagateNets( aCommit );
 
     int lastNet = m_connAlgo->NetCount();
@@ -193,9 +230,16 @@ void CONNECTIVITY_DATA::RecalculateRatsnest( BOARD_COMMIT* aCommit  )
         {
             m_nets[net]->Clear();
             dirtyNets++;
+
+            // Not yet created when building the temporary connectivity of a selection
+            if( m_fromToCache )
+                m_fromToCache->MarkNetDirty( net );
         }
     }
 
+    // No net refers to the anchors of the garbage collected items anymore
+    m_connAlgo->ReleaseGarbage();
+
     for( const auto& c : clusters )
     {
         int net = c->OriginNet();
@@ -224,6 +268,9 @@ void CONNECTIVITY_DATA::BlockRatsnestItems( const std::vector<BOARD_ITEM*>& aIte
 {
     std::vector<BOARD_CONNECTED_ITEM*> citems;
 
+    // A new set of moving items; the static anchors have to be gathered again
+    m_dynamicRatsnestCache.reset();
+
     for( auto item : aItems )
     {
         if( item->Type() == PCB_FOOTPRINT_T )
@@ -246,8 +293,8 @@ void CONNECTIVITY_DATA::BlockRatsnestItems( const std::vector<BOARD_ITEM*>& aIte
 
             for( const auto& cnItem : entry.GetItems() )
             {
-                for( auto anchor : cnItem->Anchors() )
-                    anchor->SetNoLine( true );
+                for( CN_ANCHOR& anchor : cnItem->Anchors() )
+                    anchor.SetNoLine( true );
             }
         }
     }
@@ -270,53 +317,75 @@ void CONNECTIVITY_DATA::FindIsolatedCopperIslands( ZONE* aZone, std::vector<int>
 
 void CONNECTIVITY_DATA::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLATED_ISLAND_LIST>& aZones )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "connectivity.find_isolated_islands" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     m_connAlgo->FindIsolatedCopperIslands( aZones );
 }
 
 
+void CONNECTIVITY_DATA::buildDynamicRatsnestCache( const std::vector<BOARD_ITEM*>& aItems,
+                                                   const CONNECTIVITY_DATA* aDynamicData )
+{
+    m_dynamicRatsnestCache.reset( new DYNAMIC_RATSNEST_CACHE );
+    m_dynamicRatsnestCache->m_dynamicData = aDynamicData;
+
+    // Connections between the stationary board and the moving selection.  BlockRatsnestItems()
+    // has already hidden the anchors of the moving items, so these are all static.
+    unsigned int netCount = std::min( aDynamicData->m_nets.size(), m_nets.size() );
+
+    for( unsigned int nc = 1; nc < netCount; nc++ )
+    {
+        if( aDynamicData->m_nets[nc]->GetNodeCount() == 0 )
+            continue;
+
+        RN_STATIC_ANCHORS anchors( *m_nets[nc] );
+
+        if( !anchors.Empty() )
+            m_dynamicRatsnestCache->m_nets.emplace_back( nc, std::move( anchors ) );
+    }
+
+    // Internal connections in the moving set
+    for( const CN_EDGE& edge : GetRatsnestForItems( aItems ) )
+    {
+        m_dynamicRatsnestCache->m_internalEdges.emplace_back( edge.GetSourceNode()->Parent(),
+                                                              edge.GetTargetNode()->Parent() );
+    }
+}
+
+
 void CONNECTIVITY_DATA::ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems,
                                                 const CONNECTIVITY_DATA* aDynamicData )
 {
     if( !aDynamicData )
         return;
 
+    if( !m_dynamicRatsnestCache || m_dynamicRatsnestCache->m_dynamicData != aDynamicData )
+        buildDynamicRatsnestCache( aItems, aDynamicData );
+
     m_dynamicRatsnest.clear();
 
     // This gets connections between the stationary board and the
     // moving selection
-    for( unsigned int nc = 1; nc < aDynamicData->m_nets.size(); nc++ )
+    for( const auto& net : m_dynamicRatsnestCache->m_nets )
     {
-        auto dynNet = aDynamicData->m_nets[nc];
+        RN_DYNAMIC_LINE l;
 
-        if( dynNet->GetNodeCount() != 0 )
+        if( net.second.NearestBicoloredPair( *aDynamicData->m_nets[net.first], l.a, l.b ) )
         {
-            auto ourNet = m_nets[nc];
-            CN_ANCHOR_PTR nodeA, nodeB;
-
-            if( ourNet->NearestBicoloredPair( *dynNet, nodeA, nodeB ) )
-            {
-                RN_DYNAMIC_LINE l;
-                l.a = nodeA->Pos();
-                l.b = nodeB->Pos();
-                l.netCode = nc;
-
-                m_dynamicRatsnest.push_back( l );
-            }
+            l.netCode = net.first;
+            m_dynamicRatsnest.push_back( l );
         }
     }
 
     // This gets the ratsnest for internal connections in the moving set
-    const auto& edges = GetRatsnestForItems( aItems );
-
-    for( const auto& edge : edges )
+    for( const auto& edge : m_dynamicRatsnestCache->m_internalEdges )
     {
-        const auto& nodeA   = edge.GetSourceNode();
-        const auto& nodeB   = edge.GetTargetNode();
         RN_DYNAMIC_LINE l;
 
         // Use the parents' positions
-        l.a = nodeA->Parent()->GetPosition();
-        l.b = nodeB->Parent()->GetPosition();
+        l.a = edge.first->GetPosition();
+        l.b = edge.second->GetPosition();
         l.netCode = 0;
         m_dynamicRatsnest.push_back( l );
     }
@@ -329,6 +398,7 @@ void CONNECTIVITY_DATA::ClearDynamicRatsnest()
                                {
                                    anchor.SetNoLine( false );
                                } );
+    m_dynamicRatsnestCache.reset();
     HideDynamicRatsnest();
 }
 
@@ -601,12 +671,12 @@ bool CONNECTIVITY_DATA::TestTrackEndpointDangling( TRACK* aTrack, wxPoint* aPos
     if( !citem->Valid() )
         return false;
 
-    for( const std::shared_ptr<CN_ANCHOR>& anchor : citem->Anchors() )
+    for( const CN_ANCHOR& anchor : citem->Anchors() )
     {
-        if( anchor->IsDangling() )
+        if( anchor.IsDangling() )
         {
             if( aPos )
-                *aPos = static_cast<wxPoint>( anchor->Pos() );
+                *aPos = static_cast<wxPoint>( anchor.Pos() );
 
             return true;
         }
@@ -655,9 +725,9 @@ const std::vector<BOARD_CONNECTED_ITEM*> CONNECTIVITY_DATA::GetConnectedItemsAtA
     {
         for( auto connected : cnItem->ConnectedItems() )
         {
-            for( auto anchor : connected->Anchors() )
+            for( const CN_ANCHOR& anchor : connected->Anchors() )
             {
-                if( anchor->Pos() == aAnchor )
+                if( anchor.Pos() == aAnchor )
                 {
                     for( int i = 0; aTypes[i] > 0; i++ )
                     {
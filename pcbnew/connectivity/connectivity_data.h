@@ -42,6 +42,7 @@
 class FROM_TO_CACHE;
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
+class CN_ZONE_PARTITION_CACHE;
 class CN_EDGE;
 class BOARD;
 class BOARD_COMMIT;
@@ -228,6 +229,11 @@ public:
      * Function ComputeDynamicRatsnest()
      * Calculates the temporary dynamic ratsnest (i.e. the ratsnest lines that)
      * for the set of items aItems.
+     *
+     * The static anchors of the nets touched by aDynamicData and the internal connections of
+     * aItems are gathered on the first call for a given aDynamicData and reused by the next
+     * ones, which only move the selection.  The cache is dropped by BlockRatsnestItems() and
+     * ClearDynamicRatsnest().
      */
     void ComputeDynamicRatsnest( const std::vector<BOARD_ITEM*>& aItems,
                                  const CONNECTIVITY_DATA* aDynamicData );
@@ -299,9 +305,18 @@ private:
     void    updateItemPositions( const std::vector<BOARD_ITEM*>& aItems );
     void    addRatsnestCluster( const std::shared_ptr<CN_CLUSTER>& aCluster );
 
+    struct DYNAMIC_RATSNEST_CACHE;
+
+    void    buildDynamicRatsnestCache( const std::vector<BOARD_ITEM*>& aItems,
+                                       const CONNECTIVITY_DATA* aDynamicData );
+
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
+
+    ///< Zone partitions kept across the rebuilds of m_connAlgo (null for temporary data)
+    std::shared_ptr<CN_ZONE_PARTITION_CACHE> m_zonePartitionCache;
     std::shared_ptr<FROM_TO_CACHE> m_fromToCache;
     std::vector<RN_DYNAMIC_LINE> m_dynamicRatsnest;
+    std::unique_ptr<DYNAMIC_RATSNEST_CACHE> m_dynamicRatsnestCache;
     std::vector<RN_NET*> m_nets;
 
     PROGRESS_REPORTER* m_progressReporter;
@@ -29,6 +29,8 @@
 #include <macros.h>
 #include <connectivity/connectivity_items.h>
 
+#include <set>
+
 int CN_ITEM::AnchorCount() const
 {
     if( !m_valid )
@@ -187,6 +189,100 @@ const VECTOR2I CN_ZONE_LAYER::GetAnchor( int n ) const
 }
 
 
+CN_ZONE_PARTITION_CACHE::PARTITIONS
+CN_ZONE_PARTITION_CACHE::BuildPartitions( const SHAPE_POLY_SET& aFill )
+{
+    PARTITIONS partitions;
+
+    partitions.reserve( aFill.OutlineCount() );
+
+    for( int ii = 0; ii < aFill.OutlineCount(); ii++ )
+    {
+        SHAPE_LINE_CHAIN outline = aFill.COutline( ii );
+
+        outline.SetClosed( true );
+        outline.Simplify();
+
+        partitions.push_back( std::make_shared<const POLY_GRID_PARTITION>( outline ) );
+    }
+
+    return partitions;
+}
+
+
+CN_ZONE_PARTITION_CACHE::PARTITIONS CN_ZONE_PARTITION_CACHE::Get( const ZONE* aZone,
+                                                                  PCB_LAYER_ID aLayer )
+{
+    const SHAPE_POLY_SET& fill = aZone->GetFilledPolysList( aLayer );
+
+    // SHAPE_POLY_SET::GetHash() may return the hash cached at the last triangulation, which
+    // isn't updated by edits such as the removal of islands, so hash the outlines here.
+    MD5_HASH hash;
+
+    hash.Hash( fill.OutlineCount() );
+
+    for( int ii = 0; ii < fill.OutlineCount(); ii++ )
+    {
+        const SHAPE_LINE_CHAIN& outline = fill.COutline( ii );
+
+        hash.Hash( outline.PointCount() );
+
+        for( const VECTOR2I& pt : outline.CPoints() )
+        {
+            hash.Hash( pt.x );
+            hash.Hash( pt.y );
+        }
+    }
+
+    hash.Finalize();
+
+    auto key = std::make_pair( aZone, aLayer );
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        auto                        it = m_entries.find( key );
+
+        if( it != m_entries.end() && it->second.m_hash == hash )
+            return it->second.m_partitions;
+    }
+
+    ENTRY entry;
+    entry.m_hash = hash;
+    entry.m_partitions = BuildPartitions( fill );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+    m_entries[key] = entry;
+
+    return entry.m_partitions;
+}
+
+
+void CN_ZONE_PARTITION_CACHE::Prune( const std::vector<ZONE*>& aZones )
+{
+    std::set<const ZONE*> zones( aZones.begin(), aZones.end() );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        if( zones.count( it->first.first ) )
+            ++it;
+        else
+            it = m_entries.erase( it );
+    }
+}
+
+
+std::mutex& CN_ITEM::connectionLock() const
+{
+    // Enough stripes to keep the connection threads from contending, without giving each
+    // of the (potentially hundreds of thousands of) items its own mutex
+    static std::mutex locks[256];
+
+    return locks[ ( reinterpret_cast<uintptr_t>( this ) / sizeof( CN_ITEM ) ) % 256 ];
+}
+
+
 void CN_ITEM::RemoveInvalidRefs()
 {
     for( auto it = m_connected.begin(); it != m_connected.end(); )
@@ -204,7 +300,7 @@ CN_ITEM* CN_LIST::Add( PAD* pad )
     if( !pad->IsOnCopperLayer() )
          return nullptr;
 
-     auto item = new CN_ITEM( pad, false, 1 );
+     auto item = m_itemPool.Alloc( pad, false, 1 );
      item->AddAnchor( pad->ShapePos() );
      item->SetLayers( LAYER_RANGE( F_Cu, B_Cu ) );
 
@@ -238,7 +334,7 @@ CN_ITEM* CN_LIST::Add( PAD* pad )
 
 CN_ITEM* CN_LIST::Add( TRACK* track )
 {
-    auto item = new CN_ITEM( track, true );
+    auto item = m_itemPool.Alloc( track, true );
     m_items.push_back( item );
     item->AddAnchor( track->GetStart() );
     item->AddAnchor( track->GetEnd() );
@@ -250,7 +346,7 @@ CN_ITEM* CN_LIST::Add( TRACK* track )
 
 CN_ITEM* CN_LIST::Add( ARC* aArc )
 {
-    auto item = new CN_ITEM( aArc, true );
+    auto item = m_itemPool.Alloc( aArc, true );
     m_items.push_back( item );
     item->AddAnchor( aArc->GetStart() );
     item->AddAnchor( aArc->GetEnd() );
@@ -262,7 +358,7 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
 
  CN_ITEM* CN_LIST::Add( VIA* via )
  {
-     auto item = new CN_ITEM( via, !via->GetIsFree(), 1 );
+     auto item = m_itemPool.Alloc( via, !via->GetIsFree(), 1 );
 
      m_items.push_back( item );
      item->AddAnchor( via->GetStart() );
@@ -279,9 +375,13 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
 
      std::vector<CN_ITEM*> rv;
 
+     CN_ZONE_PARTITION_CACHE::PARTITIONS partitions =
+             m_zonePartitionCache ? m_zonePartitionCache->Get( zone, aLayer )
+                                  : CN_ZONE_PARTITION_CACHE::BuildPartitions( polys );
+
      for( int j = 0; j < polys.OutlineCount(); j++ )
      {
-         CN_ZONE_LAYER* zitem = new CN_ZONE_LAYER( zone, aLayer, false, j );
+         CN_ZONE_LAYER* zitem = m_zonePool.Alloc( zone, aLayer, false, j, partitions[j] );
          const auto& outline = zone->GetFilledPolysList( aLayer ).COutline( j );
 
          for( int k = 0; k < outline.PointCount(); k++ )
@@ -298,6 +398,15 @@ CN_ITEM* CN_LIST::Add( ARC* aArc )
  }
 
 
+void CN_LIST::Free( CN_ITEM* aItem )
+{
+    if( CN_ZONE_LAYER* zoneLayer = dynamic_cast<CN_ZONE_LAYER*>( aItem ) )
+        m_zonePool.Free( zoneLayer );
+    else
+        m_itemPool.Free( aItem );
+}
+
+
 void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 {
     if( !m_hasInvalid )
@@ -41,6 +41,9 @@
 #include <memory>
 #include <algorithm>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 #include <deque>
 #include <intrusive_list.h>
@@ -160,8 +163,14 @@ private:
 };
 
 
-typedef std::shared_ptr<CN_ANCHOR>  CN_ANCHOR_PTR;
-typedef std::vector<CN_ANCHOR_PTR>  CN_ANCHORS;
+/**
+ * Anchors are stored by value in their owning CN_ITEM, which never moves once created, so a
+ * plain pointer is enough to refer to them for as long as the item is alive.  Removed items are
+ * kept alive until the ratsnest stops referring to them (see
+ * CN_CONNECTIVITY_ALGO::ReleaseGarbage()).
+ */
+typedef CN_ANCHOR*               CN_ANCHOR_PTR;
+typedef std::vector<CN_ANCHOR>   CN_ANCHORS;
 
 
 // basic connectivity item
@@ -179,16 +188,23 @@ public:
         m_visited = false;
         m_valid = true;
         m_dirty = true;
-        m_anchors.reserve( std::max( 6, aAnchorCount ) );
+        m_anchors.reserve( aAnchorCount );
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
         m_connected.reserve( 8 );
     }
 
     virtual ~CN_ITEM() {};
 
+    /**
+     * Add an anchor to the item.
+     *
+     * Anchors are referred to by address, so all of them must be added right after the item
+     * is created, within the anchor count it was constructed with.
+     */
     void AddAnchor( const VECTOR2I& aPos )
     {
-        m_anchors.emplace_back( std::make_shared<CN_ANCHOR>( aPos, this ) );
+        wxASSERT( m_anchors.size() < m_anchors.capacity() );
+        m_anchors.emplace_back( aPos, this );
     }
 
     CN_ANCHORS& Anchors() { return m_anchors; }
@@ -252,11 +268,18 @@ public:
     void SetVisited( bool aVisited ) { m_visited = aVisited; }
     bool Visited() const { return m_visited; }
 
+    /**
+     * Set the net of the ratsnest cluster the item was last placed in.  That cluster, and the
+     * ratsnest built from it, refer to the item until the net is rebuilt.
+     */
+    void SetClusterNet( int aNet ) { m_clusterNet = aNet; }
+    int ClusterNet() const { return m_clusterNet; }
+
     bool CanChangeNet() const { return m_canChangeNet; }
 
     void Connect( CN_ITEM* b )
     {
-        std::lock_guard<std::mutex> lock( m_listLock );
+        std::lock_guard<std::mutex> lock( connectionLock() );
 
         auto i = std::lower_bound( m_connected.begin(), m_connected.end(), b );
 
@@ -275,7 +298,7 @@ public:
     {
         return ( !m_parent || !m_valid ) ? -1 : m_parent->GetNetCode();
     }
-                                     ///< allow parallel connection threads
+
 protected:
     bool            m_dirty;         ///< used to identify recently added item not yet
                                      ///< scanned into the connectivity search
@@ -291,27 +314,70 @@ private:
     bool            m_canChangeNet;  ///< can the net propagator modify the netcode?
 
     bool            m_visited;       ///< visited flag for the BFS scan
+    int             m_clusterNet = -1; ///< net of the ratsnest cluster holding the item
     bool            m_valid;         ///< used to identify garbage items (we use lazy removal)
 
-    std::mutex      m_listLock;      ///< mutex protecting this item's connected_items set to
+    /**
+     * Return the mutex protecting this item's connected items list, to allow parallel
+     * connection threads.  Items share a small fixed set of mutexes rather than carrying one
+     * each.
+     */
+    std::mutex& connectionLock() const;
 };
 
 typedef std::shared_ptr<CN_ITEM> CN_ITEM_PTR;
 
+/**
+ * Keep the point-in-polygon partitions of the zone fills across connectivity rebuilds.
+ *
+ * Partitioning the outlines is the bulk of the cost of adding a large zone to the
+ * connectivity.  As long as the fill of a zone layer hashes the same, the partitions built
+ * for it the previous time are handed out again.
+ */
+class CN_ZONE_PARTITION_CACHE
+{
+public:
+    using PARTITIONS = std::vector<std::shared_ptr<const POLY_GRID_PARTITION>>;
+
+    /**
+     * Return the partitions of the outlines of the fill of \a aZone on \a aLayer, in outline
+     * order.  Thread safe.
+     */
+    PARTITIONS Get( const ZONE* aZone, PCB_LAYER_ID aLayer );
+
+    /**
+     * Forget the zones which are not in \a aZones (i.e. deleted from the board).
+     */
+    void Prune( const std::vector<ZONE*>& aZones );
+
+    /**
+     * Build the partitions of the outlines of \a aFill, without caching them.
+     */
+    static PARTITIONS BuildPartitions( const SHAPE_POLY_SET& aFill );
+
+private:
+    struct ENTRY
+    {
+        MD5_HASH   m_hash;
+        PARTITIONS m_partitions;
+    };
+
+    std::map<std::pair<const ZONE*, PCB_LAYER_ID>, ENTRY> m_entries;
+    std::mutex                                             m_lock;
+};
+
+
 class CN_ZONE_LAYER : public CN_ITEM
 {
 public:
-    CN_ZONE_LAYER( ZONE* aParent, PCB_LAYER_ID aLayer, bool aCanChangeNet, int aSubpolyIndex ) :
-            CN_ITEM( aParent, aCanChangeNet ),
+    CN_ZONE_LAYER( ZONE* aParent, PCB_LAYER_ID aLayer, bool aCanChangeNet, int aSubpolyIndex,
+                   std::shared_ptr<const POLY_GRID_PARTITION> aPartition ) :
+            CN_ITEM( aParent, aCanChangeNet,
+                     aParent->GetFilledPolysList( aLayer ).COutline( aSubpolyIndex ).PointCount() ),
+            m_cachedPoly( std::move( aPartition ) ),
             m_subpolyIndex( aSubpolyIndex ),
             m_layer( aLayer )
     {
-        SHAPE_LINE_CHAIN outline = aParent->GetFilledPolysList( aLayer ).COutline( aSubpolyIndex );
-
-        outline.SetClosed( true );
-        outline.Simplify();
-
-        m_cachedPoly = std::make_unique<POLY_GRID_PARTITION>( outline, 16 );
     }
 
     int SubpolyIndex() const
@@ -319,7 +385,7 @@ public:
         return m_subpolyIndex;
     }
 
-    bool ContainsAnchor( const CN_ANCHOR_PTR anchor ) const
+    bool ContainsAnchor( const CN_ANCHOR* anchor ) const
     {
         return ContainsPoint( anchor->Pos(), 0 );
     }
@@ -335,6 +401,20 @@ public:
         return m_cachedPoly->ContainsPoint( p, clearance );
     }
 
+    /**
+     * Same as ContainsPoint() for a set of points, true if any of them is inside.
+     */
+    bool ContainsAnyPoint( const std::vector<VECTOR2I>& aPoints, int aAccuracy = 0 ) const
+    {
+        ZONE* zone = static_cast<ZONE*>( Parent() );
+        int clearance = aAccuracy;
+
+        if( zone->GetFilledPolysUseThickness() )
+            clearance += ( zone->GetMinThickness() + 1 ) / 2;
+
+        return m_cachedPoly->ContainsAnyPoint( aPoints, clearance );
+    }
+
     const BOX2I& BBox()
     {
         if( m_dirty )
@@ -347,12 +427,67 @@ public:
     virtual const VECTOR2I GetAnchor( int n ) const override;
 
 private:
-    std::vector<VECTOR2I>                m_testOutlinePoints;
-    std::unique_ptr<POLY_GRID_PARTITION> m_cachedPoly;
-    int                                  m_subpolyIndex;
-    PCB_LAYER_ID                         m_layer;
+    std::vector<VECTOR2I>                      m_testOutlinePoints;
+    std::shared_ptr<const POLY_GRID_PARTITION> m_cachedPoly;
+    int                                        m_subpolyIndex;
+    PCB_LAYER_ID                               m_layer;
 };
 
+/**
+ * A pool of connectivity items of a single type.
+ *
+ * Items are constructed in place in large chunks rather than allocated one by one, and never
+ * move, so pointers to them stay valid until they are freed.  Freed slots are reused by later
+ * allocations.  The pool is not thread safe.
+ */
+template <class T>
+class CN_POOL
+{
+public:
+    CN_POOL( size_t aChunkSize = 1024 ) :
+            m_chunkSize( aChunkSize )
+    {}
+
+    CN_POOL( const CN_POOL& ) = delete;
+    CN_POOL& operator=( const CN_POOL& ) = delete;
+
+    template <typename... ARGS>
+    T* Alloc( ARGS&&... aArgs )
+    {
+        if( m_free.empty() )
+            addChunk();
+
+        void* slot = m_free.back();
+        m_free.pop_back();
+
+        return new( slot ) T( std::forward<ARGS>( aArgs )... );
+    }
+
+    void Free( T* aItem )
+    {
+        aItem->~T();
+        m_free.push_back( aItem );
+    }
+
+private:
+    using SLOT = typename std::aligned_storage<sizeof( T ), alignof( T )>::type;
+
+    void addChunk()
+    {
+        m_chunks.emplace_back( new SLOT[m_chunkSize] );
+        SLOT* chunk = m_chunks.back().get();
+
+        // Hand out the slots in address order
+        for( size_t i = m_chunkSize; i > 0; i-- )
+            m_free.push_back( &chunk[i - 1] );
+    }
+
+    size_t                               m_chunkSize;
+    std::vector<std::unique_ptr<SLOT[]>> m_chunks;
+    std::vector<void*>                   m_free;
+};
+
+
 class CN_LIST
 {
 protected:
@@ -364,21 +499,33 @@ protected:
     }
 
 public:
-    CN_LIST()
+    CN_LIST() :
+            m_zonePool( 64 )
     {
         m_dirty = false;
         m_hasInvalid = false;
     }
 
+    ~CN_LIST()
+    {
+        Clear();
+    }
+
     void Clear()
     {
         for( auto item : m_items )
-            delete item;
+            Free( item );
 
         m_items.clear();
         m_index.RemoveAll();
     }
 
+    /**
+     * Destroy an item created by this list, once it is no longer referenced (see
+     * RemoveInvalidItems()).
+     */
+    void Free( CN_ITEM* aItem );
+
     using ITER       = decltype( m_items )::iterator;
     using CONST_ITER = decltype( m_items )::const_iterator;
 
@@ -441,11 +588,30 @@ public:
 
     const std::vector<CN_ITEM*> Add( ZONE* zone, PCB_LAYER_ID aLayer );
 
+    /**
+     * Set the cache the partitions of the zones are taken from; without one they are built
+     * each time a zone is added.
+     */
+    void SetZonePartitionCache( std::shared_ptr<CN_ZONE_PARTITION_CACHE> aCache )
+    {
+        m_zonePartitionCache = std::move( aCache );
+    }
+
+    const std::shared_ptr<CN_ZONE_PARTITION_CACHE>& GetZonePartitionCache() const
+    {
+        return m_zonePartitionCache;
+    }
+
 private:
     bool                  m_dirty;
     bool                  m_hasInvalid;
 
+    std::shared_ptr<CN_ZONE_PARTITION_CACHE> m_zonePartitionCache;
+
     CN_RTREE<CN_ITEM*>    m_index;
+
+    CN_POOL<CN_ITEM>       m_itemPool;
+    CN_POOL<CN_ZONE_LAYER> m_zonePool;
 };
 
 class CN_CLUSTER
@@ -17,6 +17,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
 #include <reporter.h>
@@ -118,7 +119,15 @@ static PATH_STATUS uniquePathBetweenNodes( CN_ITEM* u, CN_ITEM* v, std::vector<C
 };
 
 
-int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo )
+bool FROM_TO_CACHE::FT_PATH::Contains( BOARD_CONNECTED_ITEM* aItem ) const
+{
+    return std::binary_search( pathItems.begin(), pathItems.end(), aItem,
+                               std::less<BOARD_CONNECTED_ITEM*>() );
+}
+
+
+int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo,
+                                     std::vector<FT_PATH>& aPaths, const std::set<int>* aNets )
 {
     std::vector<FT_PATH> paths;
     auto connectivity = m_board->GetConnectivity();
@@ -126,6 +135,9 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
 
     for( auto& endpoint : m_ftEndpoints )
     {
+        if( aNets && !aNets->count( endpoint.parent->GetNetCode() ) )
+            continue;
+
         if( WildCompareString( aFrom, endpoint.name, false ) )
         {
             FT_PATH p;
@@ -213,12 +225,17 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
         if( result == PS_NO_PATH )
             continue;
 
+        path.pathItems.reserve( upath.size() );
+
         for( const auto item : upath )
-        {
-            path.pathItems.insert( item->Parent() );
-        }
+            path.pathItems.push_back( item->Parent() );
+
+        std::sort( path.pathItems.begin(), path.pathItems.end(),
+                   std::less<BOARD_CONNECTED_ITEM*>() );
+        path.pathItems.erase( std::unique( path.pathItems.begin(), path.pathItems.end() ),
+                              path.pathItems.end() );
 
-        m_ftPaths.push_back(path);
+        aPaths.push_back( std::move( path ) );
         newPaths++;
     }
 
@@ -227,36 +244,31 @@ int FROM_TO_CACHE::cacheFromToPaths( const wxString& aFrom, const wxString& aTo
     return newPaths;
 }
 
-bool  FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo )
+bool FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom,
+                                    const wxString& aTo )
 {
-    int nFromTosFound = 0;
-
     if( !m_board )
         return false;
 
-    //printf("Check %d cached paths [%p]\n", m_ftPaths.size(), aItem );
-    for( int attempt = 0; attempt < 2; attempt++ )
-    {
-        // item already belongs to path
-        for( auto& ftPath : m_ftPaths )
-        {
-            if( aFrom == ftPath.fromWildcard &&
-                    aTo == ftPath.toWildcard )
-                {
-                    nFromTosFound++;
+    std::lock_guard<std::mutex> lock( m_lock );
 
-                    if( ftPath.pathItems.count( aItem ) )
-                    {
-            //            printf("Found cached path for %p [%s->%s]\n", aItem, (const char *)ftPath.fromName, (const char *) ftPath.toName );
-                        return true;
-                    }
-                }
-        }
+    updateDirtyNets();
 
-        if( !nFromTosFound )
-            cacheFromToPaths( aFrom, aTo );
-        else
-            return false;
+    WILDCARDS key( aFrom, aTo );
+    auto      it = m_ftPaths.find( key );
+
+    // Remember the wildcards even when no path matches them, so that they aren't searched
+    // again on every query
+    if( it == m_ftPaths.end() )
+    {
+        it = m_ftPaths.emplace( key, std::vector<FT_PATH>() ).first;
+        cacheFromToPaths( aFrom, aTo, it->second );
+    }
+
+    for( const FT_PATH& ftPath : it->second )
+    {
+        if( ftPath.Contains( aItem ) )
+            return true;
     }
 
     return false;
@@ -265,19 +277,88 @@ bool  FROM_TO_CACHE::IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString
 
 void FROM_TO_CACHE::Rebuild( BOARD* aBoard )
 {
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    std::vector<FT_ENDPOINT> prevEndpoints;
+    std::swap( prevEndpoints, m_ftEndpoints );
+
+    bool boardChanged = ( aBoard != m_board );
+
     m_board = aBoard;
     buildEndpointList();
-    m_ftPaths.clear();
+
+    // The paths refer to the pads by name and by pointer
+    if( boardChanged || prevEndpoints != m_ftEndpoints )
+        m_allDirty = true;
+
+    updateDirtyNets();
 }
 
 
-FROM_TO_CACHE::FT_PATH* FROM_TO_CACHE::QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems )
+void FROM_TO_CACHE::MarkNetDirty( int aNetCode )
 {
-    for( auto& ftPath : m_ftPaths )
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_dirtyNets.insert( aNetCode );
+}
+
+
+void FROM_TO_CACHE::MarkAllDirty()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_allDirty = true;
+}
+
+
+void FROM_TO_CACHE::updateDirtyNets()
+{
+    if( m_allDirty )
     {
-        if ( ftPath.pathItems == aItems )
-            return &ftPath;
+        m_ftPaths.clear();
+        m_dirtyNets.clear();
+        m_allDirty = false;
+        return;
     }
 
-    return nullptr;
-}
\ No newline at end of file
+    if( m_dirtyNets.empty() )
+        return;
+
+    for( auto& query : m_ftPaths )
+    {
+        std::vector<FT_PATH>& paths = query.second;
+
+        paths.erase( std::remove_if( paths.begin(), paths.end(),
+                                     [&]( const FT_PATH& aPath )
+                                     {
+                                         return m_dirtyNets.count( aPath.net ) > 0;
+                                     } ),
+                     paths.end() );
+
+        cacheFromToPaths( query.first.first, query.first.second, paths, &m_dirtyNets );
+    }
+
+    m_dirtyNets.clear();
+}
+
+
+OPT<FROM_TO_CACHE::FT_PATH> FROM_TO_CACHE::QueryFromToPath(
+        const std::set<BOARD_CONNECTED_ITEM*>& aItems )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( auto& query : m_ftPaths )
+    {
+        for( FT_PATH& ftPath : query.second )
+        {
+            if( ftPath.pathItems.size() == aItems.size()
+                    && std::equal( ftPath.pathItems.begin(), ftPath.pathItems.end(),
+                                   aItems.begin() ) )
+            {
+                return ftPath;
+            }
+        }
+    }
+
+    return NULLOPT;
+}
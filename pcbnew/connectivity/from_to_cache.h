@@ -20,11 +20,27 @@
 #ifndef __FROM_TO_CACHE_H
 #define __FROM_TO_CACHE_H
 
+#include <map>
+#include <mutex>
 #include <set>
+#include <utility>
+#include <vector>
 
+#include <wx/string.h>
+
+#include <core/optional.h>
+
+class BOARD;
 class PAD;
 class BOARD_CONNECTED_ITEM;
 
+/**
+ * Paths between the pads matched by the from/to wildcards of the fromTo() rule function.
+ *
+ * Paths are computed on the first query for a given pair of wildcards, then kept.  The
+ * connectivity reports the nets it changes through MarkNetDirty(); only the paths on those
+ * nets are searched again, on the next Rebuild() or query.
+ */
 class FROM_TO_CACHE
 {
 public:
@@ -33,6 +49,11 @@ public:
     {
         wxString name;
         PAD* parent;
+
+        bool operator==( const FT_ENDPOINT& aOther ) const
+        {
+            return parent == aOther.parent && name == aOther.name;
+        }
     };
 
     struct FT_PATH
@@ -43,10 +64,15 @@ public:
         wxString fromName, toName;
         wxString fromWildcard, toWildcard;
         bool     isUnique;
-        std::set<BOARD_CONNECTED_ITEM*> pathItems;
+
+        ///< Parents of the items along the path, sorted by address and without duplicates
+        std::vector<BOARD_CONNECTED_ITEM*> pathItems;
+
+        bool Contains( BOARD_CONNECTED_ITEM* aItem ) const;
     };
 
     FROM_TO_CACHE( BOARD* aBoard = nullptr ) :
+        m_allDirty( false ),
         m_board( aBoard )
     {
     }
@@ -55,18 +81,55 @@ public:
     {
     }
 
+    /**
+     * Bring the cache up to date with \a aBoard.  All the paths are dropped if the board or its
+     * pads changed (e.g. a footprint was added or renamed), otherwise only the paths on the
+     * nets marked dirty since the last update are searched again.
+     */
     void Rebuild( BOARD* aBoard );
+
+    /**
+     * Called by the connectivity when the items of net \a aNetCode change.
+     */
+    void MarkNetDirty( int aNetCode );
+
+    /**
+     * Drop all the paths, e.g. when the connectivity is built from scratch.
+     */
+    void MarkAllDirty();
+
     bool IsOnFromToPath( BOARD_CONNECTED_ITEM* aItem, const wxString& aFrom, const wxString& aTo );
 
-    FT_PATH* QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems );
+    /**
+     * Return the cached path made of \a aItems, if any.  The path is copied, as the cache may
+     * be updated from another thread as soon as the call returns.
+     */
+    OPT<FT_PATH> QueryFromToPath( const std::set<BOARD_CONNECTED_ITEM*>& aItems );
 
 private:
+    using WILDCARDS = std::pair<wxString, wxString>;
 
-    int cacheFromToPaths( const wxString& aFrom, const wxString& aTo );
+    /**
+     * Find the paths matching \a aFrom and \a aTo and add them to \a aPaths.
+     *
+     * @param aNets if not null, only the paths starting on these nets are searched.
+     */
+    int cacheFromToPaths( const wxString& aFrom, const wxString& aTo, std::vector<FT_PATH>& aPaths,
+                          const std::set<int>* aNets = nullptr );
     void buildEndpointList();
 
+    ///< Search again the paths on the dirty nets; m_lock must be held
+    void updateDirtyNets();
+
     std::vector<FT_ENDPOINT> m_ftEndpoints;
-    std::vector<FT_PATH> m_ftPaths;
+
+    ///< Paths found for each pair of from/to wildcards queried so far (including no path)
+    std::map<WILDCARDS, std::vector<FT_PATH>> m_ftPaths;
+
+    std::set<int> m_dirtyNets;
+    bool          m_allDirty;
+
+    std::mutex    m_lock;
 
     BOARD* m_board;
 };
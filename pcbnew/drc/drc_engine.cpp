@@ -36,6 +36,7 @@
 #include <geometry/shape.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_null.h>
+#include <perf_counters.h>
 
 void drcPrintDebugMessage( int level, const wxString& msg, const char *function, int line )
 {
@@ -59,6 +60,7 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_drawingSheet( nullptr ),
     m_schematicNetlist( nullptr ),
     m_rulesValid( false ),
+    m_rulesGeneration( 0 ),
     m_userUnits( EDA_UNITS::MILLIMETRES ),
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
@@ -610,6 +612,7 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
 
     m_rules.clear();
     m_rulesValid = false;
+    m_rulesGeneration++;
 
     for( std::pair<DRC_CONSTRAINT_T, std::vector<DRC_ENGINE_CONSTRAINT*>*> pair : m_constraintMap )
     {
@@ -651,6 +654,9 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
 
 void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aTestFootprints )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "drc.run_tests" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     m_userUnits = aUnits;
 
     // Note: set these first.  The phase counts may be dependent on some of them.
@@ -727,6 +733,9 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
 
         ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
 
+        SCOPED_PERF_TIMER providerTimer(
+                PERF_COUNTERS::Get( "drc.provider." + provider->GetName().ToStdString() ) );
+
         if( !provider->Run() )
             break;
     }
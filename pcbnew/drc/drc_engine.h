@@ -154,6 +154,12 @@ public:
 
     bool RulesValid() { return m_rulesValid; }
 
+    /**
+     * Return a number which changes every time the rules are (re)loaded, including the implicit
+     * netclass rules.  Lets callers caching the results of EvalRules() know when to drop them.
+     */
+    int RulesGeneration() const { return m_rulesGeneration; }
+
     void ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos );
     bool ReportProgress( double aProgress );
     bool ReportPhase( const wxString& aMessage );
@@ -215,6 +221,7 @@ protected:
 
     std::vector<DRC_RULE*>           m_rules;
     bool                             m_rulesValid;
+    int                              m_rulesGeneration;
     std::vector<DRC_TEST_PROVIDER*>  m_testProviders;
 
     EDA_UNITS                        m_userUnits;
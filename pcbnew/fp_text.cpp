@@ -407,6 +407,13 @@ double FP_TEXT::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+double FP_TEXT::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Texts a few pixels high can't be read, they are drawn as boxes
+    return GetTextHeight() > 0 ? (double) Millimeter2iu( 1.5 ) / GetTextHeight() : 0.0;
+}
+
+
 wxString FP_TEXT::GetShownText( int aDepth ) const
 {
     const FOOTPRINT* parentFootprint = static_cast<FOOTPRINT*>( GetParent() );
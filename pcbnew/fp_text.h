@@ -228,6 +228,8 @@ public:
 
     double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    double ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
 #if defined(DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const override { ShowDummy( os ); }
 #endif
@@ -1302,6 +1302,23 @@ double PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+double PAD::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Circles and rectangles are as simple as it gets, holes and netnames have their own LOD
+    if( GetShape() == PAD_SHAPE_CIRCLE || GetShape() == PAD_SHAPE_RECT )
+        return 0.0;
+
+    if( IsHoleLayer( aLayer ) || IsNetnameLayer( aLayer ) )
+        return 0.0;
+
+    // Pads a few pixels wide are drawn as rectangles
+    EDA_RECT bbox = GetBoundingBox();
+    int      size = std::min( bbox.GetWidth(), bbox.GetHeight() );
+
+    return size > 0 ? (double) Millimeter2iu( 1 ) / size : 0.0;
+}
+
+
 const BOX2I PAD::ViewBBox() const
 {
     // Bounding box includes soldermask too. Remember mask and/or paste
@@ -652,6 +652,8 @@ public:
 
     double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    double ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
     virtual const BOX2I ViewBBox() const override;
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
@@ -44,11 +44,12 @@
 #include <confirm.h>
 
 #include <gal/graphics_abstraction_layer.h>
+#include <thread_pool.h>
 #include <zoom_defines.h>
 
 #include <functional>
+#include <future>
 #include <memory>
-#include <thread>
 
 using namespace std::placeholders;
 
@@ -181,23 +182,12 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 
     m_view->Clear();
 
-    auto zones = aBoard->Zones();
-    std::atomic<size_t> next( 0 );
-    std::atomic<size_t> count_done( 0 );
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+    THREAD_POOL&                   pool = THREAD_POOL::Instance();
+    std::vector<std::future<void>> triangulations;
 
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [ &count_done, &next, &zones ]( )
-        {
-            for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
-
-            count_done++;
-        } );
-
-        t.detach();
-    }
+    // Zones are triangulated on the thread pool while the other items are added
+    for( ZONE* zone : aBoard->Zones() )
+        triangulations.push_back( pool.Submit( [zone]() { zone->CacheTriangulation(); } ) );
 
     if( m_drawingSheet )
         m_drawingSheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
@@ -218,9 +208,8 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     for( PCB_MARKER* marker : aBoard->Markers() )
         m_view->Add( marker );
 
-    // Finalize the triangulation threads
-    while( count_done < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for( std::future<void>& triangulation : triangulations )
+        triangulation.wait();
 
     // Load zones
     for( ZONE* zone : aBoard->Zones() )
@@ -378,6 +378,24 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    PCB_PAINTER* painter = new PCB_PAINTER( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
+bool PCB_PAINTER::CanDrawConcurrently( const VIEW_ITEM* aItem ) const
+{
+    const EDA_ITEM* item = dynamic_cast<const EDA_ITEM*>( aItem );
+
+    // The box of a group is made of the boxes of its members, cached by the members
+    return !item || item->Type() != PCB_GROUP_T;
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -390,6 +408,20 @@ int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 }
 
 
+void PCB_PAINTER::drawTextBox( const EDA_TEXT* aText, double aAngle )
+{
+    VECTOR2D position( aText->GetTextPos() );
+    EDA_RECT box = aText->GetTextBox();
+
+    m_gal->Save();
+    m_gal->Translate( position );
+    m_gal->Rotate( -aAngle );
+    m_gal->DrawRectangle( VECTOR2D( box.GetOrigin() ) - position,
+                          VECTOR2D( box.GetEnd() ) - position );
+    m_gal->Restore();
+}
+
+
 int PCB_PAINTER::getDrillShape( const PAD* aPad ) const
 {
     return aPad->GetDrillShape();
@@ -570,7 +602,17 @@ void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
         m_gal->SetIsFill( not outline_mode );
         m_gal->SetLineWidth( m_pcbSettings.m_outlineWidth );
 
-        m_gal->DrawSegment( start, end, width );
+        if( m_pcbSettings.GetDetailLevel() > 0 && !outline_mode )
+        {
+            // The round ends are too small to be seen, a plain line is enough
+            m_gal->SetIsStroke( true );
+            m_gal->SetLineWidth( width );
+            m_gal->DrawLine( start, end );
+        }
+        else
+        {
+            m_gal->DrawSegment( start, end, width );
+        }
     }
 
     // Clearance lines
@@ -614,7 +656,18 @@ void PCB_PAINTER::draw( const ARC* aArc, int aLayer )
         m_gal->SetIsFill( not outline_mode );
         m_gal->SetLineWidth( m_pcbSettings.m_outlineWidth );
 
-        m_gal->DrawArcSegment( center, radius, start_angle, start_angle + angle, width );
+        if( m_pcbSettings.GetDetailLevel() > 0 && !outline_mode )
+        {
+            // The round ends are too small to be seen, a plain arc is enough
+            m_gal->SetIsFill( false );
+            m_gal->SetIsStroke( true );
+            m_gal->SetLineWidth( width );
+            m_gal->DrawArc( center, radius, start_angle, start_angle + angle );
+        }
+        else
+        {
+            m_gal->DrawArcSegment( center, radius, start_angle, start_angle + angle, width );
+        }
     }
 
     // Clearance lines
@@ -646,6 +699,10 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     if( color == COLOR4D::CLEAR )
         return;
 
+    // Vias too small on screen are drawn as plain disks, without their hole
+    if( m_pcbSettings.GetDetailLevel() > 0 && IsHoleLayer( aLayer ) )
+        return;
+
     // Draw description layer
     if( IsNetnameLayer( aLayer ) )
     {
@@ -732,7 +789,8 @@ void PCB_PAINTER::draw( const VIA* aVia, int aLayer )
     {
         m_gal->DrawCircle( center, getDrillSize( aVia ) / 2.0 );
     }
-    else if( aLayer == LAYER_VIA_THROUGH || m_pcbSettings.GetDrawIndividualViaLayers() )
+    else if( aLayer == LAYER_VIA_THROUGH || m_pcbSettings.GetDrawIndividualViaLayers()
+             || m_pcbSettings.GetDetailLevel() > 0 )
     {
         m_gal->DrawCircle( center, aVia->GetWidth() / 2.0 );
     }
@@ -976,8 +1034,46 @@ void PCB_PAINTER::draw( const PAD* aPad, int aLayer )
         std::unique_ptr<PAD>            dummyPad;
         std::shared_ptr<SHAPE_COMPOUND> shapes;
         bool                            simpleShapes = true;
+        bool                            coarse = m_pcbSettings.GetDetailLevel() > 0;
+
+        if( coarse )
+        {
+            // Pads too small on screen to show their shape are drawn as rectangles
+            SHAPE_SIMPLE rect;
+
+            if( aPad->GetShape() == PAD_SHAPE_CUSTOM )
+            {
+                EDA_RECT bbox = aPad->GetBoundingBox();
+                bbox.Inflate( margin.x );
 
-        if( margin.x != margin.y && aPad->GetShape() != PAD_SHAPE_CUSTOM )
+                if( bbox.GetWidth() <= 0 || bbox.GetHeight() <= 0 )
+                    return;
+
+                rect.Append( bbox.GetOrigin() );
+                rect.Append( bbox.GetRight(), bbox.GetTop() );
+                rect.Append( bbox.GetEnd() );
+                rect.Append( bbox.GetLeft(), bbox.GetBottom() );
+            }
+            else
+            {
+                wxSize half = pad_size / 2 + margin;
+
+                if( half.x <= 0 || half.y <= 0 )
+                    return;
+
+                for( wxPoint corner : { wxPoint( -half.x, -half.y ), wxPoint( half.x, -half.y ),
+                                        wxPoint( half.x, half.y ), wxPoint( -half.x, half.y ) } )
+                {
+                    RotatePoint( &corner, aPad->GetOrientation() );
+                    rect.Append( corner + aPad->ShapePos() );
+                }
+            }
+
+            shapes = std::make_shared<SHAPE_COMPOUND>();
+            shapes->AddShape( rect.Clone() );
+            margin.x = margin.y = 0;
+        }
+        else if( margin.x != margin.y && aPad->GetShape() != PAD_SHAPE_CUSTOM )
         {
             // Our algorithms below (polygon inflation in particular) can't handle differential
             // inflation along separate axes.  So for those cases we build a dummy pad instead,
@@ -1001,7 +1097,7 @@ void PCB_PAINTER::draw( const PAD* aPad, int aLayer )
         for( const SHAPE* shape : shapes->Shapes() )
         {
             // Drawing components of compound shapes in outline mode produces a mess.
-            if( m_pcbSettings.m_sketchMode[LAYER_PADS_TH] )
+            if( m_pcbSettings.m_sketchMode[LAYER_PADS_TH] && !coarse )
                 simpleShapes = false;
 
             if( !simpleShapes )
@@ -1401,6 +1497,16 @@ void PCB_PAINTER::draw( const PCB_TEXT* aText, int aLayer )
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
+
+    if( m_pcbSettings.GetDetailLevel() > 0 )
+    {
+        m_gal->SetFillColor( color );
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        drawTextBox( aText, aText->GetTextAngleRadians() );
+        return;
+    }
+
     m_gal->SetTextAttributes( aText );
     m_gal->StrokeText( shownText, position, aText->GetTextAngleRadians() );
 }
@@ -1430,8 +1536,19 @@ void PCB_PAINTER::draw( const FP_TEXT* aText, int aLayer )
     m_gal->SetStrokeColor( color );
     m_gal->SetIsFill( false );
     m_gal->SetIsStroke( true );
-    m_gal->SetTextAttributes( aText );
-    m_gal->StrokeText( shownText, position, aText->GetDrawRotationRadians() );
+
+    if( m_pcbSettings.GetDetailLevel() > 0 )
+    {
+        m_gal->SetFillColor( color );
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        drawTextBox( aText, aText->GetDrawRotationRadians() );
+    }
+    else
+    {
+        m_gal->SetTextAttributes( aText );
+        m_gal->StrokeText( shownText, position, aText->GetDrawRotationRadians() );
+    }
 
     // Draw the umbilical line
     if( aText->IsSelected() )
@@ -1624,7 +1741,21 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
-        m_gal->DrawPolygon( polySet );
+        int level = m_pcbSettings.GetDetailLevel();
+
+        if( level > 0 )
+        {
+            // Zones too small on screen to show their details are drawn from decimated outlines
+            SHAPE_POLY_SET decimated = polySet.Decimated( aZone->GetCoarseTolerance( level ) );
+
+            // OpenGL draws filled polygons from their triangulation
+            decimated.CacheTriangulation();
+            m_gal->DrawPolygon( decimated );
+        }
+        else
+        {
+            m_gal->DrawPolygon( polySet );
+        }
     }
 }
 
@@ -35,6 +35,7 @@
 
 
 class EDA_ITEM;
+class EDA_TEXT;
 class PCB_DISPLAY_OPTIONS;
 class BOARD_ITEM;
 class ARC;
@@ -252,6 +253,12 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
+    /// @copydoc PAINTER::CanDrawConcurrently()
+    virtual bool CanDrawConcurrently( const VIEW_ITEM* aItem ) const override;
+
 protected:
     // Drawing functions for various types of PCB-specific items
     void draw( const TRACK* aTrack, int aLayer );
@@ -276,6 +283,14 @@ protected:
      */
     int getLineThickness( int aActualThickness ) const;
 
+    /**
+     * Draw the box of a text, instead of its glyphs, for texts too small on screen to be read.
+     *
+     * @param aText is the text.
+     * @param aAngle is the angle the text is drawn with, in radians.
+     */
+    void drawTextBox( const EDA_TEXT* aText, double aAngle );
+
     /**
      * Return drill shape of a pad.
      */
@@ -138,6 +138,13 @@ const EDA_RECT PCB_TEXT::GetBoundingBox() const
 }
 
 
+double PCB_TEXT::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Texts a few pixels high can't be read, they are drawn as boxes
+    return GetTextHeight() > 0 ? (double) Millimeter2iu( 1.5 ) / GetTextHeight() : 0.0;
+}
+
+
 void PCB_TEXT::Rotate( const wxPoint& aRotCentre, double aAngle )
 {
     wxPoint pt = GetTextPos();
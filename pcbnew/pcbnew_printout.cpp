@@ -296,6 +296,15 @@ KIGFX::PCB_PRINT_PAINTER::PCB_PRINT_PAINTER( GAL* aGal ) :
 }
 
 
+KIGFX::PAINTER* KIGFX::PCB_PRINT_PAINTER::Clone( GAL* aGal ) const
+{
+    PCB_PRINT_PAINTER* painter = new PCB_PRINT_PAINTER( *this );
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
 int KIGFX::PCB_PRINT_PAINTER::getDrillShape( const PAD* aPad ) const
 {
     return m_drillMarkReal ? KIGFX::PCB_PAINTER::getDrillShape( aPad ) : PAD_DRILL_SHAPE_CIRCLE;
@@ -87,6 +87,9 @@ class PCB_PRINT_PAINTER : public PCB_PAINTER
 public:
     PCB_PRINT_PAINTER( GAL* aGal );
 
+    /// @copydoc PAINTER::Clone()
+    PAINTER* Clone( GAL* aGal ) const override;
+
     /**
      * Set drill marks visibility and options.
      *
@@ -40,6 +40,7 @@ using namespace std::placeholders;
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <limits>
 
 #include <delaunator.hpp>
@@ -136,20 +137,33 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::multiset<CN_ANCHOR_PTR, CN_PTR_CMP> m_allNodes;
 
+    ///< An edge of the triangulation, between two indices of m_positions.
+    struct TRIANGULATION_EDGE
+    {
+        unsigned m_a;
+        unsigned m_b;
+        unsigned m_weight;
+    };
+
+    ///< The distinct node positions of the last triangulation, in m_allNodes order.
+    std::vector<VECTOR2I>           m_positions;
+
+    ///< The edges of the last triangulation, sorted by weight.
+    std::vector<TRIANGULATION_EDGE> m_edges;
 
     // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
     // have unique coordinates!
-    bool areNodesColinear( const std::vector<CN_ANCHOR_PTR>& aNodes ) const
+    bool areNodesColinear( const std::vector<VECTOR2I>& aNodes ) const
     {
         if ( aNodes.size() <= 2 )
             return true;
 
-        const VECTOR2I p0( aNodes[0]->Pos() );
-        const VECTOR2I v0( aNodes[1]->Pos() - p0 );
+        const VECTOR2I p0( aNodes[0] );
+        const VECTOR2I v0( aNodes[1] - p0 );
 
         for( unsigned i = 2; i < aNodes.size(); i++ )
         {
-            const VECTOR2I v1 = aNodes[i]->Pos() - p0;
+            const VECTOR2I v1 = aNodes[i] - p0;
 
             if( v0.Cross( v1 ) != 0 )
                 return false;
@@ -158,6 +172,60 @@ private:
         return true;
     }
 
+    void addEdge( unsigned aA, unsigned aB )
+    {
+        unsigned weight = ( m_positions[aA] - m_positions[aB] ).EuclideanNorm();
+
+        m_edges.push_back( { aA, aB, weight } );
+    }
+
+    void triangulate()
+    {
+        m_edges.clear();
+
+        if( areNodesColinear( m_positions ) )
+        {
+            // special case: all nodes are on the same line - there's no
+            // triangulation for such set. In this case, we sort along any coordinate
+            // and chain the nodes together.
+            for( unsigned i = 0; i < m_positions.size() - 1; i++ )
+                addEdge( i, i + 1 );
+        }
+        else
+        {
+            std::vector<double> node_pts;
+
+            node_pts.reserve( 2 * m_positions.size() );
+
+            for( const VECTOR2I& pos : m_positions )
+            {
+                node_pts.push_back( pos.x );
+                node_pts.push_back( pos.y );
+            }
+
+            delaunator::Delaunator delaunator( node_pts );
+            const auto& triangles = delaunator.triangles;
+            const auto& halfedges = delaunator.halfedges;
+
+            for( size_t i = 0; i < triangles.size(); i++ )
+            {
+                // Edges inside the hull have two half-edges: only keep one of them
+                if( halfedges[i] != delaunator::INVALID_INDEX && halfedges[i] < i )
+                    continue;
+
+                size_t next = ( i % 3 == 2 ) ? i - 2 : i + 1;
+
+                addEdge( triangles[i], triangles[next] );
+            }
+        }
+
+        std::sort( m_edges.begin(), m_edges.end(),
+                   []( const TRIANGULATION_EDGE& a, const TRIANGULATION_EDGE& b )
+                   {
+                       return a.m_weight < b.m_weight;
+                   } );
+    }
+
 public:
 
     void Clear()
@@ -170,17 +238,22 @@ public:
         m_allNodes.insert( aNode );
     }
 
-    void Triangulate( std::vector<CN_EDGE>& mstEdges)
+    /**
+     * Compute the edges that may be part of the ratsnest.
+     *
+     * @param aMstEdges receives the triangulation edges, sorted by weight.
+     * @param aChainEdges receives the edges between the nodes sharing a position.
+     */
+    void Triangulate( std::vector<CN_EDGE>& aMstEdges, std::vector<CN_EDGE>& aChainEdges )
     {
-        std::vector<double>          node_pts;
-
         using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
 
         ANCHOR_LIST              anchors;
         std::vector<ANCHOR_LIST> anchorChains( m_allNodes.size() );
+        std::vector<VECTOR2I>    positions;
 
-        node_pts.reserve( 2 * m_allNodes.size() );
         anchors.reserve( m_allNodes.size() );
+        positions.reserve( m_allNodes.size() );
 
         CN_ANCHOR_PTR prev = nullptr;
 
@@ -188,8 +261,7 @@ public:
         {
             if( !prev || prev->Pos() != n->Pos() )
             {
-                node_pts.push_back( n->Pos().x );
-                node_pts.push_back( n->Pos().y );
+                positions.push_back( n->Pos() );
                 anchors.push_back( n );
                 prev = n;
             }
@@ -198,51 +270,18 @@ public:
         }
 
         if( anchors.size() < 2 )
-        {
             return;
-        }
-        else if( areNodesColinear( anchors ) )
+
+        // Adding or removing tracks and vias between existing pads doesn't change the
+        // positions to triangulate, so the triangulation of the previous update can be reused
+        if( positions != m_positions )
         {
-            // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for( size_t i = 0; i < anchors.size() - 1; i++ )
-            {
-                auto src = anchors[i];
-                auto dst = anchors[i + 1];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-            }
+            m_positions = std::move( positions );
+            triangulate();
         }
-        else
-        {
-            delaunator::Delaunator delaunator( node_pts );
-            auto& triangles = delaunator.triangles;
-
-            for( size_t i = 0; i < triangles.size(); i += 3 )
-            {
-                auto src = anchors[triangles[i]];
-                auto dst = anchors[triangles[i + 1]];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
 
-                src = anchors[triangles[i + 1]];
-                dst = anchors[triangles[i + 2]];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-
-                src = anchors[triangles[i + 2]];
-                dst = anchors[triangles[i]];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-            }
-
-            for( size_t i = 0; i < delaunator.halfedges.size(); i++ )
-            {
-                if( delaunator.halfedges[i] == delaunator::INVALID_INDEX )
-                    continue;
-
-                auto src = anchors[triangles[i]];
-                auto dst = anchors[triangles[delaunator.halfedges[i]]];
-                mstEdges.emplace_back( src, dst, src->Dist( *dst ) );
-            }
-        }
+        for( const TRIANGULATION_EDGE& edge : m_edges )
+            aMstEdges.emplace_back( anchors[edge.m_a], anchors[edge.m_b], edge.m_weight );
 
         for( size_t i = 0; i < anchorChains.size(); i++ )
         {
@@ -261,7 +300,7 @@ public:
                 const auto& prevNode    = chain[j - 1];
                 const auto& curNode     = chain[j];
                 int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.emplace_back( prevNode, curNode, weight );
+                aChainEdges.emplace_back( prevNode, curNode, weight );
             }
         }
     }
@@ -313,26 +352,35 @@ void RN_NET::compute()
     }
 
     std::vector<CN_EDGE> triangEdges;
-    triangEdges.reserve( m_nodes.size() + m_boardEdges.size() );
+    std::vector<CN_EDGE> otherEdges;
+    triangEdges.reserve( 3 * m_nodes.size() );
+    otherEdges.reserve( m_boardEdges.size() );
 
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
-    m_triangulator->Triangulate( triangEdges );
+    m_triangulator->Triangulate( triangEdges, otherEdges );
     #ifdef PROFILE
     cnt.Show();
     #endif
 
     for( const auto& e : m_boardEdges )
-        triangEdges.emplace_back( e );
+        otherEdges.emplace_back( e );
+
+    // The triangulation edges come sorted already
+    std::sort( otherEdges.begin(), otherEdges.end() );
+
+    std::vector<CN_EDGE> edges;
+    edges.reserve( triangEdges.size() + otherEdges.size() );
 
-    std::sort( triangEdges.begin(), triangEdges.end() );
+    std::merge( otherEdges.begin(), otherEdges.end(), triangEdges.begin(), triangEdges.end(),
+                std::back_inserter( edges ) );
 
 // Get the minimal spanning tree
 #ifdef PROFILE
     PROF_COUNTER cnt2("mst");
 #endif
-    kruskalMST( triangEdges );
+    kruskalMST( edges );
 #ifdef PROFILE
     cnt2.Show();
 #endif
@@ -360,7 +408,7 @@ void RN_NET::Clear()
 
 void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
 {
-    CN_ANCHOR_PTR firstAnchor;
+    CN_ANCHOR_PTR firstAnchor = nullptr;
 
     for( auto item : *aCluster )
     {
@@ -373,19 +421,21 @@ void RN_NET::AddCluster( CN_CLUSTER_PTR aCluster )
 
         for( unsigned int i = 0; i < nAnchors; i++ )
         {
-            anchors[i]->SetCluster( aCluster );
-            m_nodes.insert( anchors[i] );
+            CN_ANCHOR_PTR anchor = &anchors[i];
+
+            anchor->SetCluster( aCluster );
+            m_nodes.insert( anchor );
 
             if( firstAnchor )
             {
-                if( firstAnchor != anchors[i] )
+                if( firstAnchor != anchor )
                 {
-                    m_boardEdges.emplace_back( firstAnchor, anchors[i], 0 );
+                    m_boardEdges.emplace_back( firstAnchor, anchor, 0 );
                 }
             }
             else
             {
-                firstAnchor = anchors[i];
+                firstAnchor = anchor;
             }
         }
     }
@@ -428,7 +478,7 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
 
         for( ; fwd_it != m_nodes.end(); ++fwd_it )
         {
-            const std::shared_ptr<CN_ANCHOR>& nodeB = *fwd_it;
+            CN_ANCHOR_PTR nodeB = *fwd_it;
 
             if( nodeB->GetNoLine() )
                 continue;
@@ -446,7 +496,7 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
         /// Step 3: using the same starting point, check points backwards for closer points
         for( ; rev_it != m_nodes.rend(); ++rev_it )
         {
-            const std::shared_ptr<CN_ANCHOR>& nodeB = *rev_it;
+            CN_ANCHOR_PTR nodeB = *rev_it;
 
             if( nodeB->GetNoLine() )
                 continue;
@@ -464,6 +514,82 @@ bool RN_NET::NearestBicoloredPair( const RN_NET& aOtherNet, CN_ANCHOR_PTR& aNode
 }
 
 
+RN_STATIC_ANCHORS::RN_STATIC_ANCHORS( const RN_NET& aNet )
+{
+    m_positions.reserve( aNet.m_nodes.size() );
+
+    // m_nodes is already ordered by x, then y
+    for( const CN_ANCHOR_PTR& node : aNet.m_nodes )
+    {
+        if( !node->GetNoLine() )
+            m_positions.push_back( node->Pos() );
+    }
+}
+
+
+bool RN_STATIC_ANCHORS::NearestBicoloredPair( const RN_NET& aMovingNet, VECTOR2I& aStaticPos,
+                                              VECTOR2I& aMovingPos ) const
+{
+    bool rv = false;
+
+    VECTOR2I::extended_type distMax = VECTOR2I::ECOORD_MAX;
+
+    auto verify = [&]( const VECTOR2I& aTestPos, const VECTOR2I& aMovingTestPos )
+        {
+            auto squaredDist = ( aTestPos - aMovingTestPos ).SquaredEuclideanNorm();
+
+            if( squaredDist < distMax )
+            {
+                rv         = true;
+                distMax    = squaredDist;
+                aStaticPos = aTestPos;
+                aMovingPos = aMovingTestPos;
+            }
+        };
+
+    auto lessByPos = []( const VECTOR2I& aA, const VECTOR2I& aB )
+        {
+            return aA.x < aB.x || ( aA.x == aB.x && aA.y < aB.y );
+        };
+
+    // Same sweep as RN_NET::NearestBicoloredPair, with the best distance shared by all the
+    // moving anchors so each one only looks at the static anchors that could still win
+    for( const CN_ANCHOR_PTR& node : aMovingNet.m_nodes )
+    {
+        if( node->GetNoLine() )
+            continue;
+
+        const VECTOR2I& pos = node->Pos();
+        auto            start = std::lower_bound( m_positions.begin(), m_positions.end(), pos,
+                                                  lessByPos );
+
+        for( auto it = start; it != m_positions.end(); ++it )
+        {
+            VECTOR2I::extended_type distX = it->x - pos.x;
+
+            if( distX * distX > distMax )
+                break;
+
+            verify( *it, pos );
+        }
+
+        for( auto it = start; it != m_positions.begin(); )
+        {
+            --it;
+
+            VECTOR2I::extended_type distX = pos.x - it->x;
+
+            if( distX * distX > distMax )
+                break;
+
+            verify( *it, pos );
+        }
+    }
+
+    return rv;
+}
+
+
 void RN_NET::SetVisible( bool aEnabled )
 {
     for( auto& edge : m_rnEdges )
@@ -166,6 +166,44 @@ protected:
     class TRIANGULATOR_STATE;
 
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
+
+    friend class RN_STATIC_ANCHORS;
+};
+
+
+/**
+ * Snapshot of the anchors of a net which stay in place while a selection is being dragged.
+ *
+ * The positions are stored sorted by x in contiguous memory, so finding the anchor nearest
+ * to the moving ones doesn't walk the node tree of the net on every step of the drag.
+ */
+class RN_STATIC_ANCHORS
+{
+public:
+    /**
+     * @param aNet is the net of the board; anchors marked with NoLine (i.e. belonging to the
+     *             dragged items) are left out.
+     */
+    RN_STATIC_ANCHORS( const RN_NET& aNet );
+
+    bool Empty() const
+    {
+        return m_positions.empty();
+    }
+
+    /**
+     * Find the shortest line between a static anchor and an anchor of \a aMovingNet.
+     *
+     * @param aMovingNet is the net built from the dragged items.
+     * @param aStaticPos is the end of the line on a static anchor.
+     * @param aMovingPos is the end of the line on a moving anchor.
+     * @return false if there is no such line.
+     */
+    bool NearestBicoloredPair( const RN_NET& aMovingNet, VECTOR2I& aStaticPos,
+                               VECTOR2I& aMovingPos ) const;
+
+private:
+    std::vector<VECTOR2I> m_positions;
 };
 
 #endif /* RATSNEST_DATA_H */
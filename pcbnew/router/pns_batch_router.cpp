@@ -0,0 +1,181 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <exception>
+#include <future>
+
+#include <geometry/direction45.h>
+#include <perf_counters.h>
+#include <thread_pool.h>
+
+#include "pns_batch_router.h"
+#include "pns_debug_decorator.h"
+#include "pns_node.h"
+#include "pns_optimizer.h"
+#include "pns_router.h"
+#include "pns_walkaround.h"
+
+namespace PNS {
+
+BATCH_ROUTER::BATCH_ROUTER( ROUTER* aRouter ) :
+        ALGO_BASE( aRouter ),
+        m_node( nullptr )
+{
+}
+
+
+BATCH_ROUTER::~BATCH_ROUTER()
+{
+}
+
+
+void BATCH_ROUTER::AddConnection( const CONNECTION& aConnection )
+{
+    m_connections.push_back( aConnection );
+}
+
+
+OPT<LINE> BATCH_ROUTER::routeConnection( const CONNECTION& aConnection, NODE* aNode )
+{
+    LINE head;
+
+    head.SetNet( aConnection.m_net );
+    head.SetLayer( aConnection.m_layer );
+    head.SetWidth( aConnection.m_width );
+    head.SetShape( DIRECTION_45().BuildInitialTrace( aConnection.m_start, aConnection.m_end ) );
+
+    if( aNode->CheckColliding( &head ) )
+    {
+        WALKAROUND walkaround( aNode, Router() );
+        LINE       walked( head );
+
+        walkaround.SetSolidsOnly( false );
+        walkaround.SetDebugDecorator( Dbg() );
+        walkaround.SetLogger( Logger() );
+        walkaround.SetIterationLimit( Settings().WalkaroundIterationLimit() );
+
+        if( walkaround.Route( head, walked, false ) != WALKAROUND::DONE )
+            return OPT<LINE>();
+
+        // The walk may give up before reaching the end, which is no connection at all
+        if( walked.PointCount() < 2 || walked.CPoint( -1 ) != aConnection.m_end )
+            return OPT<LINE>();
+
+        head = walked;
+    }
+
+    int effort = OPTIMIZER::MERGE_SEGMENTS;
+
+    if( Settings().SmartPads() )
+        effort |= OPTIMIZER::SMART_PADS;
+
+    OPTIMIZER::Optimize( &head, effort, aNode );
+
+    if( aNode->CheckColliding( &head ) )
+        return OPT<LINE>();
+
+    return head;
+}
+
+
+int BATCH_ROUTER::Route()
+{
+    static PERF_COUNTER& routeCounter = PERF_COUNTERS::Get( "pns.batch_router.route" );
+    static PERF_COUNTER& rerouteCounter = PERF_COUNTERS::Get( "pns.batch_router.reroutes" );
+
+    SCOPED_PERF_TIMER timer( routeCounter );
+
+    // Branching modifies the world, so it is done before any task starts
+    m_node = Router()->GetWorld()->Branch();
+    m_routed.assign( m_connections.size(), false );
+
+    std::vector<OPT<LINE>> routes( m_connections.size() );
+
+    THREAD_POOL&     pool = THREAD_POOL::Instance();
+    DEBUG_DECORATOR* ifaceDbg = Router()->GetInterface()->GetDebugDecorator();
+
+    // Nothing is added to m_node until all the connections are routed, so they only read it
+    bool parallel = m_connections.size() > 1
+                    && pool.GetThreadCount() > 1 && !pool.IsWorkerThread()
+                    && !( ifaceDbg && ifaceDbg->IsRecording() )
+                    && !( Dbg() && Dbg()->IsRecording() );
+
+    if( parallel )
+    {
+        std::vector<std::future<void>> tasks;
+        std::exception_ptr             error;
+
+        for( size_t i = 0; i < m_connections.size(); i++ )
+        {
+            tasks.push_back( pool.Submit( [this, i, &routes]()
+                                          {
+                                              routes[i] = routeConnection( m_connections[i],
+                                                                           m_node );
+                                          } ) );
+        }
+
+        // Every task refers to this stack, so all of them have to finish before throwing
+        for( std::future<void>& task : tasks )
+        {
+            try
+            {
+                task.get();
+            }
+            catch( ... )
+            {
+                if( !error )
+                    error = std::current_exception();
+            }
+        }
+
+        if( error )
+            std::rethrow_exception( error );
+    }
+    else
+    {
+        for( size_t i = 0; i < m_connections.size(); i++ )
+            routes[i] = routeConnection( m_connections[i], m_node );
+    }
+
+    int routed = 0;
+
+    for( size_t i = 0; i < m_connections.size(); i++ )
+    {
+        if( !routes[i] )
+            continue;
+
+        // Routed without knowing about the connections merged before this one
+        if( m_node->CheckColliding( &*routes[i] ) )
+        {
+            rerouteCounter.Increment();
+            routes[i] = routeConnection( m_connections[i], m_node );
+
+            if( !routes[i] )
+                continue;
+        }
+
+        m_node->Add( *routes[i] );
+        m_routed[i] = true;
+        routed++;
+    }
+
+    return routed;
+}
+
+}
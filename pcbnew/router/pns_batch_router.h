@@ -0,0 +1,110 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <vector>
+
+#include <core/optional.h>
+#include <math/vector2d.h>
+
+#include "pns_algo_base.h"
+#include "pns_line.h"
+
+namespace PNS {
+
+class ITEM;
+class NODE;
+class ROUTER;
+
+/**
+ * BATCH_ROUTER
+ *
+ * Routes a list of point-to-point connections (typically ratsnest lines) without any user
+ * interaction, walking around the obstacles on a single layer.
+ *
+ * The connections are first routed independently of each other against a common snapshot of
+ * the world, on the thread pool.  The results are then merged, in the order the connections
+ * were added, into a single branch of the world: a route colliding with one merged before it
+ * is routed again against the merged branch.  Connections which can't be routed are left
+ * alone.
+ */
+class BATCH_ROUTER : public ALGO_BASE
+{
+public:
+    struct CONNECTION
+    {
+        VECTOR2I m_start;
+        VECTOR2I m_end;
+        ITEM*    m_startItem;   ///< item of the world at m_start, may be null
+        ITEM*    m_endItem;     ///< item of the world at m_end, may be null
+        int      m_net;
+        int      m_layer;
+        int      m_width;
+    };
+
+    BATCH_ROUTER( ROUTER* aRouter );
+    ~BATCH_ROUTER();
+
+    void AddConnection( const CONNECTION& aConnection );
+
+    int ConnectionCount() const
+    {
+        return m_connections.size();
+    }
+
+    const CONNECTION& Connection( int aIndex ) const
+    {
+        return m_connections[aIndex];
+    }
+
+    /**
+     * Route all the connections added so far in a new branch of the router's world.
+     *
+     * The branch is owned by the world: commit it with ROUTER::CommitRouting(), or drop it
+     * with NODE::KillChildren().
+     *
+     * @return the number of connections routed.
+     */
+    int Route();
+
+    ///< Return the branch holding the routes of the last call to Route().
+    NODE* CurrentNode() const
+    {
+        return m_node;
+    }
+
+    bool IsRouted( int aIndex ) const
+    {
+        return m_routed[aIndex];
+    }
+
+private:
+    ///< Route \a aConnection around the items of \a aNode, without modifying it.
+    OPT<LINE> routeConnection( const CONNECTION& aConnection, NODE* aNode );
+
+    std::vector<CONNECTION> m_connections;
+    std::vector<bool>       m_routed;
+    NODE*                   m_node;
+};
+
+}
+
+#endif
@@ -29,6 +29,8 @@
 
 namespace PNS {
 
+class PHASE_PROFILE;
+
 class DEBUG_DECORATOR
 {
 public:
@@ -49,6 +51,15 @@ public:
     virtual void AddBox( BOX2I aB, int aColor, const std::string aName = "" ) {};
     virtual void AddDirections( VECTOR2D aP, int aMask, int aColor, const std::string aName = "" ) {};
     virtual void Clear() {};
+
+    ///< Called at the end of every router operation with the times of the session so far.
+    virtual void ReportPhaseTimes( const PHASE_PROFILE& aProfile ) {};
+
+    /**
+     * Return true if the decorator keeps what it is given.  Such a decorator isn't thread safe,
+     * so the router searches serially while it is set.
+     */
+    virtual bool IsRecording() const { return false; }
 };
 
 }
@@ -45,6 +45,7 @@ DP_MEANDER_PLACER::DP_MEANDER_PLACER( ROUTER* aRouter ) :
     // Init temporary variables (do not leave uninitialized members)
     m_initialSegment = NULL;
     m_lastLength     = 0;
+    m_tunedPathLength = 0;
     m_lastStatus     = TOO_SHORT;
 }
 
@@ -112,6 +113,10 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
     m_currentWidth = m_originPair.Width();
 
+    m_tunedPathLength = origPathLength();
+    m_originLengthsP.Build( m_originPair.CP() );
+    m_originLengthsN.Build( m_originPair.CN() );
+
     return true;
 }
 
@@ -176,8 +181,13 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
     SHAPE_LINE_CHAIN preP, tunedP, postP;
     SHAPE_LINE_CHAIN preN, tunedN, postN;
 
-    cutTunedLine( m_originPair.CP(), m_currentStart, aP, preP, tunedP, postP );
-    cutTunedLine( m_originPair.CN(), m_currentStart, aP, preN, tunedN, postN );
+    LINE_LENGTH_INDEX::LOCATION tunedStartP, tunedEndP;
+    LINE_LENGTH_INDEX::LOCATION tunedStartN, tunedEndN;
+
+    cutTunedLine( m_originPair.CP(), m_currentStart, aP, preP, tunedP, postP, tunedStartP,
+                  tunedEndP );
+    cutTunedLine( m_originPair.CN(), m_currentStart, aP, preN, tunedN, postN, tunedStartN,
+                  tunedEndN );
 
     DIFF_PAIR tuned( m_originPair );
 
@@ -245,7 +255,7 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
     while( curIndexN < tunedN.PointCount() )
         m_result.AddCorner( tunedP.CPoint( -1 ), tunedN.CPoint( curIndexN++ ) );
 
-    long long int dpLen = origPathLength();
+    long long int dpLen = m_tunedPathLength;
 
     m_lastStatus = TUNED;
 
@@ -256,7 +266,8 @@ bool DP_MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
     }
     else
     {
-        m_lastLength = dpLen - std::max( tunedP.Length(), tunedN.Length() );
+        m_lastLength = dpLen - std::max( m_originLengthsP.SpanLength( tunedStartP, tunedEndP ),
+                                         m_originLengthsN.SpanLength( tunedStartN, tunedEndN ) );
         tuneLineLength( m_result, m_settings.m_targetLength - dpLen );
     }
 
@@ -122,6 +122,10 @@ private:
 
     long long int origPathLength() const;
 
+    ///< origPathLength() as of Start(), the paths only change where they are being tuned
+    long long int     m_tunedPathLength;
+    LINE_LENGTH_INDEX m_originLengthsP, m_originLengthsN;
+
     ///< Current routing start point (end of tail, beginning of head).
     VECTOR2I m_currentStart;
 
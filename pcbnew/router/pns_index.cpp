@@ -22,6 +22,8 @@
 #include "pns_index.h"
 #include "pns_router.h"
 
+#include <algorithm>
+
 namespace PNS {
 
 
@@ -29,17 +31,36 @@ void INDEX::Add( ITEM* aItem )
 {
     const LAYER_RANGE& range = aItem->Layers();
 
-    if( m_subIndices.size() <= static_cast<size_t>( range.End() ) )
-        m_subIndices.resize( 2 * range.End() + 1 ); // +1 handles the 0 case
+    if( isMultilayer( aItem ) )
+    {
+        if( !m_multilayerIndex )
+            m_multilayerIndex = std::make_unique<ITEM_SHAPE_INDEX>();
+
+        m_multilayerIndex->Add( aItem );
+    }
+    else
+    {
+        if( m_subIndices.size() <= static_cast<size_t>( range.Start() ) )
+            m_subIndices.resize( range.Start() + 1 );
+
+        std::unique_ptr<ITEM_SHAPE_INDEX>& subIndex = m_subIndices[range.Start()];
 
-    for( int i = range.Start(); i <= range.End(); ++i )
-        m_subIndices[i].Add( aItem );
+        if( !subIndex )
+            subIndex = std::make_unique<ITEM_SHAPE_INDEX>();
+
+        subIndex->Add( aItem );
+    }
 
     m_allItems.insert( aItem );
     int net = aItem->Net();
 
     if( net >= 0 )
+    {
+        if( m_netMap.size() <= static_cast<size_t>( net ) )
+            m_netMap.resize( net + 1 );
+
         m_netMap[net].push_back( aItem );
+    }
 }
 
 
@@ -47,17 +68,39 @@ void INDEX::Remove( ITEM* aItem )
 {
     const LAYER_RANGE& range = aItem->Layers();
 
-    if( m_subIndices.size() <= static_cast<size_t>( range.End() ) )
-        return;
+    if( isMultilayer( aItem ) )
+    {
+        if( !m_multilayerIndex )
+            return;
+
+        m_multilayerIndex->Remove( aItem );
+    }
+    else
+    {
+        if( m_subIndices.size() <= static_cast<size_t>( range.Start() )
+                || !m_subIndices[range.Start()] )
+        {
+            return;
+        }
 
-    for( int i = range.Start(); i <= range.End(); ++i )
-        m_subIndices[i].Remove( aItem );
+        m_subIndices[range.Start()]->Remove( aItem );
+    }
 
     m_allItems.erase( aItem );
     int net = aItem->Net();
 
-    if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
+    if( net >= 0 && static_cast<size_t>( net ) < m_netMap.size() )
+    {
+        NET_ITEMS_LIST& items = m_netMap[net];
+        auto            it = std::find( items.begin(), items.end(), aItem );
+
+        // The order of the items of a net doesn't matter
+        if( it != items.end() )
+        {
+            *it = items.back();
+            items.pop_back();
+        }
+    }
 }
 
 
@@ -70,7 +113,7 @@ void INDEX::Replace( ITEM* aOldItem, ITEM* aNewItem )
 
 INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
 {
-    if( m_netMap.find( aNet ) == m_netMap.end() )
+    if( aNet < 0 || static_cast<size_t>( aNet ) >= m_netMap.size() || m_netMap[aNet].empty() )
         return NULL;
 
     return &m_netMap[aNet];
@@ -22,10 +22,9 @@
 #ifndef __PNS_INDEX_H
 #define __PNS_INDEX_H
 
-#include <deque>
-#include <list>
-#include <map>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/shape_index.h>
@@ -38,14 +37,20 @@ namespace PNS {
 /**
  * INDEX
  *
- * Custom spatial index, holding our board items and allowing for very fast searches. Items
- * are assigned to separate R-Tree subindices depending on their type and spanned layers, reducing
- * overlap and improving search time.
+ * Custom spatial index, holding our board items and allowing for very fast searches.
+ *
+ * Items on a single layer (most tracks) are assigned to the R-Tree of their layer, while items
+ * spanning several layers (vias, through-hole pads) share one R-Tree and are filtered by layer
+ * when searched.  This way a multilayer item is stored once, and found at most once by a
+ * search, instead of once for each of its layers.
+ *
+ * The R-Trees are only created when the first item goes into them, as most of the indices
+ * of the branches made while routing only hold a few items on one or two layers.
  **/
-class INDEX
+class INDEX : public POOL_ALLOCATED
 {
 public:
-    typedef std::list<ITEM*>            NET_ITEMS_LIST;
+    typedef std::vector<ITEM*>          NET_ITEMS_LIST;
     typedef SHAPE_INDEX<ITEM*>          ITEM_SHAPE_INDEX;
     typedef std::unordered_set<ITEM*>   ITEM_SET;
 
@@ -95,7 +100,7 @@ public:
     int Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
     /**
-     * Returns list of all items in a given net.
+     * Returns list of all items in a given net, or NULL if there are none.
      */
     NET_ITEMS_LIST* GetItemsForNet( int aNet );
 
@@ -118,23 +123,52 @@ public:
     ITEM_SET::iterator end() { return m_allItems.end(); }
 
 private:
+    /**
+     * Passes on to a visitor the items of the multilayer index which are on given layers.
+     */
+    template <class Visitor>
+    struct LAYER_FILTER
+    {
+        LAYER_FILTER( const LAYER_RANGE& aLayers, Visitor& aVisitor ) :
+                m_layers( aLayers ),
+                m_visitor( aVisitor )
+        {}
+
+        bool operator()( ITEM* aItem )
+        {
+            if( !aItem->Layers().Overlaps( m_layers ) )
+                return true;
+
+            return m_visitor( aItem );
+        }
+
+        const LAYER_RANGE& m_layers;
+        Visitor&           m_visitor;
+    };
+
+    static bool isMultilayer( const ITEM* aItem )
+    {
+        return aItem->Layers().Start() != aItem->Layers().End();
+    }
+
     template <class Visitor>
     int querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
 private:
-    std::deque<ITEM_SHAPE_INDEX>  m_subIndices;
-    std::map<int, NET_ITEMS_LIST> m_netMap;
-    ITEM_SET                      m_allItems;
+    std::vector<std::unique_ptr<ITEM_SHAPE_INDEX>> m_subIndices;   ///< single layer items
+    std::unique_ptr<ITEM_SHAPE_INDEX>              m_multilayerIndex;
+    std::vector<NET_ITEMS_LIST>                    m_netMap;       ///< items, by net code
+    ITEM_SET                                       m_allItems;
 };
 
 
 template<class Visitor>
 int INDEX::querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
 {
-    if( aIndex >= m_subIndices.size() )
+    if( aIndex >= m_subIndices.size() || !m_subIndices[aIndex] )
         return 0;
 
-    return m_subIndices[aIndex].Query( aShape, aMinDistance, aVisitor);
+    return m_subIndices[aIndex]->Query( aShape, aMinDistance, aVisitor);
 }
 
 template<class Visitor>
@@ -147,6 +181,13 @@ int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor ) const
     for( int i = layers.Start(); i <= layers.End(); ++i )
         total += querySingle( i, aItem->Shape(), aMinDistance, aVisitor );
 
+    if( m_multilayerIndex )
+    {
+        LAYER_FILTER<Visitor> filter( layers, aVisitor );
+
+        total += m_multilayerIndex->Query( aItem->Shape(), aMinDistance, filter );
+    }
+
     return total;
 }
 
@@ -158,6 +199,9 @@ int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) con
     for( std::size_t i = 0; i < m_subIndices.size(); ++i )
         total += querySingle( i, aShape, aMinDistance, aVisitor );
 
+    if( m_multilayerIndex )
+        total += m_multilayerIndex->Query( aShape, aMinDistance, aVisitor );
+
     return total;
 }
 
@@ -23,6 +23,7 @@
 #ifndef __PNS_ITEM_H
 #define __PNS_ITEM_H
 
+#include <atomic>
 #include <memory>
 #include <math/vector2d.h>
 
@@ -30,6 +31,7 @@
 #include <geometry/shape_line_chain.h>
 
 #include "pns_layerset.h"
+#include "pns_pool.h"
 
 class BOARD_ITEM;
 
@@ -52,7 +54,7 @@ enum LineMarker {
  * Implements the shared properties of all PCB items  net, spanned layers, geometric shape and
  * reference to owning model.
  */
-class ITEM
+class ITEM : public POOL_ALLOCATED
 {
 public:
     static const int UnusedNet = INT_MAX;
@@ -90,11 +92,26 @@ public:
         m_kind = aOther.m_kind;
         m_parent = aOther.m_parent;
         m_owner = aOther.m_owner; // fixme: wtf this was null?
-        m_marker = aOther.m_marker;
+        m_marker = aOther.m_marker.load();
         m_rank = aOther.m_rank;
         m_routable = aOther.m_routable;
     }
 
+    ITEM& operator=( const ITEM& aOther )
+    {
+        m_layers = aOther.m_layers;
+        m_net = aOther.m_net;
+        m_movable = aOther.m_movable;
+        m_kind = aOther.m_kind;
+        m_parent = aOther.m_parent;
+        m_owner = aOther.m_owner;
+        m_marker = aOther.m_marker.load();
+        m_rank = aOther.m_rank;
+        m_routable = aOther.m_routable;
+
+        return *this;
+    }
+
     virtual ~ITEM();
 
     /**
@@ -240,7 +257,8 @@ protected:
 
     bool          m_movable;
     int           m_net;
-    mutable int   m_marker;
+    ///< Atomic, as collision queries mark the items they hit and may run on several threads
+    mutable std::atomic<int> m_marker;
     int           m_rank;
     bool          m_routable;
 };
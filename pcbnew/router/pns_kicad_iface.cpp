@@ -28,6 +28,9 @@
 #include <pcb_shape.h>
 #include <pcb_text.h>
 #include <board_commit.h>
+#include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_algo.h>
+#include <ratsnest/ratsnest_data.h>
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/convex_hull.h>
 #include <confirm.h>
@@ -46,15 +49,21 @@
 #include <drc/drc_rule.h>
 #include <drc/drc_engine.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <advanced_config.h>
+#include <hash_eda.h>
+#include <perf_counters.h>
 
 #include "tools/pcb_tool_base.h"
 
 #include "pns_kicad_iface.h"
 
 #include "pns_arc.h"
+#include "pns_batch_router.h"
 #include "pns_routing_settings.h"
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
@@ -88,9 +97,66 @@ public:
     virtual wxString NetName( int aNet ) override;
 
 private:
+    /**
+     * What the rules of a clearance query depend on: the board item on each side or, for the
+     * items being routed which have none yet, their kind and net.  Unlike the router items
+     * these live as long as the routing session, so every version of the line being routed
+     * shares the same cache entries.
+     */
+    struct CLEARANCE_KEY
+    {
+        CLEARANCE_KEY( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aA, const PNS::ITEM* aB,
+                       int aLayer );
+
+        bool operator==( const CLEARANCE_KEY& aOther ) const;
+
+        int               m_type;
+        int               m_layer;
+        const BOARD_ITEM* m_parentA;
+        const BOARD_ITEM* m_parentB;
+        int               m_kindA;
+        int               m_kindB;
+        int               m_netA;
+        int               m_netB;
+    };
+
+    struct CLEARANCE_KEY_HASH
+    {
+        std::size_t operator()( const CLEARANCE_KEY& aKey ) const
+        {
+            return hash_val( aKey.m_type, aKey.m_layer, aKey.m_parentA, aKey.m_parentB,
+                             aKey.m_kindA, aKey.m_kindB, aKey.m_netA, aKey.m_netB );
+        }
+    };
+
+    using CLEARANCE_CACHE = std::unordered_map<CLEARANCE_KEY, int, CLEARANCE_KEY_HASH>;
+
+    /**
+     * Clearances are queried from several threads when the walkaround searches both
+     * directions at once, so each thread keeps its own cache and lookups don't need a lock.
+     */
+    struct THREAD_CACHE
+    {
+        int               m_resolverId = -1;   ///< the resolver the cache was filled by
+        const DRC_ENGINE* m_engine = nullptr;  ///< the rules the cache was filled with
+        int               m_rulesGeneration = 0;
+        CLEARANCE_CACHE   m_clearances;
+    };
+
+    ///< Return the cache of the calling thread, emptied if it was filled by another resolver
+    ///< or with other rules.
+    CLEARANCE_CACHE& threadCache( const DRC_ENGINE* aEngine, int aRulesGeneration ) const;
+
     int holeRadius( const PNS::ITEM* aItem ) const;
     int matchDpSuffix( const wxString& aNetName, wxString& aComplementNet, wxString& aBaseDpName );
 
+    ///< Return the clearance of \a aType between two items, from the cache if possible.
+    int cachedClearance( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aA, const PNS::ITEM* aB );
+
+    ///< Evaluate the rules for the clearance of \a aType between two items.
+    int evalClearance( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aA, const PNS::ITEM* aB,
+                       int aLayer );
+
 private:
     PNS::ROUTER_IFACE* m_routerIface;
     BOARD*             m_board;
@@ -98,12 +164,39 @@ private:
     ARC                m_dummyArc;
     VIA                m_dummyVia;
 
-    std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_clearanceCache;
-    std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_holeClearanceCache;
-    std::map<std::pair<const PNS::ITEM*, const PNS::ITEM*>, int> m_holeToHoleClearanceCache;
+    ///< Guards the dummy items, rules are evaluated from several threads when the walkaround
+    ///< searches both directions at once
+    std::recursive_mutex m_lock;
+
+    ///< Tells the thread caches of the successive resolvers apart
+    int                m_resolverId;
 };
 
 
+PNS_PCBNEW_RULE_RESOLVER::CLEARANCE_KEY::CLEARANCE_KEY( PNS::CONSTRAINT_TYPE aType,
+                                                         const PNS::ITEM* aA,
+                                                         const PNS::ITEM* aB, int aLayer ) :
+    m_type( static_cast<int>( aType ) ),
+    m_layer( aLayer ),
+    m_parentA( aA->Parent() ),
+    m_parentB( aB ? aB->Parent() : nullptr ),
+    m_kindA( aA->Kind() ),
+    m_kindB( aB ? aB->Kind() : 0 ),
+    m_netA( aA->Net() ),
+    m_netB( aB ? aB->Net() : PNS::ITEM::UnusedNet )
+{
+}
+
+
+bool PNS_PCBNEW_RULE_RESOLVER::CLEARANCE_KEY::operator==( const CLEARANCE_KEY& aOther ) const
+{
+    return m_type == aOther.m_type && m_layer == aOther.m_layer
+           && m_parentA == aOther.m_parentA && m_parentB == aOther.m_parentB
+           && m_kindA == aOther.m_kindA && m_kindB == aOther.m_kindB
+           && m_netA == aOther.m_netA && m_netB == aOther.m_netB;
+}
+
+
 PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
                                                     PNS::ROUTER_IFACE* aRouterIface ) :
     m_routerIface( aRouterIface ),
@@ -112,6 +205,9 @@ PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
     m_dummyArc( aBoard ),
     m_dummyVia( aBoard )
 {
+    static std::atomic<int> s_nextResolverId( 0 );
+
+    m_resolverId = s_nextResolverId++;
 }
 
 
@@ -188,6 +284,14 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
                                                 const PNS::ITEM* aItemA, const PNS::ITEM* aItemB,
                                                 int aLayer, PNS::CONSTRAINT* aConstraint )
 {
+    PNS::ROUTER* router = PNS::ROUTER::GetInstance();
+
+    // Only profiled: a rule query cut short would route against the wrong clearance
+    PNS::SCOPED_PHASE_TIMER timer( router ? &router->PhaseProfile() : nullptr,
+                                   PNS::PHASE::RULES );
+
+    std::lock_guard<std::recursive_mutex> lock( m_lock );
+
     std::shared_ptr<DRC_ENGINE> drcEngine = m_board->GetDesignSettings().m_DRCEngine;
 
     if( !drcEngine )
@@ -277,53 +381,50 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
 }
 
 
-int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+int PNS_PCBNEW_RULE_RESOLVER::evalClearance( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aA,
+                                             const PNS::ITEM* aB, int aLayer )
 {
-    std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
-    auto it = m_clearanceCache.find( key );
-
-    if( it != m_clearanceCache.end() )
-        return it->second;
-
     PNS::CONSTRAINT constraint;
     int rv = 0;
-    int layer;
 
-    if( !aA->Layers().IsMultilayer() || !aB || aB->Layers().IsMultilayer() )
-        layer = aA->Layer();
-    else
-        layer = aB->Layer();
+    if( aType != PNS::CONSTRAINT_TYPE::CT_CLEARANCE )
+    {
+        if( QueryConstraint( aType, aA, aB, aLayer, &constraint ) )
+            rv = constraint.m_Value.Min();
+
+        return rv;
+    }
 
     if( isCopper( aA ) && ( !aB || isCopper( aB ) ) )
     {
-        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, layer, &constraint ) )
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB, aLayer, &constraint ) )
             rv = constraint.m_Value.Min();
     }
 
     if( isEdge( aA ) || ( aB && isEdge( aB ) ) )
     {
-        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, layer, &constraint ) )
+        if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_EDGE_CLEARANCE, aA, aB, aLayer,
+                             &constraint ) )
         {
             if( constraint.m_Value.Min() > rv )
                 rv = constraint.m_Value.Min();
         }
     }
 
-    m_clearanceCache[ key ] = rv;
     return rv;
 }
 
 
-int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+int PNS_PCBNEW_RULE_RESOLVER::cachedClearance( PNS::CONSTRAINT_TYPE aType, const PNS::ITEM* aA,
+                                               const PNS::ITEM* aB )
 {
-    std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
-    auto it = m_holeClearanceCache.find( key );
+    static PERF_COUNTER& evalCounter = PERF_COUNTERS::Get( "pns.rule_resolver.clearance_evals" );
 
-    if( it != m_holeClearanceCache.end() )
-        return it->second;
+    // Netclasses are compiled into the rules too, so this also catches netclass changes
+    const DRC_ENGINE* drcEngine = m_board->GetDesignSettings().m_DRCEngine.get();
+    int               generation = drcEngine ? drcEngine->RulesGeneration() : 0;
+    CLEARANCE_CACHE&  cache = threadCache( drcEngine, generation );
 
-    PNS::CONSTRAINT constraint;
-    int rv = 0;
     int layer;
 
     if( !aA->Layers().IsMultilayer() || !aB || aB->Layers().IsMultilayer() )
@@ -331,36 +432,54 @@ int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITE
     else
         layer = aB->Layer();
 
-    if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB, layer, &constraint ) )
-        rv = constraint.m_Value.Min();
+    CLEARANCE_KEY key( aType, aA, aB, layer );
+    auto          it = cache.find( key );
+
+    if( it != cache.end() )
+        return it->second;
+
+    evalCounter.Increment();
 
-    m_holeClearanceCache[ key ] = rv;
+    int rv = evalClearance( aType, aA, aB, layer );
+
+    cache[ key ] = rv;
     return rv;
 }
 
 
-int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+PNS_PCBNEW_RULE_RESOLVER::CLEARANCE_CACHE&
+PNS_PCBNEW_RULE_RESOLVER::threadCache( const DRC_ENGINE* aEngine, int aRulesGeneration ) const
 {
-    std::pair<const PNS::ITEM*, const PNS::ITEM*> key( aA, aB );
-    auto it = m_holeToHoleClearanceCache.find( key );
+    static thread_local THREAD_CACHE t_cache;
 
-    if( it != m_holeToHoleClearanceCache.end() )
-        return it->second;
+    if( t_cache.m_resolverId != m_resolverId || t_cache.m_engine != aEngine
+            || t_cache.m_rulesGeneration != aRulesGeneration )
+    {
+        t_cache.m_clearances.clear();
+        t_cache.m_resolverId = m_resolverId;
+        t_cache.m_engine = aEngine;
+        t_cache.m_rulesGeneration = aRulesGeneration;
+    }
 
-    PNS::CONSTRAINT constraint;
-    int rv = 0;
-    int layer;
+    return t_cache.m_clearances;
+}
 
-    if( !aA->Layers().IsMultilayer() || !aB || aB->Layers().IsMultilayer() )
-        layer = aA->Layer();
-    else
-        layer = aB->Layer();
 
-    if( QueryConstraint( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB, layer, &constraint ) )
-        rv = constraint.m_Value.Min();
+int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+{
+    return cachedClearance( PNS::CONSTRAINT_TYPE::CT_CLEARANCE, aA, aB );
+}
+
 
-    m_holeToHoleClearanceCache[ key ] = rv;
-    return rv;
+int PNS_PCBNEW_RULE_RESOLVER::HoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+{
+    return cachedClearance( PNS::CONSTRAINT_TYPE::CT_HOLE_CLEARANCE, aA, aB );
+}
+
+
+int PNS_PCBNEW_RULE_RESOLVER::HoleToHoleClearance( const PNS::ITEM* aA, const PNS::ITEM* aB )
+{
+    return cachedClearance( PNS::CONSTRAINT_TYPE::CT_HOLE_TO_HOLE, aA, aB );
 }
 
 
@@ -759,6 +878,11 @@ public:
         m_view->Update( m_items );
     }
 
+    bool IsRecording() const override
+    {
+        return m_view != NULL;
+    }
+
     void Clear() override
     {
         if( m_view && m_items )
@@ -800,12 +924,12 @@ PNS_KICAD_IFACE::PNS_KICAD_IFACE()
 
 PNS_KICAD_IFACE_BASE::~PNS_KICAD_IFACE_BASE()
 {
+    delete m_ruleResolver;
 }
 
 
 PNS_KICAD_IFACE::~PNS_KICAD_IFACE()
 {
-    delete m_ruleResolver;
     delete m_debugDecorator;
 
      if( m_previewItems )
@@ -1317,8 +1441,8 @@ void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
         }
     }
 
-    // NB: if this were ever to become a long-lived object we would need to dirty its
-    // clearance cache here....
+    // The clearance cache of the resolver is keyed on board items, which may have been
+    // deleted since the last sync
     delete m_ruleResolver;
     m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, this );
 
@@ -1511,10 +1635,8 @@ void PNS_KICAD_IFACE_BASE::AddItem( PNS::ITEM* aItem )
 }
 
 
-void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
+BOARD_CONNECTED_ITEM* PNS_KICAD_IFACE_BASE::createBoardItem( PNS::ITEM* aItem )
 {
-    BOARD_CONNECTED_ITEM* newBI = NULL;
-
     switch( aItem->Kind() )
     {
     case PNS::ITEM::ARC_T:
@@ -1524,8 +1646,7 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
         new_arc->SetWidth( arc->Width() );
         new_arc->SetLayer( ToLAYER_ID( arc->Layers().Start() ) );
         new_arc->SetNetCode( std::max<int>( 0, arc->Net() ) );
-        newBI = new_arc;
-        break;
+        return new_arc;
     }
 
     case PNS::ITEM::SEGMENT_T:
@@ -1538,8 +1659,7 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
         track->SetWidth( seg->Width() );
         track->SetLayer( ToLAYER_ID( seg->Layers().Start() ) );
         track->SetNetCode( seg->Net() > 0 ? seg->Net() : 0 );
-        newBI = track;
-        break;
+        return track;
     }
 
     case PNS::ITEM::VIA_T:
@@ -1554,11 +1674,71 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
         via_board->SetIsFree( via->IsFree() );
         via_board->SetLayerPair( ToLAYER_ID( via->Layers().Start() ),
                                  ToLAYER_ID( via->Layers().End() ) );
-        newBI = via_board;
-        break;
+        return via_board;
     }
 
-    case PNS::ITEM::SOLID_T:
+    default:
+        return nullptr;
+    }
+}
+
+
+int PNS_KICAD_IFACE_BASE::ImportRatsnest( PNS::BATCH_ROUTER& aBatch, const std::set<int>& aNets,
+                                          int aLayer )
+{
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
+    int                                count = 0;
+
+    for( int net : aNets )
+    {
+        RN_NET* rnNet = net > 0 ? connectivity->GetRatsnestForNet( net ) : nullptr;
+
+        if( !rnNet )
+            continue;
+
+        for( const CN_EDGE& edge : rnNet->GetUnconnected() )
+        {
+            if( !edge.GetSourceNode() || !edge.GetTargetNode() )
+                continue;
+
+            PNS::ITEM* startItem = m_world->FindItemByParent( edge.GetSourceNode()->Parent() );
+            PNS::ITEM* endItem = m_world->FindItemByParent( edge.GetTargetNode()->Parent() );
+
+            if( !startItem || !endItem )
+                continue;
+
+            // No vias are placed, so both ends have to share a layer
+            int first = std::max( startItem->Layers().Start(), endItem->Layers().Start() );
+            int last = std::min( startItem->Layers().End(), endItem->Layers().End() );
+
+            if( first > last )
+                continue;
+
+            PNS::SIZES_SETTINGS           sizes;
+            PNS::BATCH_ROUTER::CONNECTION conn;
+
+            ImportSizes( sizes, startItem, net );
+
+            conn.m_start = edge.GetSourcePos();
+            conn.m_end = edge.GetTargetPos();
+            conn.m_startItem = startItem;
+            conn.m_endItem = endItem;
+            conn.m_net = net;
+            conn.m_layer = ( aLayer >= first && aLayer <= last ) ? aLayer : first;
+            conn.m_width = sizes.TrackWidth();
+
+            aBatch.AddConnection( conn );
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
+{
+    if( aItem->Kind() == PNS::ITEM::SOLID_T )
     {
         PAD*   pad = static_cast<PAD*>( aItem->Parent() );
         VECTOR2I pos = static_cast<PNS::SOLID*>( aItem )->Pos();
@@ -1567,9 +1747,7 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
         return;
     }
 
-    default:
-        break;
-    }
+    BOARD_CONNECTED_ITEM* newBI = createBoardItem( aItem );
 
     if( newBI )
     {
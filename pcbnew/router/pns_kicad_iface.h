@@ -22,6 +22,7 @@
 #ifndef __PNS_KICAD_IFACE_H
 #define __PNS_KICAD_IFACE_H
 
+#include <set>
 #include <unordered_set>
 
 #include "pns_router.h"
@@ -31,6 +32,7 @@ class PNS_PCBNEW_DEBUG_DECORATOR;
 
 class BOARD;
 class BOARD_COMMIT;
+class BOARD_CONNECTED_ITEM;
 class PCB_DISPLAY_OPTIONS;
 class PCB_TOOL_BASE;
 class FOOTPRINT;
@@ -38,6 +40,7 @@ class PAD;
 
 namespace PNS
 {
+    class BATCH_ROUTER;
     class SIZES_SETTINGS;
 }
 
@@ -67,6 +70,17 @@ public:
     void Commit() override {}
     bool ImportSizes( PNS::SIZES_SETTINGS& aSizes, PNS::ITEM* aStartItem, int aNet ) override;
 
+    /**
+     * Add the unrouted ratsnest lines of \a aNets to \a aBatch.
+     *
+     * Each ratsnest line is routed on \a aLayer if both its ends are on it, on the first layer
+     * they share otherwise.  Ratsnest lines whose ends share no layer would need a via and are
+     * skipped.  The world has to be synced first.
+     *
+     * @return the number of connections added.
+     */
+    int ImportRatsnest( PNS::BATCH_ROUTER& aBatch, const std::set<int>& aNets, int aLayer );
+
     void UpdateNet( int aNetCode ) override {}
 
     void SetDebugDecorator( PNS::DEBUG_DECORATOR *aDec );
@@ -97,6 +111,9 @@ protected:
     bool syncZone( PNS::NODE* aWorld, ZONE* aZone, SHAPE_POLY_SET* aBoardOutline );
     bool inheritTrackWidth( PNS::ITEM* aItem, int* aInheritedWidth );
 
+    ///< Create the board item for a router track, arc or via; return nullptr for other items.
+    BOARD_CONNECTED_ITEM* createBoardItem( PNS::ITEM* aItem );
+
 protected:
     PNS::NODE* m_world;
     BOARD*     m_board;
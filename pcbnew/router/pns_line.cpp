@@ -45,7 +45,7 @@ LINE::LINE( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_blockingObstacle = aOther.m_blockingObstacle;
 
@@ -67,7 +67,7 @@ LINE& LINE::operator=( const LINE& aOther )
     m_layers = aOther.m_layers;
     m_via = aOther.m_via;
     m_hasVia = aOther.m_hasVia;
-    m_marker = aOther.m_marker;
+    m_marker = aOther.m_marker.load();
     m_rank = aOther.m_rank;
     m_owner = aOther.m_owner;
     m_snapThreshhold = aOther.m_snapThreshhold;
@@ -126,7 +126,7 @@ SEGMENT* SEGMENT::Clone() const
     s->m_seg = m_seg;
     s->m_net = m_net;
     s->m_layers = m_layers;
-    s->m_marker = m_marker;
+    s->m_marker = m_marker.load();
     s->m_rank = m_rank;
 
     return s;
@@ -922,24 +922,26 @@ void LINE::ClipVertexRange( int aStart, int aEnd )
     int arcIdx    = -1;
     int linkIdx   = 0;
 
-    auto shapes    = m_line.CShapes();
-    int  numPoints = static_cast<int>( shapes.size() );
+    int numPoints = m_line.PointCount();
 
-    for( int i = 0; i < m_line.PointCount(); i++ )
+    for( int i = 0; i < numPoints; i++ )
     {
         if( i <= aStart )
             firstLink = linkIdx;
 
-        if( shapes[i] >= 0 )
+        if( m_line.ArcIndex( i ) >= 0 )
         {
             // Account for "hidden segments" between two arcs
-            if( i > aStart && ( shapes[i - 1] >= 0 ) && ( shapes[i - 1] != shapes[i] ) )
+            if( i > aStart && ( m_line.ArcIndex( i - 1 ) >= 0 )
+                    && ( m_line.ArcIndex( i - 1 ) != m_line.ArcIndex( i ) ) )
+            {
                 linkIdx++;
+            }
 
-            arcIdx = shapes[i];
+            arcIdx = m_line.ArcIndex( i );
 
             // Skip over the rest of the arc vertices
-            while( i < numPoints && shapes[i] == arcIdx )
+            while( i < numPoints && m_line.ArcIndex( i ) == arcIdx )
                 i++;
 
             // Back up two vertices to restart at the segment coincident with the end of the arc
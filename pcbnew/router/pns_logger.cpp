@@ -20,6 +20,7 @@
  */
 
 #include "pns_logger.h"
+#include "pns_phase_profile.h"
 #include "pns_item.h"
 #include "pns_via.h"
 #include "pns_line.h"
@@ -47,6 +48,7 @@ LOGGER::~LOGGER()
 void LOGGER::Clear()
 {
     m_events.clear();
+    m_phaseTimes.clear();
 }
 
 
@@ -56,20 +58,31 @@ void LOGGER::Save( const std::string& aFilename )
 
     wxLogTrace( "PNS", "Saving to '%s' [%p]", aFilename.c_str(), f );
 
-    for( const auto evt : m_events )
+    if( !f )
+        return;
+
+    // Same format as ROUTER_TOOL::saveRouterDebugLog(), so that the log can be replayed
+    for( const EVENT_ENTRY& evt : m_events )
     {
-        uint64_t id = 0;
+        wxString id = "null";
+
         if( evt.item && evt.item->Parent() )
-        {
-            const char* idString = evt.item->Parent()->m_Uuid.AsString().c_str();
-            fprintf( f, "event %d %d %d %s\n", evt.type, evt.p.x, evt.p.y, idString );
-        }
+            id = evt.item->Parent()->m_Uuid.AsString();
+
+        fprintf( f, "event %d %d %d %s\n", evt.p.x, evt.p.y, evt.type, (const char*) id.c_str() );
     }
 
+    fputs( m_phaseTimes.c_str(), f );
     fclose( f );
 }
 
 
+void LOGGER::SetPhaseTimes( const PHASE_PROFILE& aProfile )
+{
+    m_phaseTimes = aProfile.Format();
+}
+
+
 void LOGGER::Log( LOGGER::EVENT_TYPE evt, VECTOR2I pos, const ITEM* item )
 {
     LOGGER::EVENT_ENTRY ent;
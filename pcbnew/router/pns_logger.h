@@ -35,6 +35,7 @@ class SHAPE;
 namespace PNS {
 
 class ITEM;
+class PHASE_PROFILE;
 
 class LOGGER
 {
@@ -66,8 +67,18 @@ public:
         return m_events;
     }
 
+    ///< Keep the phase times of the session, to be saved after the events.
+    void SetPhaseTimes( const PHASE_PROFILE& aProfile );
+
+    ///< Return the "phase" lines of the log, see PHASE_PROFILE::Format().
+    const std::string& GetPhaseTimes() const
+    {
+        return m_phaseTimes;
+    }
+
 private:
     std::vector<EVENT_ENTRY> m_events;
+    std::string              m_phaseTimes;
 };
 
 }
@@ -40,6 +40,7 @@ MEANDER_PLACER::MEANDER_PLACER( ROUTER* aRouter ) :
     m_initialSegment = NULL;
     m_lastLength = 0;
     m_lastStatus = TOO_SHORT;
+    m_tunedPathLength = 0;
 }
 
 
@@ -82,6 +83,9 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentWidth = m_originLine.Width();
     m_currentEnd = VECTOR2I( 0, 0 );
 
+    m_tunedPathLength = origPathLength();
+    m_originLengths.Build( m_originLine.CLine() );
+
     return true;
 }
 
@@ -109,24 +113,24 @@ bool MEANDER_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
 
 bool MEANDER_PLACER::doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int aTargetLength )
 {
-    SHAPE_LINE_CHAIN pre, tuned, post;
+    SHAPE_LINE_CHAIN            pre, tuned, post;
+    LINE_LENGTH_INDEX::LOCATION tunedStart, tunedEnd;
 
     if( m_currentNode )
         delete m_currentNode;
 
     m_currentNode = m_world->Branch();
 
-    cutTunedLine( m_originLine.CLine(), m_currentStart, aP, pre, tuned, post );
+    cutTunedLine( m_originLine.CLine(), m_currentStart, aP, pre, tuned, post, tunedStart,
+                  tunedEnd );
 
     m_result = MEANDERED_LINE( this, false );
     m_result.SetWidth( m_originLine.Width() );
     m_result.SetBaselineOffset( 0 );
 
-    const std::vector<ssize_t>& tunedShapes = tuned.CShapes();
-
     for( int i = 0; i < tuned.SegmentCount(); i++ )
     {
-        if( tunedShapes[i] >= 0 )
+        if( tuned.ArcIndex( i ) >= 0 )
             continue;
 
         const SEG s = tuned.CSegment( i );
@@ -135,7 +139,7 @@ bool MEANDER_PLACER::doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int a
         m_result.AddCorner( s.B );
     }
 
-    long long int lineLen = origPathLength();
+    long long int lineLen = m_tunedPathLength;
 
     m_lastLength = lineLen;
     m_lastStatus = TUNED;
@@ -144,7 +148,7 @@ bool MEANDER_PLACER::doMove( const VECTOR2I& aP, ITEM* aEndItem, long long int a
     {
         m_lastStatus = TOO_LONG;
     } else {
-        m_lastLength = lineLen - tuned.Length();
+        m_lastLength = lineLen - m_originLengths.SpanLength( tunedStart, tunedEnd );
         tuneLineLength( m_result, aTargetLength - lineLen );
     }
 
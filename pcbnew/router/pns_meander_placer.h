@@ -113,6 +113,10 @@ protected:
     LINE     m_currentTrace;
     ITEM_SET m_tunedPath;
 
+    ///< origPathLength() as of Start(), the path only changes where it is being tuned
+    long long int     m_tunedPathLength;
+    LINE_LENGTH_INDEX m_originLengths;
+
     SHAPE_LINE_CHAIN m_finalShape;
     MEANDERED_LINE   m_result;
     LINKED_ITEM*     m_initialSegment;
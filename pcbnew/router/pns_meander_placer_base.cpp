@@ -27,6 +27,37 @@
 
 namespace PNS {
 
+void LINE_LENGTH_INDEX::Build( const SHAPE_LINE_CHAIN& aLine )
+{
+    long long int total = 0;
+
+    m_sums.clear();
+    m_sums.reserve( aLine.SegmentCount() + 1 );
+
+    for( int i = 0; i < aLine.SegmentCount(); i++ )
+    {
+        m_sums.push_back( total );
+        total += aLine.CSegment( i ).Length();
+    }
+
+    m_sums.push_back( total );
+}
+
+
+long long int LINE_LENGTH_INDEX::LengthAt( const LOCATION& aLocation ) const
+{
+    assert( aLocation.m_segment >= 0 && aLocation.m_segment < (int) m_sums.size() );
+
+    return m_sums[aLocation.m_segment] + aLocation.m_offset;
+}
+
+
+long long int LINE_LENGTH_INDEX::SpanLength( const LOCATION& aStart, const LOCATION& aEnd ) const
+{
+    return std::abs( LengthAt( aEnd ) - LengthAt( aStart ) );
+}
+
+
 MEANDER_PLACER_BASE::MEANDER_PLACER_BASE( ROUTER* aRouter ) :
         PLACEMENT_ALGO( aRouter )
 {
@@ -67,7 +98,9 @@ void MEANDER_PLACER_BASE::UpdateSettings( const MEANDER_SETTINGS& aSettings )
 
 void MEANDER_PLACER_BASE::cutTunedLine( const SHAPE_LINE_CHAIN& aOrigin, const VECTOR2I& aTuneStart,
                                         const VECTOR2I& aCursorPos, SHAPE_LINE_CHAIN& aPre,
-                                        SHAPE_LINE_CHAIN& aTuned, SHAPE_LINE_CHAIN& aPost )
+                                        SHAPE_LINE_CHAIN& aTuned, SHAPE_LINE_CHAIN& aPost,
+                                        LINE_LENGTH_INDEX::LOCATION& aTunedStart,
+                                        LINE_LENGTH_INDEX::LOCATION& aTunedEnd )
 {
     VECTOR2I cp ( aCursorPos );
 
@@ -86,21 +119,65 @@ void MEANDER_PLACER_BASE::cutTunedLine( const SHAPE_LINE_CHAIN& aOrigin, const V
         }
     }
 
-    VECTOR2I n = aOrigin.NearestPoint( cp, false );
-    VECTOR2I m = aOrigin.NearestPoint( aTuneStart, false );
+    int      segN = 0;
+    int      segM = 0;
+    VECTOR2I n = aOrigin.NearestPoint( cp, false, &segN );
+    VECTOR2I m = aOrigin.NearestPoint( aTuneStart, false, &segM );
+
+    aTunedStart = { segM, ( m - aOrigin.CPoint( segM ) ).EuclideanNorm() };
+    aTunedEnd = { segN, ( n - aOrigin.CPoint( segN ) ).EuclideanNorm() };
+
+    // The line is cut on the segments found above, rather than wherever the points show up
+    // first, as a self-touching line goes through them more than once
+    auto cutAt =
+            []( SHAPE_LINE_CHAIN& aLine, int aSegment, const VECTOR2I& aP ) -> int
+            {
+                if( aP == aLine.CPoint( aSegment ) )
+                    return aSegment;
+
+                if( aP == aLine.CPoint( aSegment + 1 ) )
+                    return aSegment + 1;
+
+                aLine.Insert( aSegment + 1, aP );
+                return aSegment + 1;
+            };
+
+    auto before =
+            []( const LINE_LENGTH_INDEX::LOCATION& aA, const LINE_LENGTH_INDEX::LOCATION& aB )
+            {
+                return aA.m_segment < aB.m_segment
+                       || ( aA.m_segment == aB.m_segment && aA.m_offset < aB.m_offset );
+            };
 
     SHAPE_LINE_CHAIN l( aOrigin );
-    l.Split( n );
-    l.Split( m );
+    bool             reversed = before( aTunedEnd, aTunedStart );
+    int              i_later, i_earlier;
+
+    // Cutting at the later point first keeps its index valid, unless a point is inserted
+    // before it by the second cut
+    if( reversed )
+        i_later = cutAt( l, segM, m );
+    else
+        i_later = cutAt( l, segN, n );
+
+    int count = l.PointCount();
+
+    if( reversed )
+        i_earlier = cutAt( l, segN, n );
+    else
+        i_earlier = cutAt( l, segM, m );
+
+    if( l.PointCount() > count )
+        i_later++;
 
-    int i_start = l.Find( m );
-    int i_end = l.Find( n );
+    int i_start = i_earlier;
+    int i_end = i_later;
 
-    if( i_start > i_end )
+    if( reversed )
     {
         l = l.Reverse();
-        i_start = l.Find( m );
-        i_end = l.Find( n );
+        i_start = l.PointCount() - 1 - i_later;
+        i_end = l.PointCount() - 1 - i_earlier;
     }
 
     aPre = l.Slice( 0, i_start );
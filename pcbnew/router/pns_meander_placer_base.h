@@ -40,6 +40,39 @@ class ROUTER;
 class SHOVE;
 class OPTIMIZER;
 
+/**
+ * Lengths along a line from its first point, kept as prefix sums per segment.  Given where a
+ * point is on the line, the length up to it is a single lookup.  The line being tuned doesn't
+ * change while tuning, so this is built once when tuning starts.
+ */
+class LINE_LENGTH_INDEX
+{
+public:
+    ///< A point of the line, as the segment it is on and its distance from the segment start.
+    struct LOCATION
+    {
+        int           m_segment;
+        long long int m_offset;
+    };
+
+    void Build( const SHAPE_LINE_CHAIN& aLine );
+
+    long long int Total() const
+    {
+        return m_sums.empty() ? 0 : m_sums.back();
+    }
+
+    ///< Return the length along the line up to \a aLocation.
+    long long int LengthAt( const LOCATION& aLocation ) const;
+
+    ///< Return the length of the part of the line between \a aStart and \a aEnd.
+    long long int SpanLength( const LOCATION& aStart, const LOCATION& aEnd ) const;
+
+private:
+    std::vector<long long int> m_sums;    ///< length up to the start of each segment, and total
+};
+
+
 /**
  * Base class for Single trace & Differential pair meandering tools, as both of them share a
  * lot of code.
@@ -120,10 +153,14 @@ protected:
      * @param aPre part before the beginning of meanders.
      * @param aTuned part to be meandered.
      * @param aPost part after the end of meanders.
+     * @param aTunedStart location of the first point of \a aTuned on \a aOrigin.
+     * @param aTunedEnd location of the last point of \a aTuned on \a aOrigin.
      */
-    void cutTunedLine( const SHAPE_LINE_CHAIN& aOrigin, const VECTOR2I& aTuneStart,
-                       const VECTOR2I& aCursorPos, SHAPE_LINE_CHAIN& aPre, SHAPE_LINE_CHAIN& aTuned,
-                       SHAPE_LINE_CHAIN& aPost );
+    static void cutTunedLine( const SHAPE_LINE_CHAIN& aOrigin, const VECTOR2I& aTuneStart,
+                              const VECTOR2I& aCursorPos, SHAPE_LINE_CHAIN& aPre,
+                              SHAPE_LINE_CHAIN& aTuned, SHAPE_LINE_CHAIN& aPost,
+                              LINE_LENGTH_INDEX::LOCATION& aTunedStart,
+                              LINE_LENGTH_INDEX::LOCATION& aTunedEnd );
 
     /**
      * Take a set of meanders in \a aTuned and tunes their length to extend the original line
@@ -100,6 +100,9 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
         m_coupledLength = itemsetLength( m_tunedPathP );
     }
 
+    m_tunedPathLength = origPathLength();
+    m_originLengths.Build( m_originLine.CLine() );
+
     return true;
 }
 
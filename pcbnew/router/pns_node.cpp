@@ -29,6 +29,9 @@
 #include <geometry/seg.h>
 #include <geometry/shape_line_chain.h>
 
+#include <hash_eda.h>
+#include <perf_counters.h>
+
 #include "pns_arc.h"
 #include "pns_item.h"
 #include "pns_line.h"
@@ -55,6 +58,8 @@ NODE::NODE()
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_ruleResolver = NULL;
     m_index = new INDEX;
+    m_generation = 0;
+    m_collisionCacheGeneration = 0;
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -462,6 +467,128 @@ NODE::OPT_OBSTACLE NODE::CheckColliding( const ITEM* aItemA, int aKindMask )
 }
 
 
+std::size_t NODE::COLLISION_KEY_HASH::operator()( const COLLISION_KEY& aKey ) const
+{
+    return hash_val( aKey.m_seg.A.x, aKey.m_seg.A.y, aKey.m_seg.B.x, aKey.m_seg.B.y, aKey.m_width,
+                     aKey.m_layerStart, aKey.m_layerEnd, aKey.m_net, aKey.m_kindMask );
+}
+
+
+NODE::OPT_OBSTACLE NODE::CheckCollidingCached( const ITEM* aItem, int aKindMask )
+{
+    if( aItem->Kind() == ITEM::SEGMENT_T )
+        return checkCollidingCached( static_cast<const SEGMENT*>( aItem ), aKindMask );
+
+    if( aItem->Kind() != ITEM::LINE_T )
+        return CheckColliding( aItem, aKindMask );
+
+    const LINE*             line = static_cast<const LINE*>( aItem );
+    const SHAPE_LINE_CHAIN& l = line->CLine();
+
+    for( int i = 0; i < l.SegmentCount(); i++ )
+    {
+        const SEGMENT s( *line, l.CSegment( i ) );
+        OPT_OBSTACLE  obs = checkCollidingCached( &s, aKindMask );
+
+        if( obs )
+            return obs;
+    }
+
+    if( line->EndsWithVia() )
+        return CheckColliding( &line->Via(), aKindMask );
+
+    return OPT_OBSTACLE();
+}
+
+
+NODE::OPT_OBSTACLE NODE::checkCollidingCached( const SEGMENT* aSeg, int aKindMask )
+{
+    OBSTACLES obs;
+
+    // The items of a branch change with every shove, so they are looked up as usual
+    if( !isRoot() )
+    {
+        DEFAULT_OBSTACLE_VISITOR visitor( obs, aSeg, aKindMask, true );
+
+        visitor.SetCountLimit( 1 );
+        visitor.SetWorld( this, NULL );
+        m_index->Query( aSeg, m_maxClearance, visitor );
+
+        if( !obs.empty() )
+            return OPT_OBSTACLE( obs[0] );
+    }
+
+    for( ITEM* item : m_root->cachedCollisions( aSeg, aKindMask ) )
+    {
+        if( Overrides( item ) )
+            continue;
+
+        OBSTACLE hit;
+
+        hit.m_item = item;
+        hit.m_head = aSeg;
+
+        return OPT_OBSTACLE( hit );
+    }
+
+    return OPT_OBSTACLE();
+}
+
+
+NODE::ITEM_VECTOR NODE::cachedCollisions( const SEGMENT* aSeg, int aKindMask )
+{
+    static PERF_COUNTER& hitCounter = PERF_COUNTERS::Get( "pns.collision_cache.hits" );
+    static PERF_COUNTER& missCounter = PERF_COUNTERS::Get( "pns.collision_cache.misses" );
+
+    COLLISION_KEY key = { aSeg->Seg(), aSeg->Width(), aSeg->Layers().Start(),
+                          aSeg->Layers().End(), aSeg->Net(), aKindMask };
+    uint64_t      generation;
+
+    {
+        std::lock_guard<std::mutex> lock( m_collisionCacheLock );
+
+        if( m_collisionCacheGeneration != m_generation
+                || m_collisionCache.size() >= MaxCachedCollisions )
+        {
+            m_collisionCache.clear();
+            m_collisionCacheGeneration = m_generation;
+        }
+
+        auto it = m_collisionCache.find( key );
+
+        if( it != m_collisionCache.end() )
+        {
+            hitCounter.Increment();
+            return it->second;
+        }
+
+        generation = m_generation;
+    }
+
+    missCounter.Increment();
+
+    // Keep all the hits, as some of them may be overridden in the branch asking next time.
+    // The root is only read here, so the query itself can run outside of the lock.
+    OBSTACLES                obs;
+    DEFAULT_OBSTACLE_VISITOR visitor( obs, aSeg, aKindMask, true );
+
+    visitor.SetWorld( this, NULL );
+    m_index->Query( aSeg, m_maxClearance, visitor );
+
+    ITEM_VECTOR items;
+
+    for( const OBSTACLE& hit : obs )
+        items.push_back( hit.m_item );
+
+    std::lock_guard<std::mutex> lock( m_collisionCacheLock );
+
+    if( m_collisionCacheGeneration == generation )
+        m_collisionCache.emplace( key, items );
+
+    return items;
+}
+
+
 struct HIT_VISITOR : public OBSTACLE_VISITOR
 {
     ITEM_SET& m_items;
@@ -526,6 +653,7 @@ void NODE::addSolid( SOLID* aSolid )
         linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
 
     m_index->Add( aSolid );
+    m_generation++;
 }
 
 
@@ -541,6 +669,7 @@ void NODE::addVia( VIA* aVia )
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
 
     m_index->Add( aVia );
+    m_generation++;
 }
 
 
@@ -609,6 +738,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
     m_index->Add( aSeg );
+    m_generation++;
 }
 
 
@@ -636,6 +766,7 @@ void NODE::addArc( ARC* aArc )
     linkJoint( aArc->Anchor( 1 ), aArc->Layers(), aArc->Net(), aArc );
 
     m_index->Add( aArc );
+    m_generation++;
 }
 
 
@@ -676,7 +807,10 @@ void NODE::doRemove( ITEM* aItem )
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    {
         m_index->Remove( aItem );
+        m_generation++;
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <list>
+#include <mutex>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -78,6 +79,12 @@ struct CONSTRAINT
     wxString        m_ToName;
 };
 
+/**
+ * Answer the design rule queries of the router.
+ *
+ * Clearance(), HoleClearance(), HoleToHoleClearance() and QueryConstraint() must be thread
+ * safe, as they are called by collision queries which may run on several threads at once.
+ */
 class RULE_RESOLVER
 {
 public:
@@ -146,7 +153,7 @@ protected:
  * - assembly of lines connecting joints, finding loops and unique paths.
  * - lightweight cloning/branching (for recursive optimization and shove springback).
  **/
-class NODE
+class NODE : public POOL_ALLOCATED
 {
 public:
     typedef OPT<OBSTACLE>         OPT_OBSTACLE;
@@ -171,12 +178,14 @@ public:
     void SetMaxClearance( int aClearance )
     {
         m_maxClearance = aClearance;
+        m_generation++;
     }
 
     ///< Assign a clearance resolution function object.
     void SetRuleResolver( RULE_RESOLVER* aFunc )
     {
         m_ruleResolver = aFunc;
+        m_generation++;
     }
 
     RULE_RESOLVER* GetRuleResolver() const
@@ -243,6 +252,17 @@ public:
      */
     OPT_OBSTACLE CheckColliding( const ITEM_SET&  aSet, int aKindMask = ITEM::ANY_T );
 
+    /**
+     * Same as CheckColliding(), but the root items hit by each segment are remembered in the
+     * root node until it changes.
+     *
+     * The root doesn't change while routing, so candidate segments tried again on every mouse
+     * move (e.g. by the optimizer) only query the items of this branch.  Root items this branch
+     * overrides (e.g. shoved ones) are skipped as usual.  Branches of the same root may call
+     * it from several threads, as the cache of the root is guarded by a lock.
+     */
+    OPT_OBSTACLE CheckCollidingCached( const ITEM* aItem, int aKindMask = ITEM::ANY_T );
+
     /**
      * Find all items that contain the point \a aPoint.
      *
@@ -413,6 +433,13 @@ private:
     void removeArcIndex( ARC* aVia );
 
     void doRemove( ITEM* aItem );
+
+    OPT_OBSTACLE checkCollidingCached( const SEGMENT* aSeg, int aKindMask );
+
+    ///< Return the items of this (root) node colliding with \a aSeg, from the cache if possible.
+    ///< Safe to call from several threads, as long as the root itself is not modified.
+    ITEM_VECTOR cachedCollisions( const SEGMENT* aSeg, int aKindMask );
+
     void unlinkParent();
     void releaseChildren();
     void releaseGarbage();
@@ -440,6 +467,33 @@ private:
     typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
     typedef JOINT_MAP::value_type TagJointPair;
 
+    ///< What the result of a segment collision query depends on
+    struct COLLISION_KEY
+    {
+        SEG  m_seg;
+        int  m_width;
+        int  m_layerStart;
+        int  m_layerEnd;
+        int  m_net;
+        int  m_kindMask;
+
+        bool operator==( const COLLISION_KEY& aOther ) const
+        {
+            return m_seg == aOther.m_seg && m_width == aOther.m_width
+                   && m_layerStart == aOther.m_layerStart && m_layerEnd == aOther.m_layerEnd
+                   && m_net == aOther.m_net && m_kindMask == aOther.m_kindMask;
+        }
+    };
+
+    struct COLLISION_KEY_HASH
+    {
+        std::size_t operator()( const COLLISION_KEY& aKey ) const;
+    };
+
+    typedef std::unordered_map<COLLISION_KEY, ITEM_VECTOR, COLLISION_KEY_HASH> COLLISION_CACHE;
+
+    static const size_t MaxCachedCollisions = 16384;
+
     JOINT_MAP       m_joints;           ///< hash table with the joints, linking the items. Joints
                                         ///< are hashed by their position, layer set and net.
 
@@ -455,6 +509,11 @@ private:
     INDEX*          m_index;            ///< Geometric/Net index of the items
     int             m_depth;            ///< depth of the node (number of parent nodes in the
                                         ///< inheritance chain)
+    uint64_t        m_generation;       ///< bumped whenever collision query results may change
+
+    COLLISION_CACHE m_collisionCache;           ///< see CheckCollidingCached()
+    uint64_t        m_collisionCacheGeneration; ///< m_generation the cache was filled at
+    std::mutex      m_collisionCacheLock;       ///< guards the two above
 
     std::unordered_set<ITEM*> m_garbageItems;
 };
@@ -41,7 +41,6 @@
 namespace PNS {
 
 
-static DEBUG_DECORATOR *g_dbg;
 /**
  *  Cost Estimator Methods
  */
@@ -122,7 +121,8 @@ OPTIMIZER::OPTIMIZER( NODE* aWorld ) :
     m_world( aWorld ),
     m_collisionKindMask( ITEM::ANY_T ),
     m_effortLevel( MERGE_SEGMENTS ),
-    m_restrictAreaIsStrict( false )
+    m_restrictAreaIsStrict( false ),
+    m_timeLimited( false )
 {
 }
 
@@ -132,91 +132,6 @@ OPTIMIZER::~OPTIMIZER()
 }
 
 
-struct OPTIMIZER::CACHE_VISITOR
-{
-    CACHE_VISITOR( const ITEM* aOurItem, NODE* aNode, int aMask ) :
-        m_ourItem( aOurItem ),
-        m_collidingItem( NULL ),
-        m_node( aNode ),
-        m_mask( aMask )
-    {}
-
-    bool operator()( ITEM* aOtherItem )
-    {
-        if( !( m_mask & aOtherItem->Kind() ) )
-            return true;
-
-        if( !aOtherItem->Collide( m_ourItem, m_node ) )
-            return true;
-
-        m_collidingItem = aOtherItem;
-        return false;
-    }
-
-    const ITEM* m_ourItem;
-    ITEM* m_collidingItem;
-    NODE* m_node;
-    int m_mask;
-};
-
-
-void OPTIMIZER::cacheAdd( ITEM* aItem, bool aIsStatic = false )
-{
-    if( m_cacheTags.find( aItem ) != m_cacheTags.end() )
-        return;
-
-    m_cache.Add( aItem );
-    m_cacheTags[aItem].m_hits = 1;
-    m_cacheTags[aItem].m_isStatic = aIsStatic;
-}
-
-
-void OPTIMIZER::removeCachedSegments( LINE* aLine, int aStartVertex, int aEndVertex )
-{
-    if( !aLine->IsLinked() )
-        return;
-
-    auto links = aLine->Links();
-
-    if( aEndVertex < 0 )
-        aEndVertex += aLine->PointCount();
-
-    for( int i = aStartVertex; i < aEndVertex - 1; i++ )
-    {
-        LINKED_ITEM* s = links[i];
-        m_cacheTags.erase( s );
-        m_cache.Remove( s );
-    }
-}
-
-
-void OPTIMIZER::CacheRemove( ITEM* aItem )
-{
-    if( aItem->Kind() == ITEM::LINE_T )
-        removeCachedSegments( static_cast<LINE*>( aItem ) );
-}
-
-
-void OPTIMIZER::ClearCache( bool aStaticOnly )
-{
-    if( !aStaticOnly )
-    {
-        m_cacheTags.clear();
-        m_cache.Clear();
-        return;
-    }
-
-    for( auto i = m_cacheTags.begin(); i!= m_cacheTags.end(); ++i )
-    {
-        if( i->second.m_isStatic )
-        {
-            m_cache.Remove( i->first );
-            m_cacheTags.erase( i->first );
-        }
-    }
-}
-
-
 bool AREA_CONSTRAINT::Check( int aVertex1, int aVertex2, const LINE* aOriginLine,
                              const SHAPE_LINE_CHAIN& aCurrentPath,
                              const SHAPE_LINE_CHAIN& aReplacement )
@@ -395,11 +310,11 @@ bool KEEP_TOPOLOGY_CONSTRAINT::Check( int aVertex1, int aVertex2, const LINE* aO
 }
 
 
-bool OPTIMIZER::checkColliding( ITEM* aItem, bool aUpdateCache )
+bool OPTIMIZER::checkColliding( ITEM* aItem )
 {
-    CACHE_VISITOR v( aItem, m_world, m_collisionKindMask );
-
-    return static_cast<bool>( m_world->CheckColliding( aItem ) );
+    // The optimizer tries the same shortcuts again on every mouse move, so let the world
+    // remember which of its static items they hit
+    return static_cast<bool>( m_world->CheckCollidingCached( aItem ) );
 }
 
 
@@ -495,7 +410,6 @@ bool OPTIMIZER::mergeObtuse( LINE* aLine )
                     if( !checkColliding( &opt_track ) )
                     {
                         current_path.Replace( s1.Index() + 1, s2.Index(), ip );
-                        // removeCachedSegments(aLine, s1.Index(), s2.Index());
                         n_segs = current_path.SegmentCount();
                         found_anything = true;
                         break;
@@ -545,6 +459,13 @@ bool OPTIMIZER::mergeFull( LINE* aLine )
         if( step < 1 )
             break;
 
+        // Whatever has been merged so far is still a valid line
+        if( m_timeLimited && m_timeLimit.Expired() )
+        {
+            ROUTER::GetInstance()->PhaseProfile().AddExpired( PHASE::OPTIMIZE );
+            break;
+        }
+
         bool found_anything = mergeStep( aLine, current_path, step );
 
         if( !found_anything )
@@ -591,6 +512,19 @@ bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
         aResult->ClearLinks();
     }
 
+    ROUTER* router = ROUTER::GetInstance();
+
+    SCOPED_PHASE_TIMER timer( router ? &router->PhaseProfile() : nullptr, PHASE::OPTIMIZE );
+
+    m_timeLimited = router && router->OperationTimeLimit();
+
+    if( m_timeLimited )
+    {
+        m_timeLimit = router->Settings().OptimizerTimeLimit();
+        m_timeLimit.SetParent( router->OperationTimeLimit() );
+        m_timeLimit.Restart();
+    }
+
     bool hasArcs = aLine->ArcCount();
     bool rv = false;
 
@@ -1042,8 +976,6 @@ bool OPTIMIZER::Optimize( LINE* aLine, int aEffortLevel, NODE* aWorld, const VEC
 {
     OPTIMIZER opt( aWorld );
 
-    g_dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-
     opt.SetEffortLevel( aEffortLevel );
     opt.SetCollisionMask( -1 );
 
@@ -1090,7 +1022,7 @@ bool OPTIMIZER::fanoutCleanup( LINE* aLine )
             LINE repl;
             repl = LINE( *aLine, l2 );
 
-            if( !m_world->CheckColliding( &repl ) )
+            if( !checkColliding( &repl ) )
             {
                 aLine->SetShape( repl.CLine() );
                 return true;
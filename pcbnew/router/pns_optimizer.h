@@ -23,13 +23,12 @@
 #ifndef __PNS_OPTIMIZER_H
 #define __PNS_OPTIMIZER_H
 
-#include <unordered_map>
 #include <memory>
 
-#include <geometry/shape_index_list.h>
 #include <geometry/shape_line_chain.h>
 
 #include "range.h"
+#include "time_limit.h"
 
 
 namespace PNS {
@@ -119,8 +118,6 @@ public:
 
 
     void SetWorld( NODE* aNode ) { m_world = aNode; }
-    void CacheRemove( ITEM* aItem );
-    void ClearCache( bool aStaticOnly = false );
 
     void SetCollisionMask( int aMask )
     {
@@ -155,18 +152,8 @@ public:
     void AddConstraint ( OPT_CONSTRAINT *aConstraint );
 
 private:
-    static const int MaxCachedItems = 256;
-
     typedef std::vector<SHAPE_LINE_CHAIN> BREAKOUT_LIST;
 
-    struct CACHE_VISITOR;
-
-    struct CACHED_ITEM
-    {
-        int m_hits;
-        bool m_isStatic;
-    };
-
     bool mergeObtuse( LINE* aLine );
     bool mergeFull( LINE* aLine );
     bool mergeColinear( LINE* aLine );
@@ -176,12 +163,9 @@ private:
     bool mergeDpSegments( DIFF_PAIR *aPair );
     bool mergeDpStep( DIFF_PAIR *aPair, bool aTryP, int step );
 
-    bool checkColliding( ITEM* aItem, bool aUpdateCache = true );
+    bool checkColliding( ITEM* aItem );
     bool checkColliding( LINE* aLine, const SHAPE_LINE_CHAIN& aOptPath );
 
-    void cacheAdd( ITEM* aItem, bool aIsStatic );
-    void removeCachedSegments( LINE* aLine, int aStartVertex = 0, int aEndVertex = -1 );
-
     bool checkConstraints(  int aVertex1, int aVertex2, LINE* aOriginLine,
                             const SHAPE_LINE_CHAIN& aCurrentPath,
                             const SHAPE_LINE_CHAIN& aReplacement );
@@ -196,9 +180,7 @@ private:
     ITEM* findPadOrVia( int aLayer, int aNet, const VECTOR2I& aP ) const;
 
 private:
-    SHAPE_INDEX_LIST<ITEM*>                m_cache;
-    std::vector<OPT_CONSTRAINT*>           m_constraints;
-    std::unordered_map<ITEM*, CACHED_ITEM> m_cacheTags;
+    std::vector<OPT_CONSTRAINT*> m_constraints;
 
     NODE*               m_world;
     int                 m_collisionKindMask;
@@ -208,6 +190,9 @@ private:
     std::pair<int, int> m_restrictedVertexRange;
     BOX2I               m_restrictArea;
     bool                m_restrictAreaIsStrict;
+
+    TIME_LIMIT          m_timeLimit;
+    bool                m_timeLimited;      ///< only within an operation of the router
 };
 
 
@@ -0,0 +1,126 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include "pns_phase_profile.h"
+
+namespace PNS {
+
+static const int PhaseCount = static_cast<int>( PHASE::COUNT );
+
+
+static PERF_COUNTER& globalCounter( PHASE aPhase )
+{
+    static PERF_COUNTER* counters[PhaseCount] = {
+        &PERF_COUNTERS::Get( "pns.phase.shove" ),
+        &PERF_COUNTERS::Get( "pns.phase.walkaround" ),
+        &PERF_COUNTERS::Get( "pns.phase.optimize" ),
+        &PERF_COUNTERS::Get( "pns.phase.rules" )
+    };
+
+    return *counters[ static_cast<int>( aPhase ) ];
+}
+
+
+PHASE_PROFILE::PHASE_PROFILE()
+{
+    for( int i = 0; i < PhaseCount; i++ )
+    {
+        m_counters.push_back( std::make_unique<PERF_COUNTER>(
+                PhaseName( static_cast<PHASE>( i ) ) ) );
+        m_expired[i] = 0;
+    }
+}
+
+
+void PHASE_PROFILE::Reset()
+{
+    for( int i = 0; i < PhaseCount; i++ )
+    {
+        m_counters[i]->Reset();
+        m_expired[i] = 0;
+    }
+}
+
+
+void PHASE_PROFILE::AddSample( PHASE aPhase, std::chrono::nanoseconds aDuration )
+{
+    m_counters[ static_cast<int>( aPhase ) ]->AddSample( aDuration );
+}
+
+
+void PHASE_PROFILE::AddExpired( PHASE aPhase )
+{
+    m_expired[ static_cast<int>( aPhase ) ]++;
+}
+
+
+const char* PHASE_PROFILE::PhaseName( PHASE aPhase )
+{
+    switch( aPhase )
+    {
+    case PHASE::SHOVE:      return "shove";
+    case PHASE::WALKAROUND: return "walkaround";
+    case PHASE::OPTIMIZE:   return "optimize";
+    case PHASE::RULES:      return "rules";
+    default:                return "?";
+    }
+}
+
+
+std::string PHASE_PROFILE::Format() const
+{
+    std::string result;
+    char        line[128];
+
+    for( int i = 0; i < PhaseCount; i++ )
+    {
+        const PERF_COUNTER& counter = *m_counters[i];
+
+        snprintf( line, sizeof( line ), "phase %s %llu %.3f %.3f %llu\n",
+                  counter.GetName().c_str(), (unsigned long long) counter.GetCount(),
+                  counter.GetTotalMs(), counter.GetMaxMs(),
+                  (unsigned long long) m_expired[i].load() );
+
+        result += line;
+    }
+
+    return result;
+}
+
+
+SCOPED_PHASE_TIMER::SCOPED_PHASE_TIMER( PHASE_PROFILE* aProfile, PHASE aPhase ) :
+        m_profile( aProfile ),
+        m_phase( aPhase )
+{
+}
+
+
+SCOPED_PHASE_TIMER::~SCOPED_PHASE_TIMER()
+{
+    std::chrono::nanoseconds duration = m_timer.SinceStart<std::chrono::nanoseconds>();
+
+    globalCounter( m_phase ).AddSample( duration );
+
+    if( m_profile )
+        m_profile->AddSample( m_phase, duration );
+}
+
+}
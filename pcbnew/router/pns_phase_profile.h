@@ -0,0 +1,107 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_PHASE_PROFILE_H
+#define __PNS_PHASE_PROFILE_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <perf_counters.h>
+
+namespace PNS {
+
+///< The parts of a router operation which are timed separately
+enum class PHASE
+{
+    SHOVE = 0,
+    WALKAROUND,
+    OPTIMIZE,
+    RULES,          ///< design rule queries through the RULE_RESOLVER
+    COUNT
+};
+
+
+/**
+ * PHASE_PROFILE
+ *
+ * Where the time of the current router operation went: how long each phase ran and how often
+ * it ran out of its time budget.  Phases nest, e.g. the rule queries of a shove count towards
+ * both.  Samples may be added from several threads at once.
+ *
+ * Every sample also goes to the application wide "pns.phase.<name>" PERF_COUNTERS.
+ */
+class PHASE_PROFILE
+{
+public:
+    PHASE_PROFILE();
+
+    void Reset();
+
+    void AddSample( PHASE aPhase, std::chrono::nanoseconds aDuration );
+
+    ///< Record that \a aPhase gave up because its time budget was used up.
+    void AddExpired( PHASE aPhase );
+
+    const PERF_COUNTER& Counter( PHASE aPhase ) const
+    {
+        return *m_counters[ static_cast<int>( aPhase ) ];
+    }
+
+    uint64_t ExpiredCount( PHASE aPhase ) const
+    {
+        return m_expired[ static_cast<int>( aPhase ) ];
+    }
+
+    static const char* PhaseName( PHASE aPhase );
+
+    /**
+     * Return one line per phase, in the format of the router event log:
+     *
+     *     phase <name> <runs> <total ms> <max ms> <budget overruns>
+     */
+    std::string Format() const;
+
+private:
+    std::vector<std::unique_ptr<PERF_COUNTER>> m_counters;
+    std::atomic<uint64_t>                      m_expired[ static_cast<int>( PHASE::COUNT ) ];
+};
+
+
+/**
+ * Time the enclosing scope as a run of \a aPhase.  The profile may be null, in which case only
+ * the application wide counters are updated.
+ */
+class SCOPED_PHASE_TIMER
+{
+public:
+    SCOPED_PHASE_TIMER( PHASE_PROFILE* aProfile, PHASE aPhase );
+    ~SCOPED_PHASE_TIMER();
+
+private:
+    PHASE_PROFILE* m_profile;
+    PHASE          m_phase;
+    PROF_COUNTER   m_timer;
+};
+
+}
+
+#endif
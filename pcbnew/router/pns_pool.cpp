@@ -0,0 +1,170 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pns_pool.h"
+
+#include <mutex>
+#include <new>
+#include <set>
+#include <vector>
+
+#include <perf_counters.h>
+
+namespace PNS {
+
+///< Blocks sizes are rounded up to a multiple of this
+static const size_t GRANULARITY = 16;
+
+///< Larger blocks are not pooled
+static const size_t MAX_POOLED_SIZE = 1024;
+
+static const size_t SIZE_CLASS_COUNT = MAX_POOLED_SIZE / GRANULARITY;
+
+///< Free blocks kept per size class and thread.  More are released right away, so that a
+///< burst of allocations doesn't keep its memory forever.
+static const size_t MAX_FREE_BLOCKS = 16384;
+
+
+struct FREE_LISTS;
+
+
+///< The free lists of all the threads, so that Trim() can release them all
+struct FREE_LISTS_REGISTRY
+{
+    std::mutex             m_lock;
+    std::set<FREE_LISTS*>  m_lists;
+};
+
+
+static FREE_LISTS_REGISTRY& registry()
+{
+    static FREE_LISTS_REGISTRY s_registry;
+    return s_registry;
+}
+
+
+struct FREE_LISTS
+{
+    FREE_LISTS()
+    {
+        std::lock_guard<std::mutex> lock( registry().m_lock );
+        registry().m_lists.insert( this );
+    }
+
+    ~FREE_LISTS()
+    {
+        {
+            std::lock_guard<std::mutex> lock( registry().m_lock );
+            registry().m_lists.erase( this );
+        }
+
+        Release();
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        for( std::vector<void*>& list : m_lists )
+        {
+            for( void* block : list )
+                ::operator delete( block );
+
+            list.clear();
+            list.shrink_to_fit();
+        }
+    }
+
+    ///< Only contended while another thread trims the lists
+    std::mutex         m_lock;
+    std::vector<void*> m_lists[SIZE_CLASS_COUNT];
+};
+
+
+static FREE_LISTS& freeLists()
+{
+    static thread_local FREE_LISTS s_lists;
+    return s_lists;
+}
+
+
+void* POOL::Alloc( size_t aSize )
+{
+    if( aSize == 0 || aSize > MAX_POOLED_SIZE )
+        return ::operator new( aSize );
+
+    size_t      sizeClass = ( aSize - 1 ) / GRANULARITY;
+    FREE_LISTS& lists = freeLists();
+
+    {
+        std::lock_guard<std::mutex> lock( lists.m_lock );
+        std::vector<void*>&         list = lists.m_lists[sizeClass];
+
+        if( !list.empty() )
+        {
+            void* block = list.back();
+            list.pop_back();
+            return block;
+        }
+    }
+
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "pns.pool.system_allocs" );
+    counter.Increment();
+
+    return ::operator new( ( sizeClass + 1 ) * GRANULARITY );
+}
+
+
+void POOL::Free( void* aBlock, size_t aSize )
+{
+    if( !aBlock )
+        return;
+
+    if( aSize == 0 || aSize > MAX_POOLED_SIZE )
+    {
+        ::operator delete( aBlock );
+        return;
+    }
+
+    FREE_LISTS& lists = freeLists();
+
+    {
+        std::lock_guard<std::mutex> lock( lists.m_lock );
+        std::vector<void*>&         list = lists.m_lists[( aSize - 1 ) / GRANULARITY];
+
+        if( list.size() < MAX_FREE_BLOCKS )
+        {
+            list.push_back( aBlock );
+            return;
+        }
+    }
+
+    ::operator delete( aBlock );
+}
+
+
+void POOL::Trim()
+{
+    std::lock_guard<std::mutex> lock( registry().m_lock );
+
+    for( FREE_LISTS* lists : registry().m_lists )
+        lists->Release();
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_POOL_H
+#define __PNS_POOL_H
+
+#include <cstddef>
+
+namespace PNS {
+
+/**
+ * POOL
+ *
+ * Recycles the memory of the objects the router creates and destroys at a high rate while
+ * routing: nodes and items.  Shove and walkaround branch the world and clone items on every
+ * mouse move, and without the pool each of those goes through the global allocator.
+ *
+ * Freed blocks are kept in per-thread free lists, by size class, and handed out again by the
+ * next allocation of the same size class.  A block may be freed by another thread than the one
+ * which allocated it.  Trim() returns the blocks kept by all the threads (including the workers
+ * of the thread pool) to the system; the router calls it when a routing session ends.
+ */
+class POOL
+{
+public:
+    static void* Alloc( size_t aSize );
+    static void  Free( void* aBlock, size_t aSize );
+
+    /**
+     * Release the free blocks of all the threads.
+     */
+    static void Trim();
+};
+
+
+/**
+ * Base class of the router objects allocated from the POOL.  The class has to have a virtual
+ * destructor if it is deleted through a pointer to its base class, so that the size of the
+ * block is known.
+ */
+class POOL_ALLOCATED
+{
+public:
+    static void* operator new( size_t aSize )
+    {
+        return POOL::Alloc( aSize );
+    }
+
+    static void operator delete( void* aBlock, size_t aSize )
+    {
+        POOL::Free( aBlock, aSize );
+    }
+};
+
+}
+
+#endif
@@ -51,9 +51,48 @@
 #include "pns_meander_placer.h"
 #include "pns_meander_skew_placer.h"
 #include "pns_dp_meander_placer.h"
+#include "pns_debug_decorator.h"
+#include "pns_logger.h"
 
 namespace PNS {
 
+/**
+ * Times one router operation against its budget.  When the outermost operation ends, its
+ * phase times go to the event log and the debug decorator.
+ */
+class ROUTER::OPERATION_SCOPE
+{
+public:
+    OPERATION_SCOPE( ROUTER* aRouter ) :
+            m_router( aRouter )
+    {
+        if( m_router->m_operationDepth++ == 0 )
+        {
+            m_router->m_operationTimeLimit = m_router->Settings().OperationTimeLimit();
+            m_router->m_operationTimeLimit.Restart();
+        }
+    }
+
+    ~OPERATION_SCOPE()
+    {
+        if( --m_router->m_operationDepth > 0 )
+            return;
+
+        DEBUG_DECORATOR* dbg = m_router->m_iface ? m_router->m_iface->GetDebugDecorator()
+                                                 : nullptr;
+
+        if( m_router->m_logger )
+            m_router->m_logger->SetPhaseTimes( m_router->m_phaseProfile );
+
+        if( dbg )
+            dbg->ReportPhaseTimes( m_router->m_phaseProfile );
+    }
+
+private:
+    ROUTER* m_router;
+};
+
+
 // an ugly singleton for drawing debug items within the router context.
 // To be fixed sometime in the future.
 static ROUTER* theRouter;
@@ -72,7 +111,11 @@ ROUTER::ROUTER()
     m_iterLimit = 0;
     m_settings = nullptr;
     m_iface = nullptr;
+    m_operationDepth = 0;
     m_visibleViewArea.SetMaximum();
+
+    // Measured here rather than on the first check of a budget, which it would be charged to
+    TIME_LIMIT::Calibrate();
 }
 
 
@@ -85,7 +128,10 @@ ROUTER* ROUTER::GetInstance()
 ROUTER::~ROUTER()
 {
     ClearWorld();
-    theRouter = nullptr;
+
+    if( theRouter == this )
+        theRouter = nullptr;
+
     delete m_logger;
 }
 
@@ -137,6 +183,10 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM_SET aStartItems, int aDragM
     if( aStartItems.Empty() )
         return false;
 
+    m_phaseProfile.Reset();
+
+    OPERATION_SCOPE operation( this );
+
     if( aStartItems.Count( ITEM::SOLID_T ) == aStartItems.Size() )
     {
         m_dragger = std::make_unique<COMPONENT_DRAGGER>( this );
@@ -341,6 +391,10 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, ITEM* aStartItem,
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    m_phaseProfile.Reset();
+
+    OPERATION_SCOPE operation( this );
+
     if( !isStartingPointRoutable( aP, aStartItem, aLayer ) )
         return false;
 
@@ -396,6 +450,8 @@ bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    OPERATION_SCOPE operation( this );
+
     m_currentEnd = aP;
 
     if( m_logger )
@@ -620,7 +676,8 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
-    bool rv = false;
+    OPERATION_SCOPE operation( this );
+    bool            rv = false;
 
     if( m_logger )
         m_logger->Log( LOGGER::EVT_FIX, aP, aEndItem );
@@ -686,6 +743,9 @@ void ROUTER::StopRouting()
     m_state = IDLE;
     m_world->KillChildren();
     m_world->ClearRanks();
+
+    // The branches are gone, don't keep their memory until the next routing session
+    POOL::Trim();
 }
 
 
@@ -31,6 +31,7 @@
 #include <geometry/shape_line_chain.h>
 #include <math/box2.h>
 
+#include "pns_phase_profile.h"
 #include "pns_routing_settings.h"
 #include "pns_sizes_settings.h"
 #include "pns_item.h"
@@ -227,7 +228,19 @@ public:
         return m_visibleViewArea;
     }
 
+    ///< Return where the time of the current routing or dragging session went.
+    PHASE_PROFILE& PhaseProfile() { return m_phaseProfile; }
+
+    ///< Return the budget of the operation (start, move or fix) in progress, or null outside
+    ///< of one.  The time limits of the algorithms are a part of it.
+    const TIME_LIMIT* OperationTimeLimit() const
+    {
+        return m_operationDepth ? &m_operationTimeLimit : nullptr;
+    }
+
 private:
+    class OPERATION_SCOPE;
+
     void movePlacing( const VECTOR2I& aP, ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, ITEM* aItem );
 
@@ -259,6 +272,10 @@ private:
     ROUTER_MODE       m_mode;
     LOGGER*           m_logger;
 
+    PHASE_PROFILE     m_phaseProfile;
+    TIME_LIMIT        m_operationTimeLimit;
+    int               m_operationDepth;    ///< number of nested OPERATION_SCOPEs
+
     wxString          m_toolStatusbarName;
     wxString          m_failureReason;
 };
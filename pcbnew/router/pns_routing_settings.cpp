@@ -43,6 +43,9 @@ ROUTING_SETTINGS::ROUTING_SETTINGS( JSON_SETTINGS* aParent, const std::string& a
     m_shoveIterationLimit = 250;
     m_shoveTimeLimit = 1000;
     m_walkaroundIterationLimit = 40;
+    m_walkaroundTimeLimit = 1000;
+    m_optimizerTimeLimit = 500;
+    m_operationTimeLimit = 2000;
     m_jumpOverObstacles = false;
     m_smoothDraggedSegments = true;
     m_canViolateDRC = false;
@@ -81,6 +84,40 @@ ROUTING_SETTINGS::ROUTING_SETTINGS( JSON_SETTINGS* aParent, const std::string& a
             1000 ) );
 
     m_params.emplace_back( new PARAM<int>( "walkaround_iteration_limit", &m_walkaroundIterationLimit, 40 ) );
+
+    m_params.emplace_back( new PARAM_LAMBDA<int>( "walkaround_time_limit",
+            [this] () -> int
+            {
+                return m_walkaroundTimeLimit.Get();
+            },
+            [this] ( int aVal )
+            {
+                m_walkaroundTimeLimit.Set( aVal );
+            },
+            1000 ) );
+
+    m_params.emplace_back( new PARAM_LAMBDA<int>( "optimizer_time_limit",
+            [this] () -> int
+            {
+                return m_optimizerTimeLimit.Get();
+            },
+            [this] ( int aVal )
+            {
+                m_optimizerTimeLimit.Set( aVal );
+            },
+            500 ) );
+
+    m_params.emplace_back( new PARAM_LAMBDA<int>( "operation_time_limit",
+            [this] () -> int
+            {
+                return m_operationTimeLimit.Get();
+            },
+            [this] ( int aVal )
+            {
+                m_operationTimeLimit.Set( aVal );
+            },
+            2000 ) );
+
     m_params.emplace_back( new PARAM<bool>( "jump_over_obstacles",       &m_jumpOverObstacles, false ) );
 
     m_params.emplace_back( new PARAM<bool>( "smooth_dragged_segments",   &m_smoothDraggedSegments, true ) );
@@ -118,6 +155,24 @@ TIME_LIMIT ROUTING_SETTINGS::ShoveTimeLimit() const
 }
 
 
+TIME_LIMIT ROUTING_SETTINGS::WalkaroundTimeLimit() const
+{
+    return TIME_LIMIT( m_walkaroundTimeLimit );
+}
+
+
+TIME_LIMIT ROUTING_SETTINGS::OptimizerTimeLimit() const
+{
+    return TIME_LIMIT( m_optimizerTimeLimit );
+}
+
+
+TIME_LIMIT ROUTING_SETTINGS::OperationTimeLimit() const
+{
+    return TIME_LIMIT( m_operationTimeLimit );
+}
+
+
 int ROUTING_SETTINGS::ShoveIterationLimit() const
 {
     return m_shoveIterationLimit;
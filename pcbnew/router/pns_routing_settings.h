@@ -143,6 +143,12 @@ public:
     int WalkaroundIterationLimit() const { return m_walkaroundIterationLimit; };
     TIME_LIMIT WalkaroundTimeLimit() const;
 
+    TIME_LIMIT OptimizerTimeLimit() const;
+
+    ///< Return the budget of a whole router operation (e.g. a mouse move), which the budgets
+    ///< of the shove, walkaround and optimizer are a part of.
+    TIME_LIMIT OperationTimeLimit() const;
+
     void SetInlineDragEnabled ( bool aEnable ) { m_inlineDragEnabled = aEnable; }
     bool InlineDragEnabled() const { return m_inlineDragEnabled; }
 
@@ -191,6 +197,8 @@ private:
     int m_shoveIterationLimit;
     TIME_LIMIT m_shoveTimeLimit;
     TIME_LIMIT m_walkaroundTimeLimit;
+    TIME_LIMIT m_optimizerTimeLimit;
+    TIME_LIMIT m_operationTimeLimit;
 };
 
 }
@@ -1247,11 +1247,14 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
     wxLogTrace( "PNS", "ShoveStart [root: %d jts, current: %d jts]", m_root->JointCount(),
            m_currentNode->JointCount() );
 
+    SCOPED_PHASE_TIMER phaseTimer( &Router()->PhaseProfile(), PHASE::SHOVE );
+
     int iterLimit = Settings().ShoveIterationLimit();
     TIME_LIMIT timeLimit = Settings().ShoveTimeLimit();
 
     m_iter = 0;
 
+    timeLimit.SetParent( Router()->OperationTimeLimit() );
     timeLimit.Restart();
 
     if( m_lineStack.empty() && m_draggedVia )
@@ -1267,8 +1270,15 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
 
         m_iter++;
 
-        if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit )
+        if( st == SH_INCOMPLETE || m_iter >= iterLimit )
+        {
+            st = SH_INCOMPLETE;
+            break;
+        }
+
+        if( timeLimit.Expired() )
         {
+            Router()->PhaseProfile().AddExpired( PHASE::SHOVE );
             st = SH_INCOMPLETE;
             break;
         }
@@ -81,7 +81,7 @@ public:
         m_diameter = aB.m_diameter;
         m_shape = SHAPE_CIRCLE( m_pos, m_diameter / 2 );
         m_hole = SHAPE_CIRCLE( m_pos, aB.m_drill / 2 );
-        m_marker = aB.m_marker;
+        m_marker = aB.m_marker.load();
         m_rank = aB.m_rank;
         m_drill = aB.m_drill;
         m_viaType = aB.m_viaType;
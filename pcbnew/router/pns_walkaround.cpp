@@ -22,6 +22,7 @@
 #include <core/optional.h>
 
 #include <geometry/shape_line_chain.h>
+#include <thread_pool.h>
 
 #include "pns_walkaround.h"
 #include "pns_optimizer.h"
@@ -35,6 +36,10 @@ void WALKAROUND::start( const LINE& aInitialPath )
 {
     m_iteration = 0;
     m_iterationLimit = 50;
+
+    m_timeLimit = Settings().WalkaroundTimeLimit();
+    m_timeLimit.SetParent( Router()->OperationTimeLimit() );
+    m_timeLimit.Restart();
 }
 
 
@@ -52,49 +57,47 @@ NODE::OPT_OBSTACLE WALKAROUND::nearestObstacle( const LINE& aPath )
 }
 
 
-WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
-                                                              bool aWindingDirection )
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( WALK_STATE& aState, int aIteration )
 {
-    OPT<OBSTACLE>& current_obs =
-        aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
+    LINE&          path = aState.path;
+    bool           windingDirection = aState.cw;
+    OPT<OBSTACLE>& current_obs = aState.currentObstacle;
 
     if( !current_obs )
         return DONE;
 
     SHAPE_LINE_CHAIN path_walk[2];
 
-    if( aPath.PointCount() > 1 )
+    if( path.PointCount() > 1 )
     {
-        VECTOR2I last = aPath.CPoint( -1 );
+        VECTOR2I last = path.CPoint( -1 );
 
         if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
         {
-            m_recursiveBlockageCount++;
+            aState.recursiveBlockageCount++;
 
-            if( m_recursiveBlockageCount < 3 )
-                aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
+            if( aState.recursiveBlockageCount < 3 )
+                path.Line().Append( current_obs->m_hull.NearestPoint( last ) );
             else
             {
-                aPath = aPath.ClipToNearestObstacle( m_world );
+                path = path.ClipToNearestObstacle( m_world );
                 return DONE;
             }
         }
     }
 
-    aPath.Walkaround( current_obs->m_hull, path_walk[0],
-                      aWindingDirection );
-    aPath.Walkaround( current_obs->m_hull, path_walk[1],
-                      !aWindingDirection );
+    path.Walkaround( current_obs->m_hull, path_walk[0], windingDirection );
+    path.Walkaround( current_obs->m_hull, path_walk[1], !windingDirection );
 
-    if( !aPath.Walkaround( current_obs->m_hull, path_walk[1], !aWindingDirection ) )
+    if( !path.Walkaround( current_obs->m_hull, path_walk[1], !windingDirection ) )
         return STUCK;
 
-    auto l =aPath.CLine();
+    auto l =path.CLine();
 
 #if 0
     if( m_logger )
     {
-        m_logger->NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger->NewGroup( windingDirection ? "walk-cw" : "walk-ccw", aIteration );
         m_logger->Log( &path_walk[0], 0, "path_walk" );
         m_logger->Log( &path_pre[0], 1, "path_pre" );
         m_logger->Log( &path_post[0], 4, "path_post" );
@@ -107,17 +110,17 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
     {
         Dbg()->BeginGroup("hull/walk");
         char name[128];
-        snprintf(name, sizeof(name), "hull-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
+        snprintf(name, sizeof(name), "hull-%s-%d", windingDirection ? "cw" : "ccw", aIteration );
         Dbg()->AddLine( current_obs->m_hull, 1, 1, name);
-        snprintf(name, sizeof(name), "path-%s-%d", aWindingDirection ? "cw" : "ccw", m_iteration );
-        Dbg()->AddLine( aPath.CLine(), 2, 1, name );
+        snprintf(name, sizeof(name), "path-%s-%d", windingDirection ? "cw" : "ccw", aIteration );
+        Dbg()->AddLine( path.CLine(), 2, 1, name );
         Dbg()->EndGroup();
     }
 
     int len_pre = path_walk[0].Length();
     int len_alt = path_walk[1].Length();
 
-    LINE walk_path( aPath, path_walk[1] );
+    LINE walk_path( path, path_walk[1] );
 
     bool alt_collides = static_cast<bool>( m_world->CheckColliding( &walk_path, m_itemMask ) );
 
@@ -130,25 +133,25 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         pnew.Append( path_post[1] );
 
         if( !path_post[1].PointCount() || !path_walk[1].PointCount() )
-            current_obs = nearestObstacle( LINE( aPath, path_pre[1] ) );
+            current_obs = nearestObstacle( LINE( path, path_pre[1] ) );
         else
-            current_obs = nearestObstacle( LINE( aPath, path_post[1] ) );
+            current_obs = nearestObstacle( LINE( path, path_post[1] ) );
     }
     else*/
     {
         pnew = path_walk[0];
-        current_obs = nearestObstacle( LINE( aPath, path_walk[0] ) );
+        current_obs = nearestObstacle( LINE( path, path_walk[0] ) );
     }
 
     pnew.Simplify();
-    aPath.SetShape( pnew );
+    path.SetShape( pnew );
 
     return IN_PROGRESS;
 }
 
 
 
-bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
+static bool clipToLoopStart( SHAPE_LINE_CHAIN& l, DEBUG_DECORATOR* aDbg )
 {
     auto ip = l.SelfIntersecting();
 
@@ -161,8 +164,8 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
         int pidx2 = tail.Split( ip->p );
 
-        auto dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
-        dbg->AddPoint( ip->p, 5 );
+        if( aDbg )
+            aDbg->AddPoint( ip->p, 5 );
 
         l = lead;
         l.Append( tail.Slice( 0, pidx2 ) );
@@ -175,11 +178,37 @@ bool clipToLoopStart( SHAPE_LINE_CHAIN& l )
 
 
 
+void WALKAROUND::walk( WALK_STATE& aState, int aMilliseconds )
+{
+    DEBUG_DECORATOR* dbg = Router()->GetInterface()->GetDebugDecorator();
+    TIME_LIMIT       timeLimit( aMilliseconds );
+
+    timeLimit.SetParent( &m_timeLimit );
+
+    for( int iter = 0; iter < m_iterationLimit && aState.status == IN_PROGRESS; iter++ )
+    {
+        if( timeLimit.Expired() )
+        {
+            Router()->PhaseProfile().AddExpired( PHASE::WALKAROUND );
+            break;
+        }
+
+        aState.status = singleStep( aState, iter );
+
+        if( clipToLoopStart( aState.path.Line(), dbg ) )
+            aState.status = ALMOST_DONE;
+    }
+
+    if( aState.status == IN_PROGRESS )
+        aState.status = ALMOST_DONE;
+}
+
+
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
-    LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
-    WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
-    SHAPE_LINE_CHAIN best_path;
+    SCOPED_PHASE_TIMER timer( &Router()->PhaseProfile(), PHASE::WALKAROUND );
+
+    WALK_STATE cw( aInitialPath, true ), ccw( aInitialPath, false );
     RESULT result;
 
     // special case for via-in-the-middle-of-track placement
@@ -193,67 +222,59 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 
     start( aInitialPath );
 
-    m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
-
-    result.lineCw = aInitialPath;
-    result.lineCcw = aInitialPath;
+    cw.currentObstacle = ccw.currentObstacle = nearestObstacle( aInitialPath );
 
     if( m_forceWinding )
     {
-        s_cw = m_forceCw ? IN_PROGRESS : STUCK;
-        s_ccw = m_forceCw ? STUCK : IN_PROGRESS;
+        cw.status = m_forceCw ? IN_PROGRESS : STUCK;
+        ccw.status = m_forceCw ? STUCK : IN_PROGRESS;
         m_forceSingleDirection = true;
     } else {
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+    THREAD_POOL&     pool = THREAD_POOL::Instance();
+    DEBUG_DECORATOR* ifaceDbg = Router()->GetInterface()->GetDebugDecorator();
 
-        auto old = path_cw.CLine();
+    // The directions only read the world, so they can be walked at the same time unless the
+    // debug graphics of each step are being recorded
+    bool parallel = cw.status == IN_PROGRESS && ccw.status == IN_PROGRESS
+                    && pool.GetThreadCount() > 1 && !pool.IsWorkerThread()
+                    && !( ifaceDbg && ifaceDbg->IsRecording() )
+                    && !( Dbg() && Dbg()->IsRecording() );
 
-        if( clipToLoopStart( path_cw.Line() ) )
-            s_cw = ALMOST_DONE;
-
-        if( clipToLoopStart( path_ccw.Line() ) )
-            s_ccw = ALMOST_DONE;
+    if( parallel )
+    {
+        // Both directions have the whole budget, as they are walked at the same time
+        int budget = m_timeLimit.Get();
 
+        std::future<void> ccwDone = pool.Submit( [this, &ccw, budget]() { walk( ccw, budget ); } );
 
-        if( s_cw != IN_PROGRESS )
+        try
         {
-            result.lineCw = path_cw;
-            result.statusCw = s_cw;
+            walk( cw, budget );
         }
-
-        if( s_ccw != IN_PROGRESS )
+        catch( ... )
         {
-            result.lineCcw = path_ccw;
-            result.statusCcw = s_ccw;
+            // The task still refers to ccw, which lives on this stack
+            ccwDone.wait();
+            throw;
         }
 
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
-
-        m_iteration++;
+        ccwDone.get();
     }
-
-    if( s_cw == IN_PROGRESS )
+    else
     {
-        result.lineCw = path_cw;
-        result.statusCw = ALMOST_DONE;
+        // One after the other, the first direction gets half of the budget so that the second
+        // one isn't left without time, and the second one gets what is left
+        walk( cw, m_timeLimit.Get() / 2 );
+        walk( ccw, m_timeLimit.Get() );
     }
 
-    if( s_ccw == IN_PROGRESS )
-    {
-        result.lineCcw = path_ccw;
-        result.statusCcw = ALMOST_DONE;
-    }
+    result.lineCw = cw.path;
+    result.statusCw = cw.status;
+    result.lineCcw = ccw.path;
+    result.statusCcw = ccw.status;
 
     result.lineCw.Line().Simplify();
     result.lineCcw.Line().Simplify();
@@ -286,9 +307,17 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
-    LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
-    WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
+    // This variant stops as soon as either direction is done, so the directions are stepped
+    // in turn rather than walked in parallel
+    SCOPED_PHASE_TIMER timer( &Router()->PhaseProfile(), PHASE::WALKAROUND );
+
+    WALK_STATE cw( aInitialPath, true ), ccw( aInitialPath, false );
+    LINE& path_cw = cw.path;
+    LINE& path_ccw = ccw.path;
+    WALKAROUND_STATUS& s_cw = cw.status;
+    WALKAROUND_STATUS& s_ccw = ccw.status;
     SHAPE_LINE_CHAIN best_path;
+    bool outOfBudget = false;
 
     // special case for via-in-the-middle-of-track placement
     if( aInitialPath.PointCount() <= 1 )
@@ -302,8 +331,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
 
     start( aInitialPath );
 
-    m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    cw.currentObstacle = ccw.currentObstacle = nearestObstacle( aInitialPath );
 
     aWalkPath = aInitialPath;
 
@@ -318,11 +346,18 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
 
     while( m_iteration < m_iterationLimit )
     {
+        if( m_timeLimit.Expired() )
+        {
+            Router()->PhaseProfile().AddExpired( PHASE::WALKAROUND );
+            outOfBudget = true;
+            break;
+        }
+
         if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+            s_cw = singleStep( cw, m_iteration );
 
         if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+            s_ccw = singleStep( ccw, m_iteration );
 
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
@@ -350,7 +385,7 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         m_iteration++;
     }
 
-    if( m_iteration == m_iterationLimit )
+    if( m_iteration == m_iterationLimit || outOfBudget )
     {
         int len_cw  = path_cw.CLine().Length();
         int len_ccw = path_ccw.CLine().Length();
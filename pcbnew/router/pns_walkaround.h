@@ -29,6 +29,7 @@
 #include "pns_router.h"
 #include "pns_logger.h"
 #include "pns_algo_base.h"
+#include "time_limit.h"
 
 namespace PNS {
 
@@ -49,8 +50,6 @@ public:
         m_itemMask = ITEM::ANY_T;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
-        m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
         m_forceUniqueWindingDirection = false;
@@ -137,19 +136,47 @@ public:
     WALKAROUND_STATUS Route( const LINE& aInitialPath, LINE& aWalkPath,
             bool aOptimize = true );
 
+    /**
+     * Walk around the obstacles in both directions.
+     *
+     * The two directions don't depend on each other, so they are searched at the same time on
+     * the THREAD_POOL when there is more than one worker.
+     */
     const RESULT Route( const LINE& aInitialPath );
 
 private:
+    ///< The progress of the walk in one winding direction
+    struct WALK_STATE
+    {
+        WALK_STATE( const LINE& aPath, bool aCw ) :
+                path( aPath ),
+                cw( aCw ),
+                status( IN_PROGRESS ),
+                recursiveBlockageCount( 0 )
+        {}
+
+        LINE               path;
+        bool               cw;
+        WALKAROUND_STATUS  status;
+        NODE::OPT_OBSTACLE currentObstacle;
+        int                recursiveBlockageCount;
+    };
+
     void start( const LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+    WALKAROUND_STATUS singleStep( WALK_STATE& aState, int aIteration );
+
+    ///< Step in one direction until it is done, stuck or out of iterations, or until
+    ///< \a aMilliseconds or the budget of the whole walkaround are used up
+    void walk( WALK_STATE& aState, int aMilliseconds );
+
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
 
-    int m_recursiveBlockageCount;
     int m_iteration;
     int m_iterationLimit;
+    TIME_LIMIT m_timeLimit;
     int m_itemMask;
     bool m_forceSingleDirection, m_forceLongerPath;
     bool m_cursorApproachMode;
@@ -157,8 +184,6 @@ private:
     bool m_forceCw;
     bool m_forceUniqueWindingDirection;
     VECTOR2I m_cursorPos;
-    NODE::OPT_OBSTACLE m_currentObstacle[2];
-    bool m_recursiveCollision[2];
     std::set<ITEM*> m_restrictedSet;
 };
 
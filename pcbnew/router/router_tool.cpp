@@ -46,6 +46,7 @@ using namespace std::placeholders;
 #include <tools/pcb_grid_helper.h>
 
 #include "router_tool.h"
+#include "pns_batch_router.h"
 #include "pns_segment.h"
 #include "pns_router.h"
 #include "pns_itemset.h"
@@ -526,6 +527,9 @@ void ROUTER_TOOL::saveRouterDebugLog()
                    (const char*) id.c_str() );
     }
 
+    // Where the time of the session went, ignored when replaying
+    fputs( logger->GetPhaseTimes().c_str(), f );
+
     fclose( f );
 
     // Export as *.kicad_pcb format, using a strategy which is specifically chosen
@@ -1812,6 +1816,76 @@ int ROUTER_TOOL::InlineBreakTrack( const TOOL_EVENT& aEvent )
 }
 
 
+int ROUTER_TOOL::RouteSelectedNets( const TOOL_EVENT& aEvent )
+{
+    const SELECTION& selection = m_toolMgr->GetTool<PCB_SELECTION_TOOL>()->GetSelection();
+    std::set<int>    nets;
+
+    for( EDA_ITEM* item : selection )
+    {
+        if( item->Type() == PCB_FOOTPRINT_T )
+        {
+            for( PAD* pad : static_cast<FOOTPRINT*>( item )->Pads() )
+                nets.insert( pad->GetNetCode() );
+        }
+        else if( static_cast<BOARD_ITEM*>( item )->IsConnected() )
+        {
+            nets.insert( static_cast<BOARD_CONNECTED_ITEM*>( item )->GetNetCode() );
+        }
+    }
+
+    nets.erase( NETINFO_LIST::UNCONNECTED );
+
+    if( nets.empty() || m_router->RoutingInProgress() )
+        return 0;
+
+    int count = 0;
+    int routed = RouteNets( nets, frame()->GetActiveLayer(), &count );
+
+    if( count == 0 )
+        frame()->ShowInfoBarMsg( _( "Nothing to route on a single layer." ) );
+    else
+        frame()->ShowInfoBarMsg( wxString::Format( _( "Routed %d of %d connections." ),
+                                                   routed, count ) );
+
+    return 0;
+}
+
+
+int ROUTER_TOOL::RouteNets( const std::set<int>& aNets, int aLayer, int* aConnections )
+{
+    if( aConnections )
+        *aConnections = 0;
+
+    if( m_router->RoutingInProgress() )
+        return 0;
+
+    m_router->SyncWorld();
+
+    PNS::BATCH_ROUTER batch( m_router );
+    int               count = m_iface->ImportRatsnest( batch, aNets, aLayer );
+
+    if( aConnections )
+        *aConnections = count;
+
+    if( count == 0 )
+        return 0;
+
+    frame()->UndoRedoBlock( true );
+
+    int routed = batch.Route();
+
+    if( routed > 0 )
+        m_router->CommitRouting( batch.CurrentNode() );
+    else
+        m_router->GetWorld()->KillChildren();
+
+    frame()->UndoRedoBlock( false );
+
+    return routed;
+}
+
+
 int ROUTER_TOOL::CustomTrackWidthDialog( const TOOL_EVENT& aEvent )
 {
     BOARD_DESIGN_SETTINGS& bds = board()->GetDesignSettings();
@@ -1859,6 +1933,7 @@ void ROUTER_TOOL::setTransitions()
     Go( &ROUTER_TOOL::ChangeRouterMode,       PCB_ACTIONS::routerWalkaroundMode.MakeEvent() );
     Go( &ROUTER_TOOL::InlineDrag,             PCB_ACTIONS::routerInlineDrag.MakeEvent() );
     Go( &ROUTER_TOOL::InlineBreakTrack,       PCB_ACTIONS::inlineBreakTrack.MakeEvent() );
+    Go( &ROUTER_TOOL::RouteSelectedNets,      PCB_ACTIONS::routeSelectedNets.MakeEvent() );
 
     Go( &ROUTER_TOOL::onViaCommand,           ACT_PlaceThroughVia.MakeEvent() );
     Go( &ROUTER_TOOL::onViaCommand,           ACT_PlaceBlindVia.MakeEvent() );
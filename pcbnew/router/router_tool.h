@@ -23,6 +23,8 @@
 #ifndef __ROUTER_TOOL_H
 #define __ROUTER_TOOL_H
 
+#include <set>
+
 #include "pns_tool_base.h"
 
 class APIEXPORT ROUTER_TOOL : public PNS::TOOL_BASE
@@ -37,6 +39,18 @@ public:
     int MainLoop( const TOOL_EVENT& aEvent );
 
     int InlineBreakTrack( const TOOL_EVENT& aEvent );
+
+    ///< Route the ratsnest of the nets of the selected items, without user interaction.
+    int RouteSelectedNets( const TOOL_EVENT& aEvent );
+
+    /**
+     * Route the ratsnest of \a aNets with the editor's router, as a single undo step.
+     *
+     * @param aConnections is set to the number of ratsnest lines routable on a single layer.
+     * @return the number of ratsnest lines routed.
+     */
+    int RouteNets( const std::set<int>& aNets, int aLayer, int* aConnections = nullptr );
+
     bool CanInlineDrag( int aDragMode );
     int InlineDrag( const TOOL_EVENT& aEvent );
 
@@ -19,14 +19,75 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <wx/timer.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include <geometry/seg.h>
+#include <geometry/shape_line_chain.h>
 
 #include "time_limit.h"
 
 namespace PNS {
 
+///< Best time of the calibration loop in measureSpeedFactor() on the reference machine, one core
+///< of an x86-64 Xeon server running a Release build (median of repeated measurements).
+static const double ReferenceCalibrationUs = 1200.0;
+
+///< Number of probes of the calibration loop hitting the chain, whatever the machine.
+static const int CalibrationHits = 496;
+
+static std::atomic<double> s_speedFactor( 1.0 );
+
+
+/**
+ * Time a fixed amount of the kind of geometry the router spends its time on (segment-to-chain
+ * collisions), and compare it with the reference machine.
+ */
+static double measureSpeedFactor()
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int i = 0; i < 100; i++ )
+        chain.Append( i * 1000, ( i % 2 ) * 1000 );
+
+    double bestUs = 0.0;
+
+    // The best of a few runs, to filter out the scheduler
+    for( int run = 0; run < 5; run++ )
+    {
+        auto start = std::chrono::steady_clock::now();
+        int  hits = 0;
+
+        for( int i = 0; i < 500; i++ )
+        {
+            SEG probe( VECTOR2I( i * 200, -500 ), VECTOR2I( i * 200 + 50, 1500 ) );
+
+            if( chain.Collide( probe, 100 ) )
+                hits++;
+        }
+
+        double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start ).count();
+
+        // The result is used, so the loop can't be optimized away.  A different one means the
+        // geometry code changed and the reference time doesn't apply anymore.
+        if( hits != CalibrationHits )
+            return 1.0;
+
+        if( run == 0 || us < bestUs )
+            bestUs = us;
+    }
+
+    // A busy or throttled machine shouldn't make the router wait forever, nor a fast one
+    // starve it
+    return std::min( 4.0, std::max( 0.25, bestUs / ReferenceCalibrationUs ) );
+}
+
+
 TIME_LIMIT::TIME_LIMIT( int aMilliseconds ) :
-    m_limitMs( aMilliseconds )
+    m_limitMs( aMilliseconds ),
+    m_parent( nullptr )
 {
     Restart();
 }
@@ -38,13 +99,18 @@ TIME_LIMIT::~TIME_LIMIT()
 
 bool TIME_LIMIT::Expired() const
 {
-    return ( wxGetLocalTimeMillis().GetValue() - m_startTics ) >= m_limitMs;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+
+    if( elapsed.count() >= m_limitMs * SpeedFactor() )
+        return true;
+
+    return m_parent && m_parent->Expired();
 }
 
 
 void TIME_LIMIT::Restart()
 {
-    m_startTics = wxGetLocalTimeMillis().GetValue();
+    m_start = std::chrono::steady_clock::now();
 }
 
 
@@ -53,4 +119,29 @@ void TIME_LIMIT::Set( int aMilliseconds )
     m_limitMs = aMilliseconds;
 }
 
+
+int TIME_LIMIT::Elapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_start ).count();
+}
+
+
+void TIME_LIMIT::Calibrate()
+{
+    static std::once_flag calibrated;
+
+    std::call_once( calibrated,
+                    []()
+                    {
+                        s_speedFactor = measureSpeedFactor();
+                    } );
+}
+
+
+double TIME_LIMIT::SpeedFactor()
+{
+    return s_speedFactor.load( std::memory_order_relaxed );
+}
+
 }
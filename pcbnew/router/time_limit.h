@@ -22,25 +22,51 @@
 #ifndef __TIME_LIMIT_H
 #define __TIME_LIMIT_H
 
-#include <cstdint>
+#include <chrono>
 
 namespace PNS {
 
+/**
+ * TIME_LIMIT
+ *
+ * A time budget, in milliseconds of a reference machine: the limit is scaled by SpeedFactor()
+ * when checked, so that the router gets the same amount of work done on a slow laptop and on
+ * a fast workstation.  A budget can be made a part of another one, e.g. the budget of a shove
+ * is a part of the budget of the whole router operation, and expires at the latest with it.
+ */
 class TIME_LIMIT
 {
 public:
     TIME_LIMIT( int aMilliseconds = 0 );
     ~TIME_LIMIT();
 
+    ///< Return true once this budget, or the one it is a part of, is used up.
     bool Expired() const;
     void Restart();
 
     void Set( int aMilliseconds );
     int Get() const { return m_limitMs; }
 
+    ///< Make this budget a part of \a aParent, which may be null.
+    void SetParent( const TIME_LIMIT* aParent ) { m_parent = aParent; }
+
+    ///< Return the milliseconds elapsed since the last Restart().
+    int Elapsed() const;
+
+    /**
+     * Measure how much slower this machine runs the router's geometry code than the reference
+     * machine, once per process.  Called when a router is created, so that the measurement
+     * isn't charged to a routing budget.  Until then limits are not scaled.
+     */
+    static void Calibrate();
+
+    ///< Return the factor limits are scaled by, 1.0 until Calibrate() is called.
+    static double SpeedFactor();
+
 private:
-    int m_limitMs;
-    int64_t m_startTics;
+    int                                   m_limitMs;
+    std::chrono::steady_clock::time_point m_start;
+    const TIME_LIMIT*                     m_parent;
 };
 
 }
@@ -44,6 +44,12 @@
 #include <project.h>
 #include <settings/settings_manager.h>
 #include <project/project_local_settings.h>
+#include <router/pns_batch_router.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/router_tool.h>
+#include <tool/tool_manager.h>
 #include <wildcards_and_files_ext.h>
 
 static PCB_EDIT_FRAME* s_PcbEditFrame = NULL;
@@ -453,3 +459,98 @@ bool WriteDRCReport( BOARD* aBoard, const wxString& aFileName, EDA_UNITS aUnits,
 
     return true;
 }
+
+
+/**
+ * Router interface adding the routed tracks straight to the board, without a commit.
+ */
+class SCRIPTING_ROUTER_IFACE : public PNS_KICAD_IFACE_BASE
+{
+public:
+    void AddItem( PNS::ITEM* aItem ) override
+    {
+        BOARD_CONNECTED_ITEM* newBI = createBoardItem( aItem );
+
+        if( newBI )
+        {
+            aItem->SetParent( newBI );
+            m_board->Add( newBI );
+        }
+    }
+};
+
+
+int RouteNets( BOARD* aBoard, const std::vector<int>& aNetCodes, int aLayer )
+{
+    wxCHECK( aBoard, 0 );
+
+    // The router takes its clearances from the DRC engine
+    BOARD_DESIGN_SETTINGS& bds = aBoard->GetDesignSettings();
+
+    if( !bds.m_DRCEngine )
+    {
+        wxFileName fn = aBoard->GetFileName();
+        fn.SetExt( DesignRulesFileExtension );
+
+        wxString drcRulesPath;
+
+        if( s_SettingsManager )
+            drcRulesPath = s_SettingsManager->Prj().AbsolutePath( fn.GetFullName() );
+
+        bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( aBoard, &bds );
+
+        try
+        {
+            bds.m_DRCEngine->InitEngine( drcRulesPath );
+        }
+        catch( PARSE_ERROR& )
+        {
+            return 0;
+        }
+    }
+
+    std::set<int> nets( aNetCodes.begin(), aNetCodes.end() );
+
+    // The editor's router owns ROUTER::GetInstance(); route its board through it
+    if( s_PcbEditFrame && s_PcbEditFrame->GetBoard() == aBoard )
+    {
+        ROUTER_TOOL* routerTool = s_PcbEditFrame->GetToolManager()->GetTool<ROUTER_TOOL>();
+
+        wxCHECK( routerTool, 0 );
+        return routerTool->RouteNets( nets, aLayer );
+    }
+
+    // A second router would take the router instance from the one alive
+    if( PNS::ROUTER::GetInstance() )
+    {
+        wxLogError( "RouteNets(): the router is in use by another board." );
+        return 0;
+    }
+
+    aBoard->BuildConnectivity();
+
+    SCRIPTING_ROUTER_IFACE iface;
+    PNS::ROUTING_SETTINGS  settings( nullptr, "" );
+    PNS::ROUTER            router;
+
+    iface.SetBoard( aBoard );
+    router.SetInterface( &iface );
+    router.ClearWorld();
+    router.SyncWorld();
+    router.LoadSettings( &settings );
+
+    PNS::BATCH_ROUTER batch( &router );
+
+    if( iface.ImportRatsnest( batch, nets, aLayer ) == 0 )
+        return 0;
+
+    int routed = batch.Route();
+
+    if( routed > 0 )
+    {
+        router.CommitRouting( batch.CurrentNode() );
+        aBoard->BuildConnectivity();
+    }
+
+    return routed;
+}
@@ -160,4 +160,18 @@ bool IsActionRunning();
 bool WriteDRCReport( BOARD* aBoard, const wxString& aFileName, EDA_UNITS aUnits,
                      bool aReportAllTrackErrors );
 
+/**
+ * Routes the unconnected ratsnest lines of the given nets with the interactive router's
+ * walkaround engine and adds the tracks to the board.  Independent connections are routed in
+ * parallel.  No vias are placed, so ratsnest lines whose ends share no copper layer are left
+ * unrouted.  A board open in the editor is routed by the editor's router, as a single undo
+ * step; no other board can be routed while the editor's router exists.
+ *
+ * @param aBoard is a valid loaded board
+ * @param aNetCodes is the list of nets to route
+ * @param aLayer is the layer to route on when both ends of a ratsnest line are on it
+ * @return the number of ratsnest lines routed
+ */
+int RouteNets( BOARD* aBoard, const std::vector<int>& aNetCodes, int aLayer = F_Cu );
+
 #endif      // __PCBNEW_SCRIPTING_HELPERS_H
@@ -1345,6 +1345,12 @@ TOOL_ACTION PCB_ACTIONS::breakTrack( "pcbnew.InteractiveRouter.BreakTrack",
         _( "Splits the track segment into two segments connected at the cursor position." ),
         BITMAPS::break_line );
 
+TOOL_ACTION PCB_ACTIONS::routeSelectedNets( "pcbnew.InteractiveRouter.RouteSelectedNets",
+        AS_GLOBAL, 0, "",
+        _( "Route Selected Nets" ),
+        _( "Routes the unconnected ratsnest lines of the selected items' nets, on a single layer" ),
+        BITMAPS::add_tracks );
+
 TOOL_ACTION PCB_ACTIONS::drag45Degree( "pcbnew.InteractiveRouter.Drag45Degree",
         AS_GLOBAL,
         'D', LEGACY_HK_NAME( "Drag Track Keep Slope" ),
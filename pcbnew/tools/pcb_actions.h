@@ -138,6 +138,9 @@ public:
     /// Breaks track when router is not activated
     static TOOL_ACTION inlineBreakTrack;
 
+    /// Route the ratsnest of the selected nets without user interaction
+    static TOOL_ACTION routeSelectedNets;
+
     static TOOL_ACTION drag45Degree;
     static TOOL_ACTION dragFreeAngle;
 
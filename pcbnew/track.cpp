@@ -556,6 +556,16 @@ double TRACK::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+double TRACK::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Round ends can't be seen on tracks a couple of pixels wide
+    if( IsCopperLayer( aLayer ) )
+        return (double) Millimeter2iu( 0.5 ) / ( m_Width + 1 );
+
+    return 0.0;
+}
+
+
 const BOX2I TRACK::ViewBBox() const
 {
     BOX2I bbox = GetBoundingBox();
@@ -639,6 +649,20 @@ double VIA::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+double VIA::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    if( m_Width == 0 )
+        return 0.0;
+
+    // Vias a few pixels wide are drawn as plain disks: the hole and the quarters of the annulus
+    // showing the layer pair of blind/buried and micro-vias can't be seen anyway
+    if( IsHoleLayer( aLayer ) || aLayer == LAYER_VIA_BBLIND || aLayer == LAYER_VIA_MICROVIA )
+        return (double) Millimeter2iu( 1 ) / m_Width;
+
+    return 0.0;
+}
+
+
 // see class_track.h
 void TRACK::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANEL_ITEM>& aList )
 {
@@ -219,6 +219,8 @@ public:
 
     double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    double ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
     const BOX2I ViewBBox() const override;
 
     virtual void SwapData( BOARD_ITEM* aImage ) override;
@@ -431,6 +433,8 @@ public:
 
     double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    double ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
     void Flip( const wxPoint& aCentre, bool aFlipLeftRight ) override;
 
 #if defined (DEBUG)
@@ -142,18 +142,16 @@ bool TRACKS_CLEANER::testTrackEndpointIsNode( TRACK* aTrack, bool aTstStart )
     if( !citem->Valid() )
         return false;
 
-    auto anchors = citem->Anchors();
-
     VECTOR2I refpoint = aTstStart ? aTrack->GetStart() : aTrack->GetEnd();
 
-    for( const auto& anchor : anchors )
+    for( const CN_ANCHOR& anchor : citem->Anchors() )
     {
-        if( anchor->Pos() != refpoint )
+        if( anchor.Pos() != refpoint )
             continue;
 
         // The right anchor point is found: if more than one other item
         // (pad, via, track...) is connected, it is a node:
-        return anchor->ConnectedItemsCount() > 1;
+        return anchor.ConnectedItemsCount() > 1;
     }
 
     return false;
@@ -39,6 +39,16 @@
 #include <trigo.h>
 #include <i18n_utility.h>
 
+
+///< Ratio of the size of a zone to the tolerance its outlines are decimated with, when the zone
+///< is too small on screen to show its details
+static const int COARSE_TOLERANCE_RATIO = 4000;
+
+///< The decimated outlines are drawn once their tolerance is smaller on screen than this length
+///< at scale 1, which is under a pixel
+static const int COARSE_TOLERANCE_ON_SCREEN = Millimeter2iu( 0.25 );
+
+
 ZONE::ZONE( BOARD_ITEM_CONTAINER* aParent, bool aInFP ) :
         BOARD_CONNECTED_ITEM( aParent, aInFP ? PCB_FP_ZONE_T : PCB_ZONE_T ),
         m_area( 0.0 )
@@ -310,6 +320,32 @@ double ZONE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 }
 
 
+double ZONE::ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Below this, filled areas are drawn from decimated outlines, see PCB_PAINTER
+    int tolerance = GetCoarseTolerance( 1 );
+
+    return tolerance > 0 ? (double) COARSE_TOLERANCE_ON_SCREEN / tolerance : 0.0;
+}
+
+
+int ZONE::ViewGetCoarseLevels( int aLayer ) const
+{
+    // The outlines are decimated further at each level
+    return 3;
+}
+
+
+int ZONE::GetCoarseTolerance( int aLevel ) const
+{
+    BOX2I bbox = m_Poly->BBox();
+    int   size = std::max( bbox.GetWidth(), bbox.GetHeight() );
+
+    // Each level is used for scales 4 times smaller than the previous one (see VIEW)
+    return ( size / COARSE_TOLERANCE_RATIO ) << ( 2 * ( aLevel - 1 ) );
+}
+
+
 bool ZONE::IsOnLayer( PCB_LAYER_ID aLayer ) const
 {
     return m_layerSet.test( aLayer );
@@ -177,6 +177,18 @@ public:
 
     double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    double ViewGetCoarseLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
+    int ViewGetCoarseLevels( int aLayer ) const override;
+
+    /**
+     * Return the tolerance the filled areas are decimated with to draw the zone with the coarse
+     * level of detail \a aLevel.  It stays under a pixel at the scales the level is used for.
+     *
+     * @see ViewGetCoarseLOD()
+     */
+    int GetCoarseTolerance( int aLevel ) const;
+
     void SetFillMode( ZONE_FILL_MODE aFillMode ) { m_fillMode = aFillMode; }
     ZONE_FILL_MODE GetFillMode() const { return m_fillMode; }
 
@@ -39,11 +39,13 @@
 #include <board_commit.h>
 #include <widgets/progress_reporter.h>
 #include <geometry/shape_poly_set.h>
+#include <geometry/poly_boolean_pipeline.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
 #include <confirm.h>
 #include <convert_to_biu.h>
 #include <math/util.h>      // for KiROUND
+#include <perf_counters.h>
 #include "zone_filler.h"
 
 static const double s_RoundPadThermalSpokeAngle = 450;      // in deci-degrees
@@ -84,6 +86,9 @@ void ZONE_FILLER::SetProgressReporter( PROGRESS_REPORTER* aReporter )
 
 bool ZONE_FILLER::Fill( std::vector<ZONE*>& aZones, bool aCheck, wxWindow* aParent )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "zone_filler.fill" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     std::vector<std::pair<ZONE*, PCB_LAYER_ID>> toFill;
     std::vector<CN_ZONE_ISOLATED_ISLAND_LIST> islandsList;
 
@@ -941,6 +946,10 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE* aZone, PCB_LAYER_ID aLa
 void ZONE_FILLER::subtractHigherPriorityZones( const ZONE* aZone, PCB_LAYER_ID aLayer,
                                                SHAPE_POLY_SET& aRawFill )
 {
+    // All the knockouts are queued and subtracted in a single pass
+    POLY_BOOLEAN_PIPELINE knockouts( aRawFill, SHAPE_POLY_SET::PM_FAST );
+    bool                  hasKnockouts = false;
+
     auto knockoutZoneOutline =
             [&]( ZONE* aKnockout )
             {
@@ -950,7 +959,8 @@ void ZONE_FILLER::subtractHigherPriorityZones( const ZONE* aZone, PCB_LAYER_ID a
 
                 if( aKnockout->GetCachedBoundingBox().Intersects( aZone->GetCachedBoundingBox() ) )
                 {
-                    aRawFill.BooleanSubtract( *aKnockout->Outline(), SHAPE_POLY_SET::PM_FAST );
+                    knockouts.Subtract( *aKnockout->Outline() );
+                    hasKnockouts = true;
                 }
             };
 
@@ -974,6 +984,9 @@ void ZONE_FILLER::subtractHigherPriorityZones( const ZONE* aZone, PCB_LAYER_ID a
             }
         }
     }
+
+    if( hasKnockouts )
+        knockouts.Commit( aRawFill );
 }
 
 
@@ -1160,9 +1173,23 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE* aZone,
 
     // Ensure additive changes (thermal stubs and particularly inflating acute corners) do not
     // add copper outside the zone boundary or inside the clearance holes
-    aRawPolys.BooleanIntersection( aMaxExtents, SHAPE_POLY_SET::PM_FAST );
-    DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In16_Cu, "after-trim-to-outline" );
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    {
+        POLY_BOOLEAN_PIPELINE trim( aRawPolys, SHAPE_POLY_SET::PM_FAST );
+        trim.Intersect( aMaxExtents );
+
+        // The intermediate result only needs to be converted back when it is dumped.  Committing
+        // empties the pipeline, so the rest of the chain starts again from the dumped polygons.
+        if( m_debugZoneFiller && aDebugLayer == In16_Cu )
+        {
+            trim.Commit( aRawPolys );
+            DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In16_Cu, "after-trim-to-outline" );
+            trim = POLY_BOOLEAN_PIPELINE( aRawPolys, SHAPE_POLY_SET::PM_FAST );
+        }
+
+        trim.Subtract( clearanceHoles );
+        trim.Commit( aRawPolys );
+    }
+
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In17_Cu, "after-trim-to-clearance-holes" );
 
     // Lastly give any same-net but higher-priority zones control over their own area.
@@ -1182,6 +1209,9 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE* aZone,
 bool ZONE_FILLER::fillSingleZone( ZONE* aZone, PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aRawPolys,
                                   SHAPE_POLY_SET& aFinalPolys )
 {
+    static PERF_COUNTER& counter = PERF_COUNTERS::Get( "zone_filler.fill_single_zone" );
+    SCOPED_PERF_TIMER    timer( counter );
+
     SHAPE_POLY_SET* boardOutline = m_brdOutlinesValid ? &m_boardOutline : nullptr;
     SHAPE_POLY_SET  maxExtents;
     SHAPE_POLY_SET  smoothedPoly;
@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PERF_COUNTERS
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <perf_counters.h>
+
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+
+BOOST_AUTO_TEST_SUITE( PerfCounters )
+
+
+/**
+ * The registry hands out the same counter for the same name.
+ */
+BOOST_AUTO_TEST_CASE( Registry )
+{
+    PERF_COUNTER& a = PERF_COUNTERS::Get( "qa.registry.a" );
+    PERF_COUNTER& b = PERF_COUNTERS::Get( "qa.registry.b" );
+
+    BOOST_CHECK_EQUAL( &a, &PERF_COUNTERS::Get( "qa.registry.a" ) );
+    BOOST_CHECK_NE( &a, &b );
+    BOOST_CHECK_EQUAL( a.GetName(), "qa.registry.a" );
+}
+
+
+/**
+ * Samples add up, including from several threads.
+ */
+BOOST_AUTO_TEST_CASE( Samples )
+{
+    PERF_COUNTER& counter = PERF_COUNTERS::Get( "qa.samples" );
+    counter.Reset();
+
+    std::vector<std::thread> threads;
+
+    for( int ii = 0; ii < 4; ii++ )
+    {
+        threads.emplace_back( [&counter]()
+                              {
+                                  for( int jj = 0; jj < 1000; jj++ )
+                                      counter.AddSample( std::chrono::microseconds( 1 ) );
+                              } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    counter.AddSample( std::chrono::milliseconds( 2 ) );
+
+    BOOST_CHECK_EQUAL( counter.GetCount(), 4001 );
+    BOOST_CHECK_CLOSE( counter.GetTotalMs(), 6.0, 1e-6 );
+    BOOST_CHECK_CLOSE( counter.GetMaxMs(), 2.0, 1e-6 );
+
+    {
+        SCOPED_PERF_TIMER timer( counter );
+    }
+
+    BOOST_CHECK_EQUAL( counter.GetCount(), 4002 );
+}
+
+
+/**
+ * The JSON dump lists every counter with its totals.
+ */
+BOOST_AUTO_TEST_CASE( Json )
+{
+    PERF_COUNTER& counter = PERF_COUNTERS::Get( "qa.json" );
+    counter.Reset();
+    counter.Increment( 3 );
+
+    nlohmann::json js = nlohmann::json::parse( PERF_COUNTERS::ToJson() );
+
+    bool found = false;
+
+    for( const nlohmann::json& entry : js.at( "counters" ) )
+    {
+        if( entry.at( "name" ) == "qa.json" )
+        {
+            found = true;
+            BOOST_CHECK_EQUAL( entry.at( "count" ).get<uint64_t>(), 3 );
+            BOOST_CHECK_EQUAL( entry.at( "total_ms" ).get<double>(), 0.0 );
+        }
+    }
+
+    BOOST_CHECK( found );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for THREAD_POOL
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <thread_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Every submitted task runs exactly once, and its result reaches the future.
+ */
+BOOST_AUTO_TEST_CASE( RunsAllTasks )
+{
+    THREAD_POOL pool( 4 );
+
+    BOOST_CHECK_EQUAL( pool.GetThreadCount(), 4 );
+
+    std::atomic<int>              runs( 0 );
+    std::vector<std::future<int>> results;
+
+    for( int ii = 0; ii < 1000; ii++ )
+    {
+        results.push_back( pool.Submit( [ii, &runs]()
+                                        {
+                                            runs++;
+                                            return ii * 2;
+                                        } ) );
+    }
+
+    for( int ii = 0; ii < 1000; ii++ )
+        BOOST_CHECK_EQUAL( results[ii].get(), ii * 2 );
+
+    BOOST_CHECK_EQUAL( runs, 1000 );
+}
+
+
+/**
+ * Exceptions thrown by a task are passed on to whoever waits for it.
+ */
+BOOST_AUTO_TEST_CASE( Exceptions )
+{
+    THREAD_POOL pool( 1 );
+
+    std::future<void> result = pool.Submit( []() { throw std::runtime_error( "task failed" ); } );
+
+    BOOST_CHECK_THROW( result.get(), std::runtime_error );
+
+    // The worker survives the exception
+    BOOST_CHECK_EQUAL( pool.Submit( []() { return 42; } ).get(), 42 );
+}
+
+
+/**
+ * Destroying the pool finishes the tasks already queued.
+ */
+BOOST_AUTO_TEST_CASE( DrainOnDestruction )
+{
+    std::atomic<int> runs( 0 );
+
+    {
+        THREAD_POOL pool( 2 );
+
+        for( int ii = 0; ii < 100; ii++ )
+            pool.Submit( [&runs]() { runs++; } );
+    }
+
+    BOOST_CHECK_EQUAL( runs, 100 );
+}
+
+
+/**
+ * Tasks can tell they run on a worker of the pool, and of which one.
+ */
+BOOST_AUTO_TEST_CASE( WorkerThread )
+{
+    THREAD_POOL pool( 1 );
+    THREAD_POOL other( 1 );
+
+    BOOST_CHECK( !pool.IsWorkerThread() );
+    BOOST_CHECK( pool.Submit( [&pool]() { return pool.IsWorkerThread(); } ).get() );
+    BOOST_CHECK( !other.Submit( [&pool]() { return pool.IsWorkerThread(); } ).get() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
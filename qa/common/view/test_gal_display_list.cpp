@@ -0,0 +1,298 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <bitmap_base.h>
+#include <gal/gal_display_list.h>
+#include <gal/gal_display_options.h>
+
+#include <cmath>
+#include <sstream>
+
+
+// All these tests are of a class in KIGFX
+using namespace KIGFX;
+
+
+/**
+ * A GAL logging the drawing calls made on it, each one with the attributes it is drawn with.
+ */
+class CALL_LOG_GAL : public GAL
+{
+public:
+    CALL_LOG_GAL( GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions )
+    {
+    }
+
+    void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override
+    {
+        std::ostringstream call;
+        call << "line " << aStartPoint << aEndPoint;
+        log( call );
+    }
+
+    void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                      double aWidth ) override
+    {
+        std::ostringstream call;
+        call << "segment " << aStartPoint << aEndPoint << " " << aWidth;
+        log( call );
+    }
+
+    void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override
+    {
+        std::ostringstream call;
+        call << "polyline";
+
+        for( const VECTOR2D& pt : aPointList )
+            call << pt;
+
+        log( call );
+    }
+
+    void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override
+    {
+        std::ostringstream call;
+        call << "circle " << aCenterPoint << " " << aRadius;
+        log( call );
+    }
+
+    void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle, double aWidth ) override
+    {
+        std::ostringstream call;
+        call << "arc " << aCenterPoint << " " << aRadius << " " << aStartAngle << " "
+             << aEndAngle << " " << aWidth;
+        log( call );
+    }
+
+    void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override
+    {
+        std::ostringstream call;
+        call << "polygon";
+
+        for( int i = 0; i < aListSize; i++ )
+            call << aPointList[i];
+
+        log( call );
+    }
+
+    void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override
+    {
+        std::ostringstream call;
+        call << "polygon set " << aPolySet.TotalVertices() << " "
+             << aPolySet.IsTriangulationUpToDate();
+        log( call );
+    }
+
+    void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                     double aRotationAngle ) override
+    {
+        std::ostringstream call;
+        call << "text " << aText.ToStdString() << aPosition << " " << aRotationAngle
+             << GetGlyphSize() << IsFontBold() << IsTextMirrored();
+        log( call );
+    }
+
+    void Translate( const VECTOR2D& aTranslation ) override
+    {
+        std::ostringstream call;
+        call << "translate " << aTranslation;
+        m_calls.push_back( call.str() );
+    }
+
+    void Save() override
+    {
+        m_calls.push_back( "save" );
+    }
+
+    void Restore() override
+    {
+        m_calls.push_back( "restore" );
+    }
+
+    std::vector<std::string> m_calls;
+
+private:
+    void log( const std::ostringstream& aCall )
+    {
+        std::ostringstream state;
+
+        state << " fill " << m_isFillEnabled << m_fillColor << " stroke " << m_isStrokeEnabled
+              << m_strokeColor << " width " << m_lineWidth << " depth " << m_layerDepth;
+
+        m_calls.push_back( aCall.str() + state.str() );
+    }
+};
+
+
+/**
+ * Draws a bit of everything, changing the attributes between the primitives.
+ */
+static void drawSample( GAL& aGal, int aVariant )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.NewOutline();
+    poly.Append( 0, 0 );
+    poly.Append( 100, 0 );
+    poly.Append( 100, 100 );
+    poly.CacheTriangulation();
+
+    // The whole state is set, as recording goes on from the state the last drawing left
+    aGal.SetIsFill( false );
+    aGal.SetIsStroke( true );
+    aGal.SetFillColor( COLOR4D( 0.0, 0.0, 1.0, 1.0 ) );
+    aGal.SetStrokeColor( COLOR4D( 1.0, 0.0, 0.0, 1.0 ) );
+    aGal.SetLineWidth( 10 + aVariant );
+    aGal.SetLayerDepth( -aVariant );
+    aGal.DrawLine( VECTOR2D( 0, 0 ), VECTOR2D( 10, aVariant ) );
+    aGal.DrawSegment( VECTOR2D( 5, 5 ), VECTOR2D( 50, 50 ), 3.5 );
+
+    aGal.Save();
+    aGal.Translate( VECTOR2D( aVariant, 7 ) );
+
+    aGal.SetIsFill( true );
+    aGal.SetFillColor( COLOR4D( 0.0, 0.5, 0.0, 0.25 ) );
+    aGal.DrawCircle( VECTOR2D( 1, 2 ), 30 );
+    aGal.DrawPolygon( poly );
+
+    VECTOR2D triangle[] = { { 0, 0 }, { 10, 0 }, { 0, 10 } };
+    aGal.DrawPolygon( triangle, 3 );
+
+    aGal.Restore();
+
+    aGal.SetIsFill( false );
+    aGal.SetLineWidth( 2 );
+    aGal.DrawPolyline( std::deque<VECTOR2D>( { { 0, 0 }, { 1, 1 }, { 2, 0 } } ) );
+    aGal.DrawArcSegment( VECTOR2D( 0, 0 ), 20, 0, M_PI, 4 );
+
+    aGal.SetGlyphSize( VECTOR2D( 8, 9 ) );
+    aGal.SetFontBold( true );
+    aGal.BitmapText( wxT( "U1" ), VECTOR2D( 40, 40 ), 0.5 );
+}
+
+
+struct GAL_DISPLAY_LIST_FIXTURE
+{
+    GAL_DISPLAY_LIST_FIXTURE() :
+            m_target( m_options )
+    {
+    }
+
+    GAL_DISPLAY_OPTIONS m_options;
+    CALL_LOG_GAL        m_target;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GalDisplayList, GAL_DISPLAY_LIST_FIXTURE )
+
+
+/**
+ * A replayed drawing makes the same calls, in the same order and with the same attributes,
+ * as drawing directly on the target.
+ */
+BOOST_AUTO_TEST_CASE( ReplayMatchesDirectDrawing )
+{
+    CALL_LOG_GAL direct( m_options );
+    drawSample( direct, 1 );
+
+    GAL_DISPLAY_LIST list( m_options, &m_target );
+
+    int drawing = list.BeginRecording();
+    drawSample( list, 1 );
+    list.EndRecording();
+
+    BOOST_CHECK( list.IsComplete( drawing ) );
+
+    list.Replay( drawing, &m_target );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( m_target.m_calls.begin(), m_target.m_calls.end(),
+                                   direct.m_calls.begin(), direct.m_calls.end() );
+}
+
+
+/**
+ * Drawings replay on their own, in any order, whatever the target was left with.
+ */
+BOOST_AUTO_TEST_CASE( DrawingsAreIndependent )
+{
+    CALL_LOG_GAL first( m_options );
+    CALL_LOG_GAL second( m_options );
+
+    drawSample( first, 1 );
+    drawSample( second, 2 );
+
+    GAL_DISPLAY_LIST list( m_options, &m_target );
+
+    list.BeginRecording();
+    drawSample( list, 1 );
+    list.EndRecording();
+
+    list.BeginRecording();
+    drawSample( list, 2 );
+    list.EndRecording();
+
+    BOOST_CHECK_EQUAL( list.GetDrawingCount(), 2 );
+
+    list.Replay( 1, &m_target );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( m_target.m_calls.begin(), m_target.m_calls.end(),
+                                   second.m_calls.begin(), second.m_calls.end() );
+
+    m_target.m_calls.clear();
+    list.Replay( 0, &m_target );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( m_target.m_calls.begin(), m_target.m_calls.end(),
+                                   first.m_calls.begin(), first.m_calls.end() );
+}
+
+
+/**
+ * Bitmaps can't be recorded, the drawings using them have to be drawn again directly.
+ */
+BOOST_AUTO_TEST_CASE( BitmapsMakeDrawingsIncomplete )
+{
+    GAL_DISPLAY_LIST list( m_options, &m_target );
+
+    int plain = list.BeginRecording();
+    list.DrawCircle( VECTOR2D( 0, 0 ), 1 );
+    list.EndRecording();
+
+    int bitmap = list.BeginRecording();
+    list.DrawCircle( VECTOR2D( 0, 0 ), 1 );
+    list.DrawBitmap( BITMAP_BASE() );
+    list.EndRecording();
+
+    BOOST_CHECK( list.IsComplete( plain ) );
+    BOOST_CHECK( !list.IsComplete( bitmap ) );
+
+    list.Clear();
+
+    BOOST_CHECK_EQUAL( list.GetDrawingCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
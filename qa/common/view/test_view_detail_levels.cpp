@@ -0,0 +1,376 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <eda_item.h>
+#include <gal/gal_display_options.h>
+#include <gal/graphics_abstraction_layer.h>
+#include <painter.h>
+#include <view/view.h>
+
+#include <algorithm>
+#include <map>
+
+
+// All these tests are of a class in KIGFX
+using namespace KIGFX;
+
+
+/**
+ * A GAL logging the operations made on its cached groups.
+ */
+class GROUP_LOG_GAL : public GAL
+{
+public:
+    GROUP_LOG_GAL( GAL_DISPLAY_OPTIONS& aOptions ) :
+            GAL( aOptions ),
+            m_lastGroup( 0 )
+    {
+    }
+
+    int BeginGroup() override
+    {
+        m_calls.push_back( "begin " + std::to_string( ++m_lastGroup ) );
+        return m_lastGroup;
+    }
+
+    void DrawGroup( int aGroupNumber ) override
+    {
+        m_calls.push_back( "draw " + std::to_string( aGroupNumber ) );
+    }
+
+    void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override
+    {
+        m_calls.push_back( "color " + std::to_string( aGroupNumber ) );
+    }
+
+    void DeleteGroup( int aGroupNumber ) override
+    {
+        m_calls.push_back( "delete " + std::to_string( aGroupNumber ) );
+    }
+
+    bool Called( const std::string& aCall ) const
+    {
+        return std::count( m_calls.begin(), m_calls.end(), aCall ) > 0;
+    }
+
+    int                      m_lastGroup;
+    std::vector<std::string> m_calls;
+};
+
+
+/**
+ * An item with coarse geometry below a fixed scale.
+ */
+class COARSE_ITEM : public EDA_ITEM
+{
+public:
+    COARSE_ITEM( int aLayer, double aCoarseLOD, int aCoarseLevels ) :
+            EDA_ITEM( NOT_USED ),
+            m_layer( aLayer ),
+            m_coarseLOD( aCoarseLOD ),
+            m_coarseLevels( aCoarseLevels )
+    {
+    }
+
+    wxString GetClass() const override
+    {
+        return wxT( "CoarseItem" );
+    }
+
+#ifdef DEBUG
+    void Show( int nestLevel, std::ostream& os ) const override {}
+#endif
+
+    const BOX2I ViewBBox() const override
+    {
+        return BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( 1000, 1000 ) );
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = m_layer;
+        aCount = 1;
+    }
+
+    double ViewGetCoarseLOD( int aLayer, VIEW* aView ) const override
+    {
+        return m_coarseLOD;
+    }
+
+    int ViewGetCoarseLevels( int aLayer ) const override
+    {
+        return m_coarseLevels;
+    }
+
+    int    m_layer;
+    double m_coarseLOD;
+    int    m_coarseLevels;
+};
+
+
+class TEST_RENDER_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    COLOR4D GetColor( const VIEW_ITEM* aItem, int aLayer ) const override
+    {
+        return COLOR4D::WHITE;
+    }
+
+    const COLOR4D& GetBackgroundColor() override { return m_background; }
+    void SetBackgroundColor( const COLOR4D& aColor ) override { m_background = aColor; }
+    const COLOR4D& GetGridColor() override { return m_background; }
+    const COLOR4D& GetCursorColor() override { return m_background; }
+
+    COLOR4D m_background;
+};
+
+
+/**
+ * A painter recording the group each detail level of the test items is painted in.
+ */
+class LEVEL_LOG_PAINTER : public PAINTER
+{
+public:
+    LEVEL_LOG_PAINTER( GROUP_LOG_GAL* aGal ) :
+            PAINTER( aGal ),
+            m_logGal( aGal )
+    {
+    }
+
+    RENDER_SETTINGS* GetSettings() override { return &m_settings; }
+
+    bool Draw( const VIEW_ITEM* aItem, int aLayer ) override
+    {
+        if( !dynamic_cast<const COARSE_ITEM*>( aItem ) )
+            return false;
+
+        m_painted[m_settings.GetDetailLevel()] = m_logGal->m_lastGroup;
+        return true;
+    }
+
+    GROUP_LOG_GAL*       m_logGal;
+    TEST_RENDER_SETTINGS m_settings;
+
+    ///< Group of the last painting of each level
+    std::map<int, int>   m_painted;
+};
+
+
+/**
+ * Expose the detail level computation for the tests.
+ */
+class DETAIL_LEVEL_VIEW : public VIEW
+{
+public:
+    using VIEW::getDetailLevel;
+};
+
+
+struct VIEW_DETAIL_LEVEL_FIXTURE
+{
+    VIEW_DETAIL_LEVEL_FIXTURE() :
+            m_gal( m_options ),
+            m_painter( &m_gal )
+    {
+        m_view.SetGAL( &m_gal );
+        m_view.SetPainter( &m_painter );
+
+        // Cache the preview group of the view, so the tests only see the groups of their items
+        m_view.UpdateItems();
+        m_gal.m_calls.clear();
+    }
+
+    ///< Add \a aItem to the view and cache it at the current scale
+    void addAndCache( COARSE_ITEM& aItem )
+    {
+        m_view.Add( &aItem );
+        m_view.UpdateItems();
+    }
+
+    GAL_DISPLAY_OPTIONS m_options;
+    GROUP_LOG_GAL       m_gal;
+    LEVEL_LOG_PAINTER   m_painter;
+    DETAIL_LEVEL_VIEW   m_view;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ViewDetailLevels, VIEW_DETAIL_LEVEL_FIXTURE )
+
+
+/**
+ * Items are drawn with their full geometry above their coarse LOD, and one level coarser each
+ * time the scale is divided by 4.
+ */
+BOOST_AUTO_TEST_CASE( LevelsFollowScale )
+{
+    COARSE_ITEM item( 5, 1000.0, VIEW::VIEW_MAX_DETAIL_LEVELS );
+
+    const std::vector<std::pair<double, int>> cases = {
+        { 2000.0, 0 },
+        { 1000.0, 0 },
+        { 999.0, 1 },
+        { 250.0, 1 },
+        { 249.0, 2 },
+        { 62.5, 2 },
+        { 62.0, 3 },
+    };
+
+    for( const std::pair<double, int>& c : cases )
+    {
+        BOOST_TEST_CONTEXT( "Scale " << c.first )
+        {
+            m_view.SetScale( c.first );
+            BOOST_CHECK_EQUAL( m_view.getDetailLevel( &item, 5 ), c.second );
+        }
+    }
+}
+
+
+/**
+ * The level is capped by the levels of the item and by the levels the view can cache.
+ */
+BOOST_AUTO_TEST_CASE( LevelsAreCapped )
+{
+    COARSE_ITEM item( 5, 1000.0, 2 );
+    COARSE_ITEM manyLevels( 5, 1000.0, 100 );
+
+    m_view.SetScale( 1.0 );
+
+    BOOST_CHECK_EQUAL( m_view.getDetailLevel( &item, 5 ), 2 );
+    BOOST_CHECK_EQUAL( m_view.getDetailLevel( &manyLevels, 5 ),
+                       VIEW::VIEW_MAX_DETAIL_LEVELS - 1 );
+}
+
+
+/**
+ * Items without coarse geometry and printed items always use the full geometry.
+ */
+BOOST_AUTO_TEST_CASE( FullGeometry )
+{
+    COARSE_ITEM noCoarse( 5, 0.0, 1 );
+    COARSE_ITEM item( 5, 1000.0, VIEW::VIEW_MAX_DETAIL_LEVELS );
+
+    m_view.SetScale( 1.0 );
+
+    BOOST_CHECK_EQUAL( m_view.getDetailLevel( &noCoarse, 5 ), 0 );
+    BOOST_CHECK_EQUAL( m_view.getDetailLevel( &item, 5 ), VIEW::VIEW_MAX_DETAIL_LEVELS - 1 );
+
+    m_view.SetPrintMode( 1 );
+
+    BOOST_CHECK_EQUAL( m_view.getDetailLevel( &item, 5 ), 0 );
+}
+
+
+/**
+ * Caching an item too small on screen creates a group for its full geometry and another for
+ * the coarse geometry of the current scale, and both get the color updates.
+ */
+BOOST_AUTO_TEST_CASE( CoarseGroupCached )
+{
+    COARSE_ITEM item( 5, 1000.0, VIEW::VIEW_MAX_DETAIL_LEVELS );
+
+    m_view.SetScale( 100.0 );
+    addAndCache( item );
+
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.size(), 2 );
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.count( 0 ), 1 );
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.count( 2 ), 1 );
+    BOOST_CHECK_NE( m_painter.m_painted[0], m_painter.m_painted[2] );
+
+    // The painter is left drawing the full geometry
+    BOOST_CHECK_EQUAL( m_painter.GetSettings()->GetDetailLevel(), 0 );
+
+    m_gal.m_calls.clear();
+    m_view.Update( &item, COLOR );
+    m_view.UpdateItems();
+
+    BOOST_CHECK( m_gal.Called( "color " + std::to_string( m_painter.m_painted[0] ) ) );
+    BOOST_CHECK( m_gal.Called( "color " + std::to_string( m_painter.m_painted[2] ) ) );
+}
+
+
+/**
+ * Zooming out further caches the coarser level next to the existing groups, and a geometry
+ * change drops the coarse groups not needed at the current scale.
+ */
+BOOST_AUTO_TEST_CASE( CoarseGroupsUpdated )
+{
+    COARSE_ITEM item( 5, 1000.0, VIEW::VIEW_MAX_DETAIL_LEVELS );
+
+    m_view.SetScale( 100.0 );
+    addAndCache( item );
+
+    int fullGroup = m_painter.m_painted[0];
+    int level2Group = m_painter.m_painted[2];
+
+    m_gal.m_calls.clear();
+    m_painter.m_painted.clear();
+    m_view.SetScale( 10.0 );
+    m_view.Update( &item, COARSE );
+    m_view.UpdateItems();
+
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.size(), 1 );
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.count( 3 ), 1 );
+    BOOST_CHECK( !m_gal.Called( "delete " + std::to_string( fullGroup ) ) );
+    BOOST_CHECK( !m_gal.Called( "delete " + std::to_string( level2Group ) ) );
+
+    int level3Group = m_painter.m_painted[3];
+
+    m_gal.m_calls.clear();
+    m_painter.m_painted.clear();
+    m_view.SetScale( 2000.0 );
+    m_view.Update( &item, GEOMETRY );
+    m_view.UpdateItems();
+
+    BOOST_CHECK( m_gal.Called( "delete " + std::to_string( fullGroup ) ) );
+    BOOST_CHECK( m_gal.Called( "delete " + std::to_string( level2Group ) ) );
+    BOOST_CHECK( m_gal.Called( "delete " + std::to_string( level3Group ) ) );
+    BOOST_REQUIRE_EQUAL( m_painter.m_painted.size(), 1 );
+    BOOST_CHECK_EQUAL( m_painter.m_painted.count( 0 ), 1 );
+}
+
+
+/**
+ * Reordering the layers moves the coarse groups of the items along with the full ones.
+ */
+BOOST_AUTO_TEST_CASE( CoarseGroupsReordered )
+{
+    COARSE_ITEM item( 5, 1000.0, VIEW::VIEW_MAX_DETAIL_LEVELS );
+
+    m_view.SetScale( 100.0 );
+    addAndCache( item );
+
+    m_gal.m_calls.clear();
+
+    // Items report their new layer, the view then moves their data
+    item.m_layer = 9;
+    m_view.ReorderLayerData( { { 5, 9 }, { 9, 5 } } );
+
+    BOOST_CHECK( m_gal.Called( "color " + std::to_string( m_painter.m_painted[0] ) ) );
+    BOOST_CHECK( m_gal.Called( "color " + std::to_string( m_painter.m_painted[2] ) ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,343 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for CHUNK_ALLOCATOR, the free space manager of CACHED_CONTAINER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <gal/opengl/chunk_allocator.h>
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace KIGFX;
+
+
+BOOST_AUTO_TEST_SUITE( ChunkAllocator )
+
+
+/**
+ * Size classes hold the requested size, without wasting more than a quarter of the space.
+ */
+BOOST_AUTO_TEST_CASE( SizeClasses )
+{
+    unsigned int prev = 0;
+
+    for( unsigned int size = 1; size < 100000; size++ )
+    {
+        unsigned int sizeClass = CHUNK_ALLOCATOR::SizeClass( size );
+
+        BOOST_CHECK_GE( sizeClass, size );
+        BOOST_CHECK_GE( sizeClass, prev );
+        BOOST_CHECK_EQUAL( CHUNK_ALLOCATOR::SizeClass( sizeClass ), sizeClass );
+
+        if( size > 64 )
+            BOOST_CHECK_LE( sizeClass - size, size / 4 );
+
+        prev = sizeClass;
+    }
+}
+
+
+/**
+ * The smallest free chunk large enough is used, and freed chunks merge with their neighbours.
+ */
+BOOST_AUTO_TEST_CASE( BestFitAndMerge )
+{
+    CHUNK_ALLOCATOR alloc( 1024 );
+
+    const std::vector<unsigned int> sizes = { 64, 16, 64, 64, 8 };
+    const std::vector<unsigned int> expected = { 0, 64, 80, 144, 208 };
+
+    for( size_t i = 0; i < sizes.size(); i++ )
+        BOOST_CHECK_EQUAL( alloc.Allocate( sizes[i] ), expected[i] );
+
+    // Two holes (16 vertices at 64 and 64 vertices at 144) and the end of the container
+    alloc.Free( 64, 16 );
+    alloc.Free( 144, 64 );
+
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 3 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeSpace(), 1024 - 216 + 80 );
+    BOOST_CHECK_EQUAL( alloc.GetLargestFreeChunk(), 1024 - 216 );
+
+    // Both holes fit, the smallest one is used
+    BOOST_CHECK_EQUAL( alloc.Allocate( 10 ), 64 );
+
+    // The rest of the hole stays free
+    BOOST_CHECK_EQUAL( alloc.Allocate( 40 ), 144 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 2 );
+    BOOST_CHECK_GT( alloc.GetFragmentation(), 0.0 );
+
+    // Freeing everything merges the chunks back into one
+    alloc.Free( 0, 64 );
+    alloc.Free( 64, 16 );
+    alloc.Free( 80, 64 );
+    alloc.Free( 144, 40 );
+    alloc.Free( 208, 8 );
+
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeSpace(), 1024 );
+    BOOST_CHECK_EQUAL( alloc.GetFragmentation(), 0.0 );
+}
+
+
+/**
+ * Chunks are only relocated to free chunks below them.
+ */
+BOOST_AUTO_TEST_CASE( Relocate )
+{
+    CHUNK_ALLOCATOR alloc( 256 );
+
+    BOOST_CHECK_EQUAL( alloc.Allocate( 32 ), 0 );
+    BOOST_CHECK_EQUAL( alloc.Allocate( 32 ), 32 );
+    BOOST_CHECK_EQUAL( alloc.Allocate( 32 ), 64 );
+
+    // Nothing free below
+    BOOST_CHECK_EQUAL( alloc.Relocate( 64, 32 ), CHUNK_ALLOCATOR::NO_SPACE );
+
+    alloc.Free( 0, 32 );
+
+    BOOST_CHECK_EQUAL( alloc.Relocate( 32, 32 ), 0 );
+    BOOST_CHECK_EQUAL( alloc.Relocate( 64, 32 ), 32 );
+
+    // The chunks left behind merged with the end of the container
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( alloc.GetLargestFreeChunk(), 256 - 64 );
+
+    // The reset keeps the used part
+    alloc.Reset( 512, 64 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeSpace(), 512 - 64 );
+    BOOST_CHECK_EQUAL( alloc.Allocate( 1 ), 64 );
+}
+
+
+/**
+ * The highest chunks are moved down within the budget, once enough space is lost between them.
+ */
+BOOST_AUTO_TEST_CASE( Compact )
+{
+    CHUNK_ALLOCATOR alloc( 128 );
+
+    // Size of the chunk at each used offset
+    std::map<unsigned int, unsigned int> used;
+
+    auto highest =
+            [&]( unsigned int& aOffset, unsigned int& aSize )
+            {
+                if( used.empty() )
+                    return false;
+
+                aOffset = used.rbegin()->first;
+                aSize = used.rbegin()->second;
+                return true;
+            };
+
+    auto move =
+            [&]( unsigned int aOffset, unsigned int aNewOffset )
+            {
+                used[aNewOffset] = used[aOffset];
+                used.erase( aOffset );
+            };
+
+    // A full container
+    for( unsigned int i = 0; i < 8; i++ )
+        used[alloc.Allocate( 16 )] = 16;
+
+    // All the free space is in one chunk: nothing to do
+    alloc.Free( 0, 16 );
+    used.erase( 0 );
+
+    BOOST_CHECK_EQUAL( alloc.Compact( 1024, highest, move ), 0 );
+
+    alloc.Free( 32, 16 );
+    used.erase( 32 );
+
+    // The budget only allows moving one chunk
+    BOOST_CHECK_EQUAL( alloc.Compact( 20, highest, move ), 16 );
+    BOOST_CHECK_EQUAL( used.rbegin()->first, 96 );
+
+    // Then it stops when there is no free chunk left below
+    BOOST_CHECK_EQUAL( alloc.Compact( 1024, highest, move ), 16 );
+    BOOST_CHECK_EQUAL( used.rbegin()->first, 80 );
+    BOOST_CHECK_EQUAL( used.size(), 6 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( alloc.GetLargestFreeChunk(), 32 );
+}
+
+
+/**
+ * Simulate a long editing session: items of mixed sizes are added, modified and removed, while
+ * the highest chunks are moved down by Compact(), as CACHED_CONTAINER does.  Chunks must never
+ * overlap, and the free space must stay usable without a full defragmentation.
+ */
+BOOST_AUTO_TEST_CASE( Stress )
+{
+    const unsigned int    containerSize = 1 << 22;
+    const unsigned int    compactionBudget = 4096;
+    const size_t          itemCount = 2000;
+
+    CHUNK_ALLOCATOR       alloc( containerSize );
+    std::mt19937          rng( 42 );
+    std::vector<int>      owner( containerSize, -1 );
+
+    // Size of the chunk at each used offset
+    std::map<unsigned int, unsigned int> used;
+    unsigned int usedSpace = 0;
+    int          nextId = 0;
+    int          failures = 0;
+    unsigned int relocated = 0;
+
+    auto randomSize =
+            [&]() -> unsigned int
+            {
+                unsigned int kind = rng() % 100;
+
+                if( kind < 80 )         // segments, vias, pads
+                    return 3 * ( 1 + rng() % 20 );
+                else if( kind < 99 )    // footprints, texts
+                    return 60 + rng() % 2000;
+                else                    // zones
+                    return 2000 + rng() % 50000;
+            };
+
+    auto take =
+            [&]( unsigned int aOffset, unsigned int aSize, int aId )
+            {
+                BOOST_REQUIRE_LE( aOffset + aSize, containerSize );
+
+                for( unsigned int i = aOffset; i < aOffset + aSize; i++ )
+                {
+                    BOOST_REQUIRE_EQUAL( owner[i], -1 );
+                    owner[i] = aId;
+                }
+
+                used[aOffset] = aSize;
+                usedSpace += aSize;
+            };
+
+    auto release =
+            [&]( unsigned int aOffset ) -> int
+            {
+                unsigned int size = used[aOffset];
+                int          id = owner[aOffset];
+
+                std::fill( owner.begin() + aOffset, owner.begin() + aOffset + size, -1 );
+                used.erase( aOffset );
+                usedSpace -= size;
+                return id;
+            };
+
+    auto add =
+            [&]()
+            {
+                unsigned int size = randomSize();
+                unsigned int offset = alloc.Allocate( size );
+
+                if( offset == CHUNK_ALLOCATOR::NO_SPACE )
+                {
+                    failures++;
+                    return;
+                }
+
+                take( offset, CHUNK_ALLOCATOR::SizeClass( size ), nextId++ );
+            };
+
+    auto remove =
+            [&]()
+            {
+                auto it = used.begin();
+                std::advance( it, rng() % used.size() );
+
+                unsigned int offset = it->first;
+                unsigned int size = it->second;
+
+                release( offset );
+                alloc.Free( offset, size );
+            };
+
+    auto highest =
+            [&]( unsigned int& aOffset, unsigned int& aSize )
+            {
+                if( used.empty() )
+                    return false;
+
+                aOffset = used.rbegin()->first;
+                aSize = used.rbegin()->second;
+                return true;
+            };
+
+    auto move =
+            [&]( unsigned int aOffset, unsigned int aNewOffset )
+            {
+                unsigned int size = used[aOffset];
+
+                take( aNewOffset, size, release( aOffset ) );
+            };
+
+    for( int i = 0; i < 200000; i++ )
+    {
+        if( used.size() < itemCount / 2 || ( used.size() < itemCount && rng() % 2 ) )
+        {
+            add();
+        }
+        else
+        {
+            // Modifying an item replaces it, often with a similar size
+            remove();
+
+            if( rng() % 2 )
+                add();
+        }
+
+        relocated += alloc.Compact( compactionBudget, highest, move );
+
+        BOOST_REQUIRE_EQUAL( alloc.GetFreeSpace() + usedSpace, containerSize );
+    }
+
+    // The container is never more than half used, so all the items must fit
+    BOOST_CHECK_EQUAL( failures, 0 );
+    BOOST_CHECK_GT( relocated, 0 );
+
+    // Moving the highest chunks keeps most of the free space in one piece
+    BOOST_CHECK_LT( alloc.GetFragmentation(), 0.5 );
+
+    BOOST_TEST_MESSAGE( "free chunks: " << alloc.GetFreeChunkCount()
+                        << ", fragmentation: " << alloc.GetFragmentation()
+                        << ", relocated vertices: " << relocated );
+
+    // Freeing everything leaves a single chunk
+    while( !used.empty() )
+        remove();
+
+    BOOST_CHECK_EQUAL( alloc.GetFreeChunkCount(), 1 );
+    BOOST_CHECK_EQUAL( alloc.GetFreeSpace(), containerSize );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/poly_boolean_pipeline.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+
+
+static SHAPE_POLY_SET squareAt( int aX, int aY, int aSize )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.NewOutline();
+    poly.Append( aX, aY );
+    poly.Append( aX + aSize, aY );
+    poly.Append( aX + aSize, aY + aSize );
+    poly.Append( aX, aY + aSize );
+
+    return poly;
+}
+
+
+/**
+ * Compare two polygon sets by area and by their symmetric difference, which must be empty
+ * for identical geometry.
+ */
+static bool samePolySets( SHAPE_POLY_SET aA, SHAPE_POLY_SET aB )
+{
+    SHAPE_POLY_SET diffAB, diffBA;
+
+    diffAB.BooleanSubtract( aA, aB, SHAPE_POLY_SET::PM_FAST );
+    diffBA.BooleanSubtract( aB, aA, SHAPE_POLY_SET::PM_FAST );
+
+    return aA.Area() == aB.Area() && diffAB.IsEmpty() && diffBA.IsEmpty();
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( PolyBooleanPipeline, KI_TEST::CommonTestData )
+
+
+/**
+ * Many unions are resolved by a single Clipper execution.
+ */
+BOOST_AUTO_TEST_CASE( BatchedUnion )
+{
+    SHAPE_POLY_SET        expected;
+    POLY_BOOLEAN_PIPELINE pipeline;
+
+    for( int ii = 0; ii < 50; ii++ )
+    {
+        SHAPE_POLY_SET square = squareAt( ii * 7, ( ii % 5 ) * 3, 10 );
+
+        expected.BooleanAdd( square, SHAPE_POLY_SET::PM_FAST );
+        pipeline.Add( square );
+    }
+
+    SHAPE_POLY_SET result;
+    pipeline.Commit( result );
+
+    BOOST_CHECK_EQUAL( pipeline.ExecutionCount(), 1 );
+    BOOST_CHECK( samePolySets( expected, result ) );
+}
+
+
+/**
+ * A chain of booleans and an offset matches the same chain run on SHAPE_POLY_SET.
+ */
+BOOST_AUTO_TEST_CASE( MixedChain )
+{
+    SHAPE_POLY_SET expected = holeyPolySet;
+    SHAPE_POLY_SET clip = squareAt( 50, 50, 80 );
+    SHAPE_POLY_SET cutA = squareAt( 60, 60, 5 );
+    SHAPE_POLY_SET cutB = squareAt( 70, 70, 5 );
+
+    expected.BooleanIntersection( clip, SHAPE_POLY_SET::PM_FAST );
+    expected.BooleanSubtract( cutA, SHAPE_POLY_SET::PM_FAST );
+    expected.BooleanSubtract( cutB, SHAPE_POLY_SET::PM_FAST );
+    expected.Inflate( 2, 16 );
+    expected.BooleanSubtract( holeyPolySet, SHAPE_POLY_SET::PM_FAST );
+
+    POLY_BOOLEAN_PIPELINE pipeline( holeyPolySet );
+
+    pipeline.Intersect( clip );
+    pipeline.Subtract( cutA );
+    pipeline.Subtract( cutB );
+    pipeline.Inflate( 2, 16 );
+    pipeline.Subtract( holeyPolySet );
+
+    SHAPE_POLY_SET result;
+    pipeline.Commit( result );
+
+    // intersection, both subtractions, inflation and the final subtraction
+    BOOST_CHECK_EQUAL( pipeline.ExecutionCount(), 4 );
+    BOOST_CHECK( samePolySets( expected, result ) );
+}
+
+
+/**
+ * Holes survive a round trip through the pipeline.
+ */
+BOOST_AUTO_TEST_CASE( PreservesHoles )
+{
+    POLY_BOOLEAN_PIPELINE pipeline( holeyPolySet );
+    SHAPE_POLY_SET        result;
+
+    pipeline.Commit( result );
+
+    BOOST_CHECK_EQUAL( result.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( result.HoleCount( 0 ), 2 );
+    BOOST_CHECK( samePolySets( holeyPolySet, result ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    POLY_BOOLEAN_PIPELINE pipeline( emptyPolySet );
+    SHAPE_POLY_SET        result = holeyPolySet;
+
+    pipeline.Subtract( holeyPolySet );
+    pipeline.Commit( result );
+
+    BOOST_CHECK( result.IsEmpty() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
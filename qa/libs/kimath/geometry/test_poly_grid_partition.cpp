@@ -28,6 +28,9 @@
 
 #include <geometry/poly_grid_partition.h>
 
+#include <cmath>
+#include <random>
+
 struct PGPartitionFixture
 {
     SHAPE_POLY_SET testPolys[2];
@@ -74,5 +77,70 @@ BOOST_AUTO_TEST_CASE( PointInside )
 }
 
 
+/**
+ * A star-shaped outline with many vertices, so that the adaptive grid is larger than 16x16.
+ */
+static SHAPE_LINE_CHAIN buildStarOutline( int aVertexCount )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii < aVertexCount; ii++ )
+    {
+        double angle = 2.0 * M_PI * ii / aVertexCount;
+        double radius = ( ii % 2 ) ? 10000000.0 : 7000000.0;
+
+        chain.Append( VECTOR2I( KiROUND( radius * std::cos( angle ) ),
+                                KiROUND( radius * std::sin( angle ) ) ) );
+    }
+
+    chain.SetClosed( true );
+
+    return chain;
+}
+
+
+BOOST_AUTO_TEST_CASE( AdaptiveGridSize )
+{
+    BOOST_CHECK_EQUAL( POLY_GRID_PARTITION::GridSizeForVertexCount( 4 ), 16 );
+    BOOST_CHECK_EQUAL( POLY_GRID_PARTITION::GridSizeForVertexCount( 2500 ), 100 );
+    BOOST_CHECK_EQUAL( POLY_GRID_PARTITION::GridSizeForVertexCount( 1000000 ), 256 );
+
+    SHAPE_LINE_CHAIN    outline = buildStarOutline( 4000 );
+    POLY_GRID_PARTITION adaptive( outline );
+    POLY_GRID_PARTITION fixed( outline, 16 );
+
+    BOOST_CHECK_GT( adaptive.GetGridSize(), 16 );
+
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( -11000000, 11000000 );
+
+    for( int ii = 0; ii < 10000; ii++ )
+    {
+        VECTOR2I p( coord( rng ), coord( rng ) );
+
+        // The grid size only changes the speed of the lookup, never its result
+        BOOST_CHECK_EQUAL( adaptive.ContainsPoint( p ), fixed.ContainsPoint( p ) );
+        BOOST_CHECK_EQUAL( adaptive.ContainsPoint( p, 100000 ),
+                           fixed.ContainsPoint( p, 100000 ) );
+        BOOST_CHECK_EQUAL( adaptive.ContainsPoint( p ) != 0, outline.PointInside( p ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( ContainsAnyPoint )
+{
+    SHAPE_LINE_CHAIN    outline = buildStarOutline( 400 );
+    POLY_GRID_PARTITION part( outline );
+
+    const VECTOR2I inside( 0, 0 );
+    const VECTOR2I outside( 20000000, 0 );
+    const VECTOR2I nearEdge( 7050000, 0 ); // 50000 beyond the vertex at angle 0
+
+    BOOST_CHECK( part.ContainsAnyPoint( { outside, inside } ) );
+    BOOST_CHECK( !part.ContainsAnyPoint( { outside, nearEdge } ) );
+    BOOST_CHECK( part.ContainsAnyPoint( { outside, nearEdge }, 100000 ) );
+    BOOST_CHECK( !part.ContainsAnyPoint( {} ) );
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
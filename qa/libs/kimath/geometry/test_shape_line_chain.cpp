@@ -59,4 +59,43 @@ BOOST_AUTO_TEST_CASE( ArcToPolyline )
 }
 
 
+/**
+ * Chains without arcs don't carry arc metadata, and gain (or lose) it correctly as arcs are
+ * added to (or removed from) them.
+ */
+BOOST_AUTO_TEST_CASE( LazyArcMetadata )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( 0, 0 ), VECTOR2I( 1000, 0 ), VECTOR2I( 1000, 1000 ) } );
+
+    chain.Append( 0, 1000 );
+    chain.Split( VECTOR2I( 500, 0 ) );
+    chain.Simplify();
+
+    BOOST_CHECK_EQUAL( chain.ShapeCount(), 3 );
+    BOOST_CHECK( !chain.isArc( 0 ) );
+
+    SHAPE_LINE_CHAIN arc( SHAPE_ARC( VECTOR2I( 0, 1002000 ), VECTOR2I( 0, 2000 ), 180 ) );
+
+    chain.Append( arc );
+
+    // three segments, the segment joining the arc, and the arc
+    BOOST_CHECK_EQUAL( chain.ArcCount(), 1 );
+    BOOST_CHECK_EQUAL( chain.ShapeCount(), 5 );
+    BOOST_CHECK_EQUAL( chain.ArcIndex( 4 ), 0 );
+    BOOST_CHECK( chain.isArc( chain.PointCount() - 2 ) );
+
+    chain.Append( 0, 3000000 );
+
+    BOOST_CHECK_EQUAL( chain.CShapes().size(), chain.CPoints().size() );
+    BOOST_CHECK_EQUAL( chain.ArcIndex( chain.PointCount() - 1 ), -1 );
+
+    // Moving a point of the arc turns it back into plain segments
+    chain.SetPoint( 4, chain.CPoint( 4 ) + VECTOR2I( 10, 0 ) );
+
+    BOOST_CHECK_EQUAL( chain.ArcCount(), 0 );
+    BOOST_CHECK_EQUAL( chain.ShapeCount(), chain.PointCount() - 1 );
+    BOOST_CHECK_EQUAL( chain.CShapes().size(), chain.CPoints().size() );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
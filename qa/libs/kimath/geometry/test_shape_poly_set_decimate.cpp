@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+static SHAPE_LINE_CHAIN square( int aX, int aY, int aSize )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( aX, aY ), VECTOR2I( aX + aSize, aY ),
+                              VECTOR2I( aX + aSize, aY + aSize ), VECTOR2I( aX, aY + aSize ) },
+                            true );
+
+    return chain;
+}
+
+
+/**
+ * A square with \a aSteps points on each side, like a zone outline following a curve.
+ */
+static SHAPE_LINE_CHAIN denseSquare( int aX, int aY, int aSize, int aSteps )
+{
+    SHAPE_LINE_CHAIN chain;
+    int              step = aSize / aSteps;
+
+    for( int ii = 0; ii < aSteps; ii++ )
+        chain.Append( aX + ii * step, aY );
+
+    for( int ii = 0; ii < aSteps; ii++ )
+        chain.Append( aX + aSize, aY + ii * step );
+
+    for( int ii = 0; ii < aSteps; ii++ )
+        chain.Append( aX + aSize - ii * step, aY + aSize );
+
+    for( int ii = 0; ii < aSteps; ii++ )
+        chain.Append( aX, aY + aSize - ii * step );
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetDecimate )
+
+
+/**
+ * No point is closer than the tolerance to the previous one, and the corners far apart are kept.
+ */
+BOOST_AUTO_TEST_CASE( DropsClosePoints )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.AddOutline( denseSquare( 0, 0, 10000, 100 ) );
+
+    SHAPE_POLY_SET decimated = poly.Decimated( 1000 );
+
+    BOOST_REQUIRE_EQUAL( decimated.OutlineCount(), 1 );
+
+    const SHAPE_LINE_CHAIN& outline = decimated.COutline( 0 );
+
+    BOOST_CHECK( outline.IsClosed() );
+    BOOST_CHECK_EQUAL( outline.PointCount(), 40 );
+
+    for( int ii = 1; ii < outline.PointCount(); ii++ )
+        BOOST_CHECK_GE( ( outline.CPoint( ii ) - outline.CPoint( ii - 1 ) ).EuclideanNorm(), 1000 );
+
+    BOOST_CHECK( outline.BBox() == poly.COutline( 0 ).BBox() );
+}
+
+
+/**
+ * A tolerance below the point spacing keeps the set as it is.
+ */
+BOOST_AUTO_TEST_CASE( SmallTolerance )
+{
+    SHAPE_POLY_SET poly;
+
+    int outline = poly.AddOutline( denseSquare( 0, 0, 10000, 100 ) );
+    poly.AddHole( square( 2000, 2000, 1000 ), outline );
+
+    SHAPE_POLY_SET decimated = poly.Decimated( 50 );
+
+    BOOST_REQUIRE_EQUAL( decimated.OutlineCount(), 1 );
+    BOOST_REQUIRE_EQUAL( decimated.HoleCount( 0 ), 1 );
+    BOOST_CHECK( decimated.COutline( 0 ).CompareGeometry( poly.COutline( 0 ) ) );
+    BOOST_CHECK( decimated.CHole( 0, 0 ).CompareGeometry( poly.CHole( 0, 0 ) ) );
+    BOOST_CHECK_EQUAL( decimated.Area(), poly.Area() );
+}
+
+
+/**
+ * Polygons and holes smaller than the tolerance disappear, the larger ones stay.
+ */
+BOOST_AUTO_TEST_CASE( DropsSmallContours )
+{
+    SHAPE_POLY_SET poly;
+
+    int big = poly.AddOutline( square( 0, 0, 10000 ) );
+    poly.AddHole( square( 1000, 1000, 100 ), big );
+    poly.AddHole( square( 5000, 5000, 2000 ), big );
+
+    int tiny = poly.AddOutline( square( 20000, 0, 100 ) );
+    poly.AddHole( square( 20010, 10, 10 ), tiny );
+
+    SHAPE_POLY_SET decimated = poly.Decimated( 500 );
+
+    BOOST_REQUIRE_EQUAL( decimated.OutlineCount(), 1 );
+    BOOST_CHECK( decimated.COutline( 0 ).CompareGeometry( poly.COutline( big ) ) );
+    BOOST_REQUIRE_EQUAL( decimated.HoleCount( 0 ), 1 );
+    BOOST_CHECK( decimated.CHole( 0, 0 ).CompareGeometry( poly.CHole( big, 1 ) ) );
+}
+
+
+/**
+ * Decimating an empty set gives an empty set.
+ */
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    SHAPE_POLY_SET poly;
+
+    BOOST_CHECK_EQUAL( poly.Decimated( 1000 ).OutlineCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+
+static SHAPE_LINE_CHAIN square( int aX, int aY, int aSize )
+{
+    SHAPE_LINE_CHAIN chain( { VECTOR2I( aX, aY ), VECTOR2I( aX + aSize, aY ),
+                              VECTOR2I( aX + aSize, aY + aSize ), VECTOR2I( aX, aY + aSize ) },
+                            true );
+
+    return chain;
+}
+
+
+/**
+ * Add a square polygon at \a aX, \a aY with a grid of \a aGrid x \a aGrid square holes, like a
+ * zone filled around a via field.
+ */
+static void addHoleyPolygon( SHAPE_POLY_SET& aSet, int aX, int aY, int aGrid )
+{
+    const int pitch = 1000;
+    const int outline = aSet.AddOutline( square( aX, aY, ( aGrid + 1 ) * pitch ) );
+
+    for( int ix = 0; ix < aGrid; ix++ )
+    {
+        for( int iy = 0; iy < aGrid; iy++ )
+        {
+            // Stagger the holes so that some bridges land on holes, others on the outline
+            int x = aX + pitch / 2 + ix * pitch;
+            int y = aY + pitch / 2 + iy * pitch + ( ix % 2 ) * pitch / 4;
+
+            aSet.AddHole( square( x, y, pitch / 3 ), outline );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetFracture )
+
+
+/**
+ * Fracturing merges all the holes of a polygon into its outline, without changing its area.
+ */
+BOOST_AUTO_TEST_CASE( HoleGrid )
+{
+    SHAPE_POLY_SET poly;
+
+    addHoleyPolygon( poly, 0, 0, 20 );
+
+    double area = poly.Area();
+
+    poly.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( poly.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( poly.HoleCount( 0 ), 0 );
+    BOOST_CHECK_EQUAL( poly.Area(), area );
+
+    poly.Unfracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( poly.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( poly.HoleCount( 0 ), 400 );
+}
+
+
+/**
+ * Sets with many polygons give the same result as fracturing each polygon on its own.
+ */
+BOOST_AUTO_TEST_CASE( ManyPolygons )
+{
+    SHAPE_POLY_SET poly;
+
+    for( int ii = 0; ii < 8; ii++ )
+        addHoleyPolygon( poly, ii * 50000, 0, 30 );
+
+    SHAPE_POLY_SET expected;
+
+    for( int ii = 0; ii < poly.OutlineCount(); ii++ )
+    {
+        SHAPE_POLY_SET single( poly.UnitSet( ii ) );
+
+        single.Fracture( SHAPE_POLY_SET::PM_FAST );
+        expected.Append( single );
+    }
+
+    poly.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_REQUIRE_EQUAL( poly.OutlineCount(), expected.OutlineCount() );
+
+    // Simplify() may reorder the polygons, so match them up by position
+    for( int ii = 0; ii < poly.OutlineCount(); ii++ )
+    {
+        BOOST_CHECK_EQUAL( poly.HoleCount( ii ), 0 );
+
+        int match = -1;
+
+        for( int jj = 0; jj < expected.OutlineCount(); jj++ )
+        {
+            if( expected.COutline( jj ).BBox() == poly.COutline( ii ).BBox() )
+                match = jj;
+        }
+
+        BOOST_REQUIRE( match >= 0 );
+        BOOST_CHECK( poly.COutline( ii ).CompareGeometry( expected.COutline( match ) ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PNS::BATCH_ROUTER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <netinfo.h>
+#include <track.h>
+#include <drc/drc_engine.h>
+#include <router/pns_batch_router.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_segment.h>
+
+#include <map>
+
+
+struct BATCH_ROUTER_FIXTURE
+{
+    BATCH_ROUTER_FIXTURE() :
+            m_settings( nullptr, "" )
+    {
+        for( int net = 1; net <= 2; net++ )
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "net%d", net ), net ) );
+
+        // The router takes its clearances from the DRC engine
+        BOARD_DESIGN_SETTINGS& bds = m_board.GetDesignSettings();
+        bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( &m_board, &bds );
+        bds.m_DRCEngine->InitEngine( wxFileName() );
+    }
+
+    void addTrack( int aNet, const VECTOR2I& aStart, const VECTOR2I& aEnd )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetLayer( F_Cu );
+        track->SetWidth( m_width );
+        track->SetStart( wxPoint( aStart.x, aStart.y ) );
+        track->SetEnd( wxPoint( aEnd.x, aEnd.y ) );
+        track->SetNetCode( aNet );
+
+        m_board.Add( track );
+    }
+
+    ///< Set up the router once the board is complete.
+    void syncRouter()
+    {
+        m_iface.SetBoard( &m_board );
+        m_router.SetInterface( &m_iface );
+        m_router.ClearWorld();
+        m_router.SyncWorld();
+        m_router.LoadSettings( &m_settings );
+    }
+
+    PNS::BATCH_ROUTER::CONNECTION connection( int aNet, const VECTOR2I& aStart,
+                                              const VECTOR2I& aEnd ) const
+    {
+        return { aStart, aEnd, nullptr, nullptr, aNet, F_Cu, m_width };
+    }
+
+    /**
+     * Return the length of the segments routed in \a aNode for each net, checking that none
+     * of them collides with the rest of the branch.
+     */
+    std::map<int, int> routedLengths( PNS::NODE* aNode )
+    {
+        PNS::NODE::ITEM_VECTOR removed;
+        PNS::NODE::ITEM_VECTOR added;
+        std::map<int, int>     lengths;
+
+        aNode->GetUpdatedItems( removed, added );
+
+        BOOST_CHECK( removed.empty() );
+
+        for( PNS::ITEM* item : added )
+        {
+            BOOST_REQUIRE( item->OfKind( PNS::ITEM::SEGMENT_T ) );
+            BOOST_CHECK( !aNode->CheckColliding( item ) );
+
+            lengths[item->Net()] += static_cast<PNS::SEGMENT*>( item )->Seg().Length();
+        }
+
+        return lengths;
+    }
+
+    const int             m_width = Millimeter2iu( 0.25 );
+    BOARD                 m_board;
+    PNS_KICAD_IFACE_BASE  m_iface;
+    PNS::ROUTING_SETTINGS m_settings;
+    PNS::ROUTER           m_router;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BatchRouter, BATCH_ROUTER_FIXTURE )
+
+
+/**
+ * A connection blocked by a track of another net walks around it.
+ */
+BOOST_AUTO_TEST_CASE( WalksAroundObstacles )
+{
+    const VECTOR2I start( 0, 0 );
+    const VECTOR2I end( Millimeter2iu( 20 ), 0 );
+
+    addTrack( 2, VECTOR2I( Millimeter2iu( 10 ), Millimeter2iu( -5 ) ),
+              VECTOR2I( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ) );
+    syncRouter();
+
+    PNS::BATCH_ROUTER batch( &m_router );
+    batch.AddConnection( connection( 1, start, end ) );
+
+    BOOST_CHECK_EQUAL( batch.Route(), 1 );
+    BOOST_CHECK( batch.IsRouted( 0 ) );
+
+    std::map<int, int> lengths = routedLengths( batch.CurrentNode() );
+
+    BOOST_CHECK_EQUAL( lengths.size(), 1 );
+    BOOST_CHECK_GT( lengths[1], ( end - start ).EuclideanNorm() );
+}
+
+
+/**
+ * Connections are routed independently, then merged in the order they were added: the first
+ * one keeps its straight route and the one crossing it is routed again around it.
+ */
+BOOST_AUTO_TEST_CASE( MergesInOrder )
+{
+    const VECTOR2I startA( 0, 0 );
+    const VECTOR2I endA( Millimeter2iu( 20 ), 0 );
+    const VECTOR2I startB( Millimeter2iu( 10 ), Millimeter2iu( -5 ) );
+    const VECTOR2I endB( Millimeter2iu( 10 ), Millimeter2iu( 5 ) );
+
+    syncRouter();
+
+    PNS::BATCH_ROUTER batch( &m_router );
+    batch.AddConnection( connection( 1, startA, endA ) );
+    batch.AddConnection( connection( 2, startB, endB ) );
+
+    BOOST_CHECK_EQUAL( batch.Route(), 2 );
+    BOOST_CHECK( batch.IsRouted( 0 ) );
+    BOOST_CHECK( batch.IsRouted( 1 ) );
+
+    std::map<int, int> lengths = routedLengths( batch.CurrentNode() );
+
+    BOOST_CHECK_EQUAL( lengths[1], ( endA - startA ).EuclideanNorm() );
+    BOOST_CHECK_GT( lengths[2], ( endB - startB ).EuclideanNorm() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
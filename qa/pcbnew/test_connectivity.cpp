@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the lifetime of the connectivity items referred to by the ratsnest
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <board.h>
+#include <netinfo.h>
+#include <track.h>
+#include <connectivity/connectivity_algo.h>
+#include <connectivity/connectivity_data.h>
+#include <ratsnest/ratsnest_data.h>
+
+#include <memory>
+#include <set>
+
+
+struct CONNECTIVITY_FIXTURE
+{
+    CONNECTIVITY_FIXTURE()
+    {
+        m_net = new NETINFO_ITEM( &m_board, "net1", 1 );
+        m_board.Add( m_net );
+    }
+
+    /**
+     * Add an isolated track of net 1 to the board, at column \a aIndex of row \a aRow.
+     */
+    TRACK* addTrack( int aIndex, int aRow )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetLayer( F_Cu );
+        track->SetWidth( Millimeter2iu( 0.2 ) );
+        track->SetStart( wxPoint( Millimeter2iu( 5 * aIndex ), Millimeter2iu( 5 * aRow ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( 5 * aIndex + 1 ), Millimeter2iu( 5 * aRow ) ) );
+        track->SetNet( m_net );
+
+        m_board.Add( track );
+        return track;
+    }
+
+    BOARD         m_board;
+    NETINFO_ITEM* m_net;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Connectivity, CONNECTIVITY_FIXTURE )
+
+
+/**
+ * Items removed from the connectivity are garbage collected by any cluster search, but the
+ * ratsnest must stay readable until it is recalculated, even when new items are added in the
+ * meantime.  Best run under ASan, which catches reads of freed anchors.
+ */
+BOOST_AUTO_TEST_CASE( RatsnestOutlivesGarbageCollection )
+{
+    const int           trackCount = 64;
+    std::vector<TRACK*> tracks;
+
+    for( int i = 0; i < trackCount; i++ )
+        tracks.push_back( addTrack( i, 0 ) );
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board.GetConnectivity();
+    connectivity->Build( &m_board );
+
+    RN_NET* net = connectivity->GetRatsnestForNet( 1 );
+
+    BOOST_REQUIRE( net );
+    BOOST_CHECK_EQUAL( net->GetEdges().size(), trackCount - 1 );
+
+    std::set<std::pair<int, int>> oldEnds;
+
+    for( TRACK* track : tracks )
+    {
+        oldEnds.emplace( track->GetStart().x, track->GetStart().y );
+        oldEnds.emplace( track->GetEnd().x, track->GetEnd().y );
+    }
+
+    // The removed tracks stay alive, as they would in the undo list
+    std::vector<std::unique_ptr<TRACK>> removed;
+
+    for( int i = 0; i < trackCount; i += 2 )
+    {
+        connectivity->Remove( tracks[i] );
+        m_board.Remove( tracks[i] );
+        removed.emplace_back( tracks[i] );
+    }
+
+    constexpr KICAD_T types[] = { PCB_TRACE_T, EOT };
+
+    // Collects the garbage, and the new items can then reuse its slots
+    connectivity->GetConnectedItems( tracks[1], types );
+
+    for( int i = 0; i < trackCount / 2; i++ )
+        connectivity->Add( addTrack( i, 1 ) );
+
+    connectivity->GetConnectedItems( tracks[1], types );
+
+    // The ratsnest is stale, but still describes the board as it was
+    for( const CN_EDGE& edge : net->GetEdges() )
+    {
+        VECTOR2I source = edge.GetSourcePos();
+        VECTOR2I target = edge.GetTargetPos();
+
+        BOOST_CHECK( oldEnds.count( { source.x, source.y } ) );
+        BOOST_CHECK( oldEnds.count( { target.x, target.y } ) );
+    }
+
+    CN_ANCHOR_PTR nodeA = nullptr;
+    CN_ANCHOR_PTR nodeB = nullptr;
+
+    BOOST_CHECK( net->NearestBicoloredPair( *net, nodeA, nodeB ) );
+
+    connectivity->RecalculateRatsnest();
+
+    // The remaining tracks and the new ones are all isolated
+    BOOST_CHECK_EQUAL( net->GetEdges().size(), trackCount - 1 );
+
+    for( const CN_EDGE& edge : net->GetEdges() )
+    {
+        BOOST_CHECK( edge.GetSourceNode()->Item()->Valid() );
+        BOOST_CHECK( edge.GetTargetNode()->Item()->Valid() );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PNS::LINE_LENGTH_INDEX and the cut of the tuned part of a line
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <router/pns_meander_placer_base.h>
+
+
+///< Gives access to the cut of the length tuners
+struct MEANDER_CUT : public PNS::MEANDER_PLACER_BASE
+{
+    using PNS::MEANDER_PLACER_BASE::cutTunedLine;
+};
+
+
+struct LINE_LENGTH_INDEX_CASE
+{
+    std::string m_ctx_name;
+    VECTOR2I    m_tuneStart;
+    VECTOR2I    m_cursor;
+    int         m_expPre;
+    int         m_expTuned;
+};
+
+
+BOOST_AUTO_TEST_SUITE( LineLengthIndex )
+
+
+BOOST_AUTO_TEST_CASE( SpanLength )
+{
+    SHAPE_LINE_CHAIN line( { VECTOR2I( 0, 0 ), VECTOR2I( 100, 0 ), VECTOR2I( 100, 100 ),
+                             VECTOR2I( 300, 100 ) } );
+
+    PNS::LINE_LENGTH_INDEX index;
+    index.Build( line );
+
+    BOOST_CHECK_EQUAL( index.Total(), 400 );
+    BOOST_CHECK_EQUAL( index.LengthAt( { 1, 25 } ), 125 );
+
+    // From the middle of the first segment to the middle of the last one
+    BOOST_CHECK_EQUAL( index.SpanLength( { 0, 50 }, { 2, 100 } ), 250 );
+    BOOST_CHECK_EQUAL( index.SpanLength( { 2, 100 }, { 0, 50 } ), 250 );
+
+    // The end of a segment is the start of the next one
+    BOOST_CHECK_EQUAL( index.SpanLength( { 0, 100 }, { 1, 0 } ), 0 );
+}
+
+
+/**
+ * The length of the tuned part has to match the part actually cut out, also when the line
+ * goes through the cursor point more than once.
+ */
+BOOST_AUTO_TEST_CASE( CutSpanLength )
+{
+    // Crosses itself at (100, 0)
+    SHAPE_LINE_CHAIN line( { VECTOR2I( 0, 0 ), VECTOR2I( 200, 0 ), VECTOR2I( 200, 100 ),
+                             VECTOR2I( 100, 100 ), VECTOR2I( 100, -100 ) } );
+
+    const std::vector<LINE_LENGTH_INDEX_CASE> cases = {
+        { "forward", { 50, 0 }, { 150, 0 }, 50, 100 },
+        { "backward", { 150, 0 }, { 50, 0 }, 450, 100 },
+        { "over corners", { 50, 0 }, { 200, 50 }, 50, 200 },
+        { "near crossing", { 50, 0 }, { 100, 1 }, 50, 449 },
+        { "from crossing", { 100, 1 }, { 50, 0 }, 101, 449 },
+        { "whole line", { 0, 0 }, { 100, -100 }, 0, 600 },
+    };
+
+    PNS::LINE_LENGTH_INDEX index;
+    index.Build( line );
+
+    for( const LINE_LENGTH_INDEX_CASE& c : cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_ctx_name )
+        {
+            SHAPE_LINE_CHAIN                 pre, tuned, post;
+            PNS::LINE_LENGTH_INDEX::LOCATION tunedStart, tunedEnd;
+
+            MEANDER_CUT::cutTunedLine( line, c.m_tuneStart, c.m_cursor, pre, tuned, post,
+                                       tunedStart, tunedEnd );
+
+            BOOST_CHECK_EQUAL( pre.Length(), c.m_expPre );
+            BOOST_CHECK_EQUAL( tuned.Length(), c.m_expTuned );
+            BOOST_CHECK_EQUAL( index.SpanLength( tunedStart, tunedEnd ), c.m_expTuned );
+            BOOST_CHECK_EQUAL( pre.Length() + tuned.Length() + post.Length(), index.Total() );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file connectivity_perf.cpp
+ * Build the connectivity and ratsnest of a board and dump the PERF_COUNTERS they filled,
+ * as JSON, so that timings can be attached to bug reports:
+ *
+ *     qa_pcbnew_tools connectivity_perf -n 5 -o timings.json board.kicad_pcb
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <common.h>
+#include <perf_counters.h>
+
+#include <wx/cmdline.h>
+
+#include <fstream>
+#include <iostream>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print the counters to stderr too" ).mb_str() },
+    { wxCMD_LINE_OPTION, "o", "output", _( "write the JSON to this file instead of stdout" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "n", "iterations",
+            _( "number of times the connectivity is built, default 3" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum CONN_PERF_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    OUTPUT_FAILED,
+};
+
+
+int connectivity_perf_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program builds the connectivity and ratsnest of a board, read "
+                               "from the given file or from stdin, and prints the performance "
+                               "counters as JSON." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString filename, output;
+    long     iterations = 3;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 );
+
+    cl_parser.Found( "output", &output );
+    cl_parser.Found( "iterations", &iterations );
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename.ToStdString() );
+
+    if( !board )
+        return LOAD_FAILED;
+
+    // Only count the builds below, not whatever loading the board did
+    PERF_COUNTERS::ResetAll();
+
+    for( long ii = 0; ii < iterations; ii++ )
+        board->BuildConnectivity();
+
+    if( cl_parser.Found( "verbose" ) )
+    {
+        for( const PERF_COUNTER* counter : PERF_COUNTERS::GetAll() )
+            counter->Show( std::cerr );
+    }
+
+    if( output.IsEmpty() )
+    {
+        std::cout << PERF_COUNTERS::ToJson() << std::endl;
+    }
+    else
+    {
+        std::ofstream out( output.ToStdString() );
+
+        if( !( out << PERF_COUNTERS::ToJson() << std::endl ) )
+        {
+            std::cerr << "Could not write " << output << std::endl;
+            return OUTPUT_FAILED;
+        }
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "connectivity_perf",
+        "Dump connectivity and ratsnest performance counters of a PCB as JSON",
+        connectivity_perf_main,
+} );
@@ -0,0 +1,450 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file geometry_benchmark.cpp
+ * Micro-benchmarks for the kimath geometry kernel, run on the zone and pad geometry of a
+ * real board.
+ *
+ * Each benchmark reports the time and the number of heap allocations per operation.  The
+ * results can be saved and later compared against, to catch performance regressions:
+ *
+ *     qa_pcbnew_tools geometry_benchmark -o baseline.txt board.kicad_pcb
+ *     (change things)
+ *     qa_pcbnew_tools geometry_benchmark -b baseline.txt board.kicad_pcb
+ */
+
+#include <geometry/shape_poly_set.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <pad.h>
+#include <profile.h>
+#include <zone.h>
+
+#include <wx/cmdline.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <new>
+
+
+/*
+ * Heap allocations are counted by replacing the global allocation functions.  This applies to
+ * the whole qa_pcbnew_tools executable, but only costs a relaxed atomic increment.
+ */
+static std::atomic<size_t> g_allocCount( 0 );
+
+
+void* operator new( std::size_t aSize )
+{
+    g_allocCount.fetch_add( 1, std::memory_order_relaxed );
+
+    if( void* ptr = std::malloc( aSize ? aSize : 1 ) )
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete( void* aPtr, std::size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+struct BENCH_RESULT
+{
+    double m_nsPerOp;
+    double m_allocsPerOp;
+    long   m_iterations;
+};
+
+
+using BENCH_RESULTS = std::map<std::string, BENCH_RESULT>;
+
+
+/**
+ * Geometry the benchmarks run on, extracted from a board.
+ */
+struct BENCH_DATA
+{
+    std::vector<SHAPE_POLY_SET> m_zones;     ///< filled areas, as stored (fractured)
+    SHAPE_POLY_SET              m_pads;      ///< all front copper pads, one outline each
+    std::vector<VECTOR2I>       m_probes;    ///< points spread over the board
+};
+
+
+/**
+ * Run \a aOp repeatedly, for at least \a aMinTimeMs, and measure it.
+ *
+ * @param aSetup is run before each call of \a aOp and is not measured.
+ */
+static BENCH_RESULT runBenchmark( const std::function<void()>& aSetup,
+                                  const std::function<void()>& aOp, double aMinTimeMs )
+{
+    using DURATION = std::chrono::duration<double, std::nano>;
+
+    BENCH_RESULT result = { 0.0, 0.0, 0 };
+    DURATION     total( 0 );
+    size_t       allocs = 0;
+
+    while( total.count() < aMinTimeMs * 1e6 || result.m_iterations < 3 )
+    {
+        if( aSetup )
+            aSetup();
+
+        size_t allocsBefore = g_allocCount.load( std::memory_order_relaxed );
+
+        PROF_COUNTER counter;
+        aOp();
+        total += counter.SinceStart<DURATION>();
+
+        allocs += g_allocCount.load( std::memory_order_relaxed ) - allocsBefore;
+        result.m_iterations++;
+    }
+
+    result.m_nsPerOp = total.count() / result.m_iterations;
+    result.m_allocsPerOp = double( allocs ) / result.m_iterations;
+
+    return result;
+}
+
+
+/**
+ * Copy the outlines of \a aSource to \a aDest, but not its cached triangulation, so that
+ * CacheTriangulation() has to do the full work.
+ */
+static void copyOutlines( const SHAPE_POLY_SET& aSource, SHAPE_POLY_SET& aDest )
+{
+    aDest.RemoveAllContours();
+
+    for( int ii = 0; ii < aSource.OutlineCount(); ii++ )
+    {
+        int outline = aDest.AddOutline( aSource.COutline( ii ) );
+
+        for( int jj = 0; jj < aSource.HoleCount( ii ); jj++ )
+            aDest.AddHole( aSource.CHole( ii, jj ), outline );
+    }
+}
+
+
+static BENCH_DATA extractBenchData( BOARD& aBoard )
+{
+    BENCH_DATA data;
+
+    for( ZONE* zone : aBoard.Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            if( zone->HasFilledPolysForLayer( layer )
+                    && zone->GetFilledPolysList( layer ).OutlineCount() )
+            {
+                data.m_zones.push_back( zone->GetFilledPolysList( layer ) );
+            }
+        }
+    }
+
+    for( PAD* pad : aBoard.GetPads() )
+    {
+        if( pad->IsOnLayer( F_Cu ) )
+            pad->TransformShapeWithClearanceToPolygon( data.m_pads, F_Cu, 0, ARC_HIGH_DEF,
+                                                       ERROR_INSIDE );
+    }
+
+    // A regular grid of probe points over the whole board, so that they hit and miss the
+    // geometry in realistic proportions
+    const int gridSize = 32;
+    EDA_RECT  bbox = aBoard.GetBoundingBox();
+
+    for( int ix = 0; ix < gridSize; ix++ )
+    {
+        for( int iy = 0; iy < gridSize; iy++ )
+        {
+            data.m_probes.emplace_back( bbox.GetX() + bbox.GetWidth() * ix / gridSize,
+                                        bbox.GetY() + bbox.GetHeight() * iy / gridSize );
+        }
+    }
+
+    return data;
+}
+
+
+static BENCH_RESULTS runBenchmarks( const BENCH_DATA& aData, const std::string& aFilter,
+                                    double aMinTimeMs )
+{
+    BENCH_RESULTS  results;
+    SHAPE_POLY_SET work;
+
+    auto bench =
+            [&]( const std::string& aName, const std::function<void()>& aSetup,
+                 const std::function<void()>& aOp )
+            {
+                if( aName.find( aFilter ) == std::string::npos )
+                    return;
+
+                results[aName] = runBenchmark( aSetup, aOp, aMinTimeMs );
+            };
+
+    for( size_t ii = 0; ii < aData.m_zones.size(); ii++ )
+    {
+        const SHAPE_POLY_SET& zone = aData.m_zones[ii];
+        const std::string     prefix = "zone" + std::to_string( ii ) + "/";
+
+        // One "operation" is a query of every probe point
+        bench( prefix + "Collide", nullptr,
+               [&]()
+               {
+                   for( const VECTOR2I& pt : aData.m_probes )
+                       zone.Collide( pt, Millimeter2iu( 0.2 ) );
+               } );
+
+        bench( prefix + "Contains", nullptr,
+               [&]()
+               {
+                   for( const VECTOR2I& pt : aData.m_probes )
+                       zone.Contains( pt );
+               } );
+
+        bench( prefix + "Inflate",
+               [&]() { work = zone; },
+               [&]() { work.Inflate( Millimeter2iu( 0.1 ), 16 ); } );
+
+        bench( prefix + "Fracture",
+               [&]()
+               {
+                   work = zone;
+                   work.Unfracture( SHAPE_POLY_SET::PM_FAST );
+               },
+               [&]() { work.Fracture( SHAPE_POLY_SET::PM_FAST ); } );
+
+        bench( prefix + "CacheTriangulation",
+               [&]() { copyOutlines( zone, work ); },
+               [&]() { work.CacheTriangulation(); } );
+    }
+
+    if( aData.m_pads.OutlineCount() )
+    {
+        bench( "pads/Collide", nullptr,
+               [&]()
+               {
+                   for( const VECTOR2I& pt : aData.m_probes )
+                       aData.m_pads.Collide( pt );
+               } );
+
+        bench( "pads/Simplify",
+               [&]() { work = aData.m_pads; },
+               [&]() { work.Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+    }
+
+    return results;
+}
+
+
+static bool saveResults( const BENCH_RESULTS& aResults, const std::string& aFilename )
+{
+    std::ofstream out( aFilename );
+
+    for( const auto& entry : aResults )
+    {
+        out << entry.first << " " << entry.second.m_nsPerOp << " "
+            << entry.second.m_allocsPerOp << "\n";
+    }
+
+    return out.good();
+}
+
+
+static bool loadResults( BENCH_RESULTS& aResults, const std::string& aFilename )
+{
+    std::ifstream in( aFilename );
+    std::string   name;
+    BENCH_RESULT  result = { 0.0, 0.0, 0 };
+
+    if( !in )
+        return false;
+
+    while( in >> name >> result.m_nsPerOp >> result.m_allocsPerOp )
+        aResults[name] = result;
+
+    return true;
+}
+
+
+/**
+ * Print the results, compared to \a aBaseline when it is not empty.
+ *
+ * @return the number of benchmarks slower than the baseline by more than \a aThreshold
+ *         percent.
+ */
+static int reportResults( const BENCH_RESULTS& aResults, const BENCH_RESULTS& aBaseline,
+                          double aThreshold )
+{
+    int regressions = 0;
+
+    std::cout << std::left << std::setw( 32 ) << "benchmark" << std::right << std::setw( 16 )
+              << "ns/op" << std::setw( 12 ) << "allocs/op" << std::setw( 10 ) << "iters";
+
+    if( !aBaseline.empty() )
+        std::cout << std::setw( 12 ) << "change";
+
+    std::cout << std::endl;
+
+    for( const auto& entry : aResults )
+    {
+        const BENCH_RESULT& res = entry.second;
+
+        std::cout << std::left << std::setw( 32 ) << entry.first << std::right << std::fixed
+                  << std::setprecision( 0 ) << std::setw( 16 ) << res.m_nsPerOp
+                  << std::setprecision( 1 ) << std::setw( 12 ) << res.m_allocsPerOp
+                  << std::setw( 10 ) << res.m_iterations;
+
+        auto base = aBaseline.find( entry.first );
+
+        if( base != aBaseline.end() && base->second.m_nsPerOp > 0.0 )
+        {
+            double change = 100.0 * ( res.m_nsPerOp / base->second.m_nsPerOp - 1.0 );
+
+            std::cout << std::showpos << std::setw( 11 ) << change << "%" << std::noshowpos;
+
+            if( change > aThreshold )
+            {
+                std::cout << "  REGRESSION";
+                regressions++;
+            }
+        }
+
+        std::cout << std::endl;
+    }
+
+    return regressions;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_OPTION, "o", "output", _( "save the results to this file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "b", "baseline", _( "compare against results saved in this file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "t", "threshold",
+            _( "slowdown (in percent) reported as a regression, default 10" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "f", "filter", _( "only run benchmarks whose name contains this" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "m", "min-time",
+            _( "minimum time (in ms) to run each benchmark for, default 200" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum GEOM_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    BASELINE_IO_FAILED,
+    REGRESSIONS_FOUND,
+};
+
+
+int geometry_benchmark_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program benchmarks geometry operations (collisions, "
+                               "inflation, fracturing, triangulation) on the zones and pads of a "
+                               "board, read from the given file or from stdin." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString filename, output, baselineFile, filter;
+    double   threshold = 10.0;
+    double   minTimeMs = 200.0;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 );
+
+    cl_parser.Found( "output", &output );
+    cl_parser.Found( "baseline", &baselineFile );
+    cl_parser.Found( "filter", &filter );
+    cl_parser.Found( "threshold", &threshold );
+    cl_parser.Found( "min-time", &minTimeMs );
+
+    BENCH_RESULTS baseline;
+
+    if( !baselineFile.IsEmpty() && !loadResults( baseline, baselineFile.ToStdString() ) )
+    {
+        std::cerr << "Could not read baseline " << baselineFile << std::endl;
+        return BASELINE_IO_FAILED;
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename.ToStdString() );
+
+    if( !board )
+        return LOAD_FAILED;
+
+    BENCH_DATA    data = extractBenchData( *board );
+    BENCH_RESULTS results = runBenchmarks( data, filter.ToStdString(), minTimeMs );
+
+    int regressions = reportResults( results, baseline, threshold );
+
+    if( !output.IsEmpty() && !saveResults( results, output.ToStdString() ) )
+    {
+        std::cerr << "Could not write results to " << output << std::endl;
+        return BASELINE_IO_FAILED;
+    }
+
+    return regressions ? REGRESSIONS_FOUND : KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "geometry_benchmark",
+        "Benchmark kimath geometry operations on the zones and pads of a PCB",
+        geometry_benchmark_main,
+} );
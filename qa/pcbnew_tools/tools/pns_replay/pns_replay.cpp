@@ -0,0 +1,496 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2021 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pns_replay.cpp
+ * Replay recorded routing sessions through the router, without any GUI, and report how long
+ * each router call took.
+ *
+ * The sessions are the event logs saved by the router tool (or by PNS::LOGGER::Save()), all
+ * recorded on the same board.  The tracks and vias left by each session are compared with the
+ * ones stored in "<log>.expected", so that a change can be checked for both its latency and
+ * its results:
+ *
+ *     qa_pcbnew_tools pns_replay -u board.kicad_pcb session1.log session2.log
+ *     (change things)
+ *     qa_pcbnew_tools pns_replay board.kicad_pcb session1.log session2.log
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <common.h>
+#include <profile.h>
+#include <drc/drc_engine.h>
+
+#include <router/pns_arc.h>
+#include <router/pns_debug_decorator.h>
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_node.h>
+#include <router/pns_router.h>
+#include <router/pns_routing_settings.h>
+#include <router/pns_segment.h>
+#include <router/pns_via.h>
+
+#include <wx/cmdline.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+
+
+/**
+ * A routing session, as saved by the router tool.
+ */
+struct REPLAY_TRACE
+{
+    struct EVENT
+    {
+        VECTOR2I                m_pos;
+        PNS::LOGGER::EVENT_TYPE m_type;
+        KIID                    m_uuid;
+        bool                    m_hasItem;
+    };
+
+    PNS::PNS_MODE      m_mode = PNS::RM_Shove;
+    bool               m_removeLoops = true;
+    bool               m_fixAllSegments = true;
+    std::vector<EVENT> m_events;
+};
+
+
+///< Router call durations (in microseconds), by event type.
+using LATENCIES = std::map<PNS::LOGGER::EVENT_TYPE, std::vector<double>>;
+
+
+static const char* eventName( PNS::LOGGER::EVENT_TYPE aType )
+{
+    switch( aType )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE: return "start-route";
+    case PNS::LOGGER::EVT_START_DRAG:  return "start-drag";
+    case PNS::LOGGER::EVT_FIX:         return "fix";
+    case PNS::LOGGER::EVT_MOVE:        return "move";
+    case PNS::LOGGER::EVT_ABORT:       return "abort";
+    default:                           return "unknown";
+    }
+}
+
+
+/**
+ * Read a session in the format written by ROUTER_TOOL::saveRouterDebugLog():
+ *
+ *     config <mode> <remove loops> <fix all segments>
+ *     event <x> <y> <type> <item uuid or "null">
+ */
+static bool loadTrace( const std::string& aFilename, REPLAY_TRACE& aTrace )
+{
+    std::ifstream in( aFilename );
+    std::string   line;
+
+    if( !in )
+        return false;
+
+    while( std::getline( in, line ) )
+    {
+        std::istringstream tokens( line );
+        std::string        cmd;
+
+        if( !( tokens >> cmd ) )
+            continue;
+
+        if( cmd == "event" )
+        {
+            REPLAY_TRACE::EVENT evt;
+            int                 type;
+            std::string         uuid;
+
+            if( !( tokens >> evt.m_pos.x >> evt.m_pos.y >> type >> uuid ) )
+                return false;
+
+            evt.m_type = static_cast<PNS::LOGGER::EVENT_TYPE>( type );
+            evt.m_hasItem = ( uuid != "null" );
+
+            if( evt.m_hasItem )
+                evt.m_uuid = KIID( uuid );
+
+            aTrace.m_events.push_back( evt );
+        }
+        else if( cmd == "config" )
+        {
+            int mode, removeLoops, fixAllSegments;
+
+            if( !( tokens >> mode >> removeLoops >> fixAllSegments ) )
+                return false;
+
+            aTrace.m_mode = static_cast<PNS::PNS_MODE>( mode );
+            aTrace.m_removeLoops = removeLoops != 0;
+            aTrace.m_fixAllSegments = fixAllSegments != 0;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Describe the tracks and vias of \a aWorld, one per line, in a stable order.
+ */
+static std::vector<std::string> dumpGeometry( PNS::NODE* aWorld, int aNetCount )
+{
+    std::vector<std::string> lines;
+
+    for( int net = 0; net < aNetCount; net++ )
+    {
+        std::set<PNS::ITEM*> items;
+
+        aWorld->AllItemsInNet( net, items,
+                               PNS::ITEM::SEGMENT_T | PNS::ITEM::ARC_T | PNS::ITEM::VIA_T );
+
+        for( const PNS::ITEM* item : items )
+        {
+            std::ostringstream desc;
+
+            desc << item->KindStr() << " " << net << " " << item->Layers().Start() << " "
+                 << item->Layers().End();
+
+            if( item->Kind() == PNS::ITEM::SEGMENT_T )
+            {
+                const PNS::SEGMENT* seg = static_cast<const PNS::SEGMENT*>( item );
+
+                desc << " " << seg->Seg().A.x << " " << seg->Seg().A.y << " " << seg->Seg().B.x
+                     << " " << seg->Seg().B.y << " " << seg->Width();
+            }
+            else if( item->Kind() == PNS::ITEM::ARC_T )
+            {
+                const PNS::ARC*  arc = static_cast<const PNS::ARC*>( item );
+                const SHAPE_ARC* shape = static_cast<const SHAPE_ARC*>( arc->Shape() );
+
+                desc << " " << shape->GetP0().x << " " << shape->GetP0().y << " "
+                     << shape->GetArcMid().x << " " << shape->GetArcMid().y << " "
+                     << shape->GetP1().x << " " << shape->GetP1().y << " " << arc->Width();
+            }
+            else
+            {
+                const PNS::VIA* via = static_cast<const PNS::VIA*>( item );
+
+                desc << " " << via->Pos().x << " " << via->Pos().y << " " << via->Diameter()
+                     << " " << via->Drill();
+            }
+
+            lines.push_back( desc.str() );
+        }
+    }
+
+    std::sort( lines.begin(), lines.end() );
+
+    return lines;
+}
+
+
+/**
+ * Replay \a aTrace on a fresh router working on \a aBoard.  The board itself is not modified,
+ * the results of the session only go to the router's world.
+ *
+ * @param aLatencies receives the duration of each router call.
+ * @return the tracks and vias at the end of the session.
+ */
+static std::vector<std::string> replayTrace( BOARD* aBoard, const REPLAY_TRACE& aTrace,
+                                             const std::map<KIID, BOARD_CONNECTED_ITEM*>& aItems,
+                                             LATENCIES& aLatencies )
+{
+    PNS_KICAD_IFACE_BASE  iface;
+    PNS::DEBUG_DECORATOR  decorator;
+    PNS::ROUTING_SETTINGS settings( nullptr, "" );
+    PNS::ROUTER           router;
+
+    settings.SetMode( aTrace.m_mode );
+    settings.SetRemoveLoops( aTrace.m_removeLoops );
+    settings.SetFixAllSegments( aTrace.m_fixAllSegments );
+    settings.SetOptimizeDraggedTrack( true );
+
+    iface.SetBoard( aBoard );
+    iface.SetDebugDecorator( &decorator );
+    router.SetInterface( &iface );
+    router.ClearWorld();
+    router.SetMode( PNS::PNS_MODE_ROUTE_SINGLE );
+    router.SyncWorld();
+    router.LoadSettings( &settings );
+
+    for( const REPLAY_TRACE::EVENT& evt : aTrace.m_events )
+    {
+        PNS::ITEM* item = nullptr;
+
+        if( evt.m_hasItem )
+        {
+            auto it = aItems.find( evt.m_uuid );
+
+            if( it != aItems.end() )
+                item = router.GetWorld()->FindItemByParent( it->second );
+        }
+
+        PROF_COUNTER timer;
+
+        switch( evt.m_type )
+        {
+        case PNS::LOGGER::EVT_START_ROUTE:
+            router.StartRouting( evt.m_pos, item, item ? item->Layers().Start() : F_Cu );
+            break;
+
+        case PNS::LOGGER::EVT_START_DRAG:
+            if( item )
+                router.StartDragging( evt.m_pos, item, PNS::DM_ANY );
+
+            break;
+
+        case PNS::LOGGER::EVT_FIX:
+            // As the router tool does, a fix which completes the route ends the session
+            if( router.FixRoute( evt.m_pos, item ) )
+                router.StopRouting();
+
+            break;
+
+        case PNS::LOGGER::EVT_MOVE:
+            router.Move( evt.m_pos, item );
+            break;
+
+        case PNS::LOGGER::EVT_ABORT:
+            router.StopRouting();
+            break;
+
+        default:
+            continue;
+        }
+
+        aLatencies[evt.m_type].push_back( timer.SinceStart<std::chrono::microseconds>().count() );
+    }
+
+    router.StopRouting();
+
+    return dumpGeometry( router.GetWorld(), aBoard->GetNetCount() );
+}
+
+
+/**
+ * Compare the geometry left by a session with the expected one.
+ *
+ * @return true if they match, or if there is no expected geometry to compare with.
+ */
+static bool checkGeometry( const std::vector<std::string>& aGeometry,
+                           const std::string& aExpectedFile )
+{
+    std::ifstream            in( aExpectedFile );
+    std::vector<std::string> expected;
+    std::string              line;
+
+    if( !in )
+    {
+        std::cout << "  no expected geometry (" << aExpectedFile << ")" << std::endl;
+        return true;
+    }
+
+    while( std::getline( in, line ) )
+    {
+        if( !line.empty() )
+            expected.push_back( line );
+    }
+
+    std::sort( expected.begin(), expected.end() );
+
+    std::vector<std::string> missing, unexpected;
+
+    std::set_difference( expected.begin(), expected.end(), aGeometry.begin(), aGeometry.end(),
+                         std::back_inserter( missing ) );
+    std::set_difference( aGeometry.begin(), aGeometry.end(), expected.begin(), expected.end(),
+                         std::back_inserter( unexpected ) );
+
+    for( const std::string& item : missing )
+        std::cout << "  - " << item << std::endl;
+
+    for( const std::string& item : unexpected )
+        std::cout << "  + " << item << std::endl;
+
+    return missing.empty() && unexpected.empty();
+}
+
+
+/**
+ * Return the \a aPercent percentile of sorted \a aValues, by the nearest-rank method.
+ */
+static double percentile( const std::vector<double>& aValues, double aPercent )
+{
+    if( aValues.empty() )
+        return 0.0;
+
+    size_t rank = std::ceil( aPercent / 100.0 * aValues.size() );
+
+    return aValues[ std::max<size_t>( rank, 1 ) - 1 ];
+}
+
+
+static void reportLatencies( LATENCIES& aLatencies )
+{
+    std::cout << std::left << std::setw( 14 ) << "event" << std::right << std::setw( 10 )
+              << "count" << std::setw( 12 ) << "p50 (us)" << std::setw( 12 ) << "p90 (us)"
+              << std::setw( 12 ) << "p99 (us)" << std::setw( 12 ) << "max (us)" << std::endl;
+
+    for( auto& entry : aLatencies )
+    {
+        std::vector<double>& values = entry.second;
+
+        std::sort( values.begin(), values.end() );
+
+        std::cout << std::left << std::setw( 14 ) << eventName( entry.first ) << std::right
+                  << std::fixed << std::setprecision( 0 ) << std::setw( 10 ) << values.size()
+                  << std::setw( 12 ) << percentile( values, 50 ) << std::setw( 12 )
+                  << percentile( values, 90 ) << std::setw( 12 ) << percentile( values, 99 )
+                  << std::setw( 12 ) << ( values.empty() ? 0.0 : values.back() ) << std::endl;
+    }
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "u", "update",
+            _( "save the resulting geometry as the expected one instead of checking it" ).mb_str() },
+    { wxCMD_LINE_OPTION, "n", "iterations",
+            _( "number of times each session is replayed, default 1" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "board file" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MANDATORY },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "router event logs" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum PNS_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    TRACE_LOAD_FAILED,
+    EXPECTED_IO_FAILED,
+    GEOMETRY_MISMATCH,
+};
+
+
+int pns_replay_main( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "This program replays router event logs on a board, without "
+                               "GUI, reports the latency of the router calls and checks the "
+                               "routed tracks against the expected ones." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long iterations = 1;
+    bool update = cl_parser.Found( "update" );
+
+    cl_parser.Found( "iterations", &iterations );
+
+    std::unique_ptr<BOARD> board =
+            KI_TEST::ReadBoardFromFileOrStream( cl_parser.GetParam( 0 ).ToStdString() );
+
+    if( !board )
+        return LOAD_FAILED;
+
+    // The router takes its clearances from the DRC engine
+    BOARD_DESIGN_SETTINGS& bds = board->GetDesignSettings();
+    bds.m_DRCEngine = std::make_shared<DRC_ENGINE>( board.get(), &bds );
+    bds.m_DRCEngine->InitEngine( wxFileName() );
+
+    std::map<KIID, BOARD_CONNECTED_ITEM*> items;
+
+    for( BOARD_CONNECTED_ITEM* item : board->AllConnectedItems() )
+        items[item->m_Uuid] = item;
+
+    LATENCIES latencies;
+    int       mismatches = 0;
+
+    for( size_t ii = 1; ii < cl_parser.GetParamCount(); ii++ )
+    {
+        std::string  traceFile = cl_parser.GetParam( ii ).ToStdString();
+        std::string  expectedFile = traceFile + ".expected";
+        REPLAY_TRACE trace;
+
+        if( !loadTrace( traceFile, trace ) )
+        {
+            std::cerr << "Could not read " << traceFile << std::endl;
+            return TRACE_LOAD_FAILED;
+        }
+
+        std::cout << traceFile << ": " << trace.m_events.size() << " events" << std::endl;
+
+        std::vector<std::string> geometry;
+
+        for( long jj = 0; jj < iterations; jj++ )
+            geometry = replayTrace( board.get(), trace, items, latencies );
+
+        if( update )
+        {
+            std::ofstream out( expectedFile );
+
+            for( const std::string& line : geometry )
+                out << line << "\n";
+
+            if( !out )
+            {
+                std::cerr << "Could not write " << expectedFile << std::endl;
+                return EXPECTED_IO_FAILED;
+            }
+        }
+        else if( !checkGeometry( geometry, expectedFile ) )
+        {
+            std::cout << "  GEOMETRY MISMATCH" << std::endl;
+            mismatches++;
+        }
+    }
+
+    reportLatencies( latencies );
+
+    return mismatches ? GEOMETRY_MISMATCH : KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "pns_replay",
+        "Replay router event logs headlessly and report the router latency",
+        pns_replay_main,
+} );
@@ -370,6 +370,12 @@ void PNS_TEST_DEBUG_DECORATOR::Clear()
     //dec_dbg("clear");
 }
 
+void PNS_TEST_DEBUG_DECORATOR::ReportPhaseTimes( const PNS::PHASE_PROFILE& aProfile )
+{
+    Message( aProfile.Format() );
+}
+
+
 void PNS_TEST_DEBUG_DECORATOR::NewStage(const std::string& name, int iter)
 {
     m_stages.push_back( new STAGE );
@@ -220,6 +220,8 @@ public:
     virtual void AddDirections( VECTOR2D aP, int aMask, int aColor,
                                 const std::string aName = "" ) override;
     virtual void Clear() override;
+    virtual bool IsRecording() const override { return true; }
+    virtual void ReportPhaseTimes( const PNS::PHASE_PROFILE& aProfile ) override;
     virtual void NewStage( const std::string& name, int iter ) override;
 
     virtual void BeginGroup( const std::string name ) override;